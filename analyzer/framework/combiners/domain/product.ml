@@ -464,6 +464,13 @@ struct
     Cases.map_result (fun _ -> ()) pointwise
 
 
+  (** Variables touched by a post-condition, or [None] if unknown *)
+  let get_touched_vars stmt effects =
+    OptionExt.lift2 VarSet.union
+      (get_stmt_touched_vars stmt)
+      (get_teffect_touched_vars effects)
+
+
   (** Apply reduction rules on a post-conditions *)
   let reduce_post stmt man pre post =
     let rman = exec_reduction_man man in
@@ -473,12 +480,26 @@ struct
     | Empty -> Cases.empty flow
     | NotHandled -> Cases.not_handled flow
     | Result((),effects,_) ->
+      (* Variables touched by the post-condition are computed only when a
+         rule has a trigger *)
+      let touched = lazy (get_touched_vars stmt effects) in
+      let is_triggered = function
+        | None -> true
+        | Some f ->
+          match Lazy.force touched with
+          | None -> true
+          | Some vars -> VarSet.exists f vars
+      in
       (* Iterate over rules *)
       let rec iter = function
         | [] -> Post.return flow
         | rule::tl ->
           let module R = (val rule : EXEC_REDUCTION) in
-          match R.reduce stmt man rman pre flow effects with
+          if not (is_triggered R.trigger) then
+            let () = Sig.Reduction.Profiler.skip R.name in
+            iter tl
+          else
+          match Sig.Reduction.Profiler.fire R.name (fun () -> R.reduce stmt man rman pre flow effects) with
           | None -> iter tl
           | Some post -> post
       in
@@ -528,7 +549,16 @@ struct
 
         | rule::tl ->
           let module R = (val rule : EVAL_REDUCTION) in
-          match R.reduce exp man rman input el' flow with
+          (* Fire the rule only if one of the evaluations is accepted by its trigger *)
+          let triggered = match R.trigger with
+            | None -> true
+            | Some f -> List.exists f el'
+          in
+          if not triggered then
+            let () = Sig.Reduction.Profiler.skip R.name in
+            iter tl
+          else
+          match Sig.Reduction.Profiler.fire R.name (fun () -> R.reduce exp man rman input el' flow) with
           | None -> iter tl
           | Some evl -> evl
       in
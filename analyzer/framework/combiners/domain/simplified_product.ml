@@ -241,7 +241,19 @@ struct
     get_value = (fun (type v) (idx:v id) var a ->
         let open Value.Nonrel in
         let open Bot_top in
-        let open Lattices.Partial_map in
+        (* Iterate over combiners to find the required id *)
+        let rec iter : type w. w id -> w -> v =
+          fun id' v' ->
+            (* Check if id' corresponds to what we are searching for *)
+            match equal_id id' idx with
+            | Some Eq -> v'
+            | None ->
+              (* Otherwise, search in the arguments of the combiner *)
+              match id', v' with
+              | V_pair(id1,id2), (v1,v2) ->
+                begin try iter id1 v1 with Not_found -> iter id2 v2 end
+              | _ -> raise Not_found
+        in
         let rec aux : type a. a id -> a -> v =
           fun idy aa ->
             match idy, aa with
@@ -254,21 +266,16 @@ struct
               let v = match aa with
                 | TOP -> V.top
                 | BOT -> V.bottom
-                | Nbt map -> PMap.find var map
+                | Nbt map -> Lattices.Partial_map.PMap.find var map
               in
+              iter V.id v
 
-              (* Iterate over combiners to find the required id *)
-              let rec iter : type w. w id -> w -> v =
-                fun id' v' ->
-                  (* Check if id' corresponds to what we are searching for *)
-                  match equal_id id' idx with
-                  | Some Eq -> v'
-                  | None ->
-                    (* Otherwise, search in the arguments of the combiner *)
-                    match id', v' with
-                    | V_pair(id1,id2), (v1,v2) ->
-                      begin try iter id1 v1 with Not_found -> iter id2 v2 end
-                    | _ -> raise Not_found
+            | D_nonrel_patricia vmodule, aa ->
+              let module V = (val vmodule) in
+              let v = match aa with
+                | TOP -> V.top
+                | BOT -> V.bottom
+                | Nbt map -> Lattices.Partial_patricia_map.PMap.find (var_uid var) map
               in
               iter V.id v
 
@@ -286,13 +293,26 @@ struct
     set_value = (fun (type v) (idx:v id) var (v:v) a ->
         let open Value.Nonrel in
         let open Bot_top in
-        let open Lattices.Partial_map in
+        (* Iterate over the structure of a value to put [v] in the right place *)
+        let rec iter: type w. w id -> w -> w =
+          fun id' v'->
+            (* Check if id' corresponds to what we are searching for *)
+            match equal_id id' idx with
+            | Some Eq -> v
+            | None ->
+              (* Otherwise, search in the operands of value combiners *)
+              match id',v' with
+              | V_pair(id1,id2), (v1,v2) ->
+                begin try iter id1 v1,v2 with Not_found -> v1,iter id2 v2 end
+              | _ -> raise Not_found
+        in
         let rec aux : type a. a id -> a -> a =
           fun idy aa ->
             match idy, aa with
             (* The value is set in non-relational environments *)
             | D_nonrel vmodule, aa ->
               let module V = (val vmodule) in
+              let module PMap = Lattices.Partial_map.PMap in
               (* Get the old value of the variable. The given
                  value [v] will be put *inside* it (in case of composed values). *)
               let old = match aa with
@@ -300,26 +320,29 @@ struct
                 | BOT -> V.bottom
                 | Nbt map -> PMap.find var map
               in
+              let update = iter V.id old in
+              if V.is_bottom update then BOT
+              else begin match aa with
+                | TOP -> TOP
+                | BOT -> BOT
+                | Nbt map -> Nbt (PMap.add var update map)
+              end
 
-              (* Iterate over the structure of [old] to put [v] in the right place *)
-              let rec iter: type w. w id -> w -> w =
-                fun id' v'->
-                  (* Check if id' corresponds to what we are searching for *)
-                  match equal_id id' idx with
-                  | Some Eq -> v
-                  | None ->
-                    (* Otherwise, search in the operands of value combiners *)
-                    match id',v' with
-                    | V_pair(id1,id2), (v1,v2) ->
-                      begin try iter id1 v1,v2 with Not_found -> v1,iter id2 v2 end
-                    | _ -> raise Not_found
+            | D_nonrel_patricia vmodule, aa ->
+              let module V = (val vmodule) in
+              let module PMap = Lattices.Partial_patricia_map.PMap in
+              let uid = var_uid var in
+              let old = match aa with
+                | TOP -> V.top
+                | BOT -> V.bottom
+                | Nbt map -> PMap.find uid map
               in
               let update = iter V.id old in
               if V.is_bottom update then BOT
               else begin match aa with
                 | TOP -> TOP
                 | BOT -> BOT
-                | Nbt map -> Nbt (PMap.add var update map)
+                | Nbt map -> Nbt (PMap.add uid update map)
               end
 
             | C_pair(_,hd,tl), (ahd,atl) ->
@@ -336,11 +359,26 @@ struct
     ask = (fun q ctx a -> match D.ask None q man ctx a with None -> raise Not_found | Some r -> r);
   }
 
+  (** Check whether a rule with trigger [trigger] should be fired after
+      statement [stmt]. Simplified domains execute [stmt] directly, without
+      delegating sub-statements, so the variables touched by [stmt] are all
+      the variables that may have changed. *)
+  let is_triggered trigger touched =
+    match trigger, Lazy.force touched with
+    | None, _ | _, None -> true
+    | Some f, Some vars -> VarSet.exists f vars
+
   let reduce stmt man ctx pre post =
     let rman = reduction_man man in
+    let touched = lazy (get_stmt_touched_vars stmt) in
     List.fold_left (fun acc rule ->
         let module Rule = (val rule : SIMPLIFIED_REDUCTION) in
-        Rule.reduce stmt rman ctx pre acc
+        if not (is_triggered Rule.trigger touched) then
+          let () = Sig.Reduction.Profiler.skip Rule.name in
+          acc
+        else
+          Sig.Reduction.Profiler.fire Rule.name @@ fun () ->
+          Rule.reduce stmt rman ctx pre acc
       ) post R.rules
 
   let exec targets =
@@ -33,6 +33,8 @@ open Mopsa_utils
 
 type _ id += D_nonrel : (module VALUE with type t = 'v) -> (var,'v) Lattices.Partial_map.map id
 
+type _ id += D_nonrel_patricia : (module VALUE with type t = 'v) -> 'v Lattices.Partial_patricia_map.map id
+
 let () =
   let open Eq in
   register_id {
@@ -47,6 +49,14 @@ let () =
             | Some Eq -> Some Eq
             | None -> None
           end
+        | D_nonrel_patricia v1, D_nonrel_patricia v2 ->
+          begin
+            let module V1 = (val v1) in
+            let module V2 = (val v2) in
+            match equal_id V1.id V2.id with
+            | Some Eq -> Some Eq
+            | None -> None
+          end
         | _ -> next.eq id1 id2
       in
       f
@@ -145,12 +155,39 @@ let find_var_bounds_ctx_opt v ctx =
   find_var_ctx_opt v var_bounds_ctx ctx
 
 
+(** {2 Environments} *)
+(** ****************** *)
+
+(** Representation of the partial environments of the domain. *)
+module type ENV =
+sig
+  type t
+  type value
+  val id : t id
+  val bottom : t
+  val top : t
+  val is_bottom : t -> bool
+  val empty : t
+  val subset : t -> t -> bool
+  val join : t -> t -> t
+  val meet : t -> t -> t
+  val print : printer -> t -> unit
+  val find : var -> t -> value
+  val add : var -> value -> t -> t
+  val remove : var -> t -> t
+  val mem : var -> t -> bool
+  val map2zo :
+    (var -> value -> value) ->
+    (var -> value -> value) ->
+    (var -> value -> value -> value) ->
+    t -> t -> t
+end
+
+
 (** {2 Non-relational domain} *)
 (** ************************* *)
 
-module Make(Value: VALUE) :
-  Sig.Abstraction.Simplified.SIMPLIFIED
-  with type t = (var,Value.t) Lattices.Partial_map.map =
+module MakeWithEnv(Value: VALUE)(Env: ENV with type value = Value.t) =
 struct
 
 
@@ -158,15 +195,10 @@ struct
   (** ***************** *)
 
   (** Map with variables as keys. *)
-  module VarMap =
-    Lattices.Partial_map.Make
-      (Var)
-      (Value)
+  module VarMap = Env
 
   include VarMap
 
-  let id = D_nonrel (module Value)
-
   let name = "framework.abstraction.combiners.value.nonrel"
 
   let debug fmt = Debug.debug ~channel:name fmt
@@ -213,31 +245,23 @@ struct
       Value.meet v vv
 
   let widen ctx a1 a2 =
-    let open Bot_top in
-    if a1 == a2 then a1 else
-      match a1, a2 with
-      | BOT, x | x, BOT -> x
-      | TOP, x | x, TOP -> TOP
-      | Nbt m1, Nbt m2 ->
-        Nbt (
-          MapExtPoly.map2zo
-            (fun _ v1 -> v1)
-            (fun _ v2 -> v2)
-            (fun var v1 v2 ->
-               let vctx =
-                 match find_ctx_opt var_ctx_key ctx with
-                 | None   -> empty_ctx
-                 | Some map ->
-                   match Core.Ast.Var.VarMap.find_opt var map with
-                   | None   -> empty_ctx
-                   | Some c -> c
-               in
-               let w = Value.widen vctx v1 v2 in
-               (* Apply the bounds constraints*)
-               meet_with_bound_constraints ctx var w
-            )
-            m1 m2
-        )
+    VarMap.map2zo
+      (fun _ v1 -> v1)
+      (fun _ v2 -> v2)
+      (fun var v1 v2 ->
+         let vctx =
+           match find_ctx_opt var_ctx_key ctx with
+           | None   -> empty_ctx
+           | Some map ->
+             match Core.Ast.Var.VarMap.find_opt var map with
+             | None   -> empty_ctx
+             | Some c -> c
+         in
+         let w = Value.widen vctx v1 v2 in
+         (* Apply the bounds constraints*)
+         meet_with_bound_constraints ctx var w
+      )
+      a1 a2
 
   let top_of_typ typ range =
     Value.eval imprecise_value_man (mk_top typ range)
@@ -509,3 +533,29 @@ struct
                 fkey "%a" pp_expr exp ]
         (pbox Value.print v)
 end
+
+
+(** Environments as balanced maps ordered by [compare_var] *)
+module Make(Value: VALUE) =
+struct
+  module Env =
+  struct
+    include Lattices.Partial_map.Make(Var)(Value)
+    type value = Value.t
+    let id = D_nonrel (module Value)
+  end
+  include MakeWithEnv(Value)(Env)
+end
+
+
+(** Environments as Patricia trees indexed by interned variables *)
+module MakePatricia(Value: VALUE) =
+struct
+  module Env =
+  struct
+    include Lattices.Partial_patricia_map.Make(Var)(Value)
+    type value = Value.t
+    let id = D_nonrel_patricia (module Value)
+  end
+  include MakeWithEnv(Value)(Env)
+end
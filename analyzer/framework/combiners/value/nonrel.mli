@@ -42,6 +42,12 @@ type _ id +=
       (module VALUE with type t = 'v) ->
       (var,'v) Lattices.Partial_map.map id
 
+(** Identifier of a non-relational domain with Patricia-tree environments *)
+type _ id +=
+  | D_nonrel_patricia :
+      (module VALUE with type t = 'v) ->
+      'v Lattices.Partial_patricia_map.map id
+
 
 (** {2 Variable's context} *)
 (** ********************** *)
@@ -103,3 +109,11 @@ val find_var_bounds_ctx_opt : var -> 'a ctx -> constant option
 module Make(Value: VALUE) :
   Sig.Abstraction.Simplified.SIMPLIFIED
   with type t = (var,Value.t) Lattices.Partial_map.map
+
+(** Create a non-relational domain from a value abstraction, with
+    environments represented as Patricia trees over interned variables.
+    Joins and inclusion tests of environments sharing most of their
+    bindings are faster and consume less memory. *)
+module MakePatricia(Value: VALUE) :
+  Sig.Abstraction.Simplified.SIMPLIFIED
+  with type t = Value.t Lattices.Partial_patricia_map.map
@@ -163,18 +163,32 @@ struct
       )
   }
 
+  let rules = Array.of_list R.rules
+
+  (* Rules are applied in turn until none of them changes the value. A rule
+     is fired again only when the value has changed since its last
+     application, i.e. when another rule refined it. *)
   let reduce (v:t) : t =
-    let apply v =
-      List.fold_left (fun acc r ->
-          let module Reduction = (val r : VALUE_REDUCTION) in
-          Reduction.reduce rman acc
-        ) v R.rules
-    in
-    let rec lfp v =
-      let v' = apply v in
-      if subset v v' then v else lfp v'
+    let n = Array.length rules in
+    (* Result of the last application of each rule *)
+    let last = Array.make n None in
+    (* [stable] is the number of consecutive rules that left [v] unchanged *)
+    let rec iter v i stable =
+      if stable >= n then v
+      else
+        let module Reduction = (val rules.(i) : VALUE_REDUCTION) in
+        let next = (i + 1) mod n in
+        match last.(i) with
+        | Some v' when subset v' v ->
+          Sig.Reduction.Profiler.skip Reduction.name;
+          iter v next (stable + 1)
+        | _ ->
+          let v' = Sig.Reduction.Profiler.fire Reduction.name (fun () -> Reduction.reduce rman v) in
+          last.(i) <- Some v';
+          if subset v v' then iter v next (stable + 1)
+          else iter v' next 1
     in
-    lfp v
+    iter v 0 0
 
   let reduce_man (man:('v,t) value_man) a =
     man.set (reduce (man.get a)) a
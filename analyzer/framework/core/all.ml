@@ -88,6 +88,8 @@ include Manager
 
 module Hook = Hook
 
+module Budget = Budget
+
 include Print
 module Print = Print
 
@@ -100,4 +102,6 @@ struct
   type t = var
   let compare = compare_var
   let print prt v = pp_variable prt v
+  let to_int = var_uid
+  let of_int = var_of_uid
 end
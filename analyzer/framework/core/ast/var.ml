@@ -234,3 +234,41 @@ let () =
 
 module VarSet = SetExt.Make(struct type t = var let compare = compare_var end)
 module VarMap = MapExt.Make(struct type t = var let compare = compare_var end)
+
+
+(*========================================================================*)
+(**                      {2 Interning of variables}                       *)
+(*========================================================================*)
+
+(* Variables are interned lazily: the first time a variable is requested,
+   it gets the next available integer identifier. Since [compare_var]
+   ignores some fields (e.g. the name of [V_uniq] variables), the table
+   from variables to identifiers is keyed by [compare_var] and not by a
+   structural hash. Variable records are left untouched, so that copies of
+   a record never carry a stale identifier. *)
+
+let var_uids : int VarMap.t ref = ref VarMap.empty
+
+(* Interned variables, indexed by identifier *)
+let uid_vars : var array ref = ref [||]
+
+let var_uid_counter = ref 0
+
+let var_uid (v:var) : int =
+  match VarMap.find_opt v !var_uids with
+  | Some uid -> uid
+  | None ->
+    let uid = !var_uid_counter in
+    incr var_uid_counter;
+    var_uids := VarMap.add v uid !var_uids;
+    if uid >= Array.length !uid_vars then begin
+      let a = Array.make (max 1024 (2 * uid)) v in
+      Array.blit !uid_vars 0 a 0 uid;
+      uid_vars := a
+    end;
+    !uid_vars.(uid) <- v;
+    uid
+
+let var_of_uid (uid:int) : var =
+  if uid < 0 || uid >= !var_uid_counter then raise Not_found
+  else !uid_vars.(uid)
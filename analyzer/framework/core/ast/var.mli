@@ -184,6 +184,21 @@ module VarMap : MapExtSig.S with type key = var
 (** Maps of variables *)
 
 
+(****************************************************************************)
+(**                       {1 Interning of variables}                        *)
+(****************************************************************************)
+
+val var_uid : var -> int
+(** [var_uid v] returns a non-negative integer identifying [v]. Two
+    variables get the same identifier iff they are equal w.r.t.
+    [compare_var]. Identifiers are allocated on demand and are stable
+    during the whole analysis. *)
+
+val var_of_uid : int -> var
+(** [var_of_uid uid] returns the variable interned with identifier [uid].
+    Raises [Not_found] if no variable has this identifier. *)
+
+
 (****************************************************************************)
 (**                            {1 Deprecated}                               *)
 (****************************************************************************)
@@ -192,3 +207,4 @@ val start_vcounter_at : int -> unit
 val get_vcounter_val : unit -> int
 val get_orig_vname : var -> string
 val set_orig_vname : string -> var -> var
+
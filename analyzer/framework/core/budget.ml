@@ -0,0 +1,154 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Analysis budgets of entry functions *)
+
+open Alarm
+open Mopsa_utils
+
+
+(** {2 Options} *)
+(** *********** *)
+
+(** Wall-clock budget of an entry function, in seconds (0 for no limit) *)
+let opt_time = ref 0
+
+(** Budget of fixpoint iterations of an entry function (0 for no limit) *)
+let opt_iterations = ref 0
+
+(** Budget of major heap growth of an entry function, in megabytes (0 for
+    no limit) *)
+let opt_heap = ref 0
+
+let is_enabled () =
+  !opt_time > 0 || !opt_iterations > 0 || !opt_heap > 0
+
+
+(** {2 Budget accounting} *)
+(** ********************* *)
+
+type resource =
+  | R_time
+  | R_iterations
+  | R_heap
+
+let pp_resource fmt = function
+  | R_time -> Format.fprintf fmt "time budget of %ds" !opt_time
+  | R_iterations -> Format.fprintf fmt "budget of %d iterations" !opt_iterations
+  | R_heap -> Format.fprintf fmt "heap budget of %dMB" !opt_heap
+
+exception Exhausted of resource
+
+type budget = {
+  start_time: float;
+  start_heap: int;
+  mutable iterations: int;
+}
+
+(** Budget of the entry function being analyzed *)
+let current : budget option ref = ref None
+
+let heap_bytes () =
+  (Gc.quick_stat ()).Gc.heap_words * (Sys.word_size / 8)
+
+let tick () =
+  (* Workers of a pool abandon their task when their heap is exceeded *)
+  WorkerPool.check_heap ();
+  match !current with
+  | None -> ()
+  | Some b ->
+    b.iterations <- b.iterations + 1;
+    if !opt_iterations > 0 && b.iterations > !opt_iterations then
+      raise (Exhausted R_iterations);
+    if !opt_time > 0 && Unix.gettimeofday () -. b.start_time > float_of_int !opt_time then
+      raise (Exhausted R_time);
+    if !opt_heap > 0 && heap_bytes () - b.start_heap > !opt_heap * 1024 * 1024 then
+      raise (Exhausted R_heap)
+
+let run f =
+  if not (is_enabled ()) then Ok (f ())
+  else
+    let old = !current in
+    current := Some {
+        start_time = Unix.gettimeofday ();
+        start_heap = heap_bytes ();
+        iterations = 0;
+      };
+    match f () with
+    | r -> current := old; Ok r
+    | exception (Exhausted r) -> current := old; Error r
+    | exception e -> current := old; raise e
+
+
+(** {2 Diagnostics} *)
+(** *************** *)
+
+type check += CHK_BUDGET
+
+type alarm_kind += A_budget_exhausted of string * resource
+
+type assumption_kind += A_budget_abandoned_function of string
+
+let () =
+  register_check (fun next fmt -> function
+      | CHK_BUDGET -> Format.fprintf fmt "Analysis budget"
+      | a -> next fmt a
+    );
+  register_alarm {
+    check = (fun next -> function
+        | A_budget_exhausted _ -> CHK_BUDGET
+        | a -> next a
+      );
+    compare = (fun next a1 a2 ->
+        match a1, a2 with
+        | A_budget_exhausted (f1,r1), A_budget_exhausted (f2,r2) ->
+          Compare.pair String.compare compare (f1,r1) (f2,r2)
+        | _ -> next a1 a2
+      );
+    print = (fun next fmt -> function
+        | A_budget_exhausted (f,r) ->
+          Format.fprintf fmt "Analysis of '%a' abandoned: %a exhausted"
+            (Debug.bold Format.pp_print_string) f
+            pp_resource r
+        | a -> next fmt a
+      );
+    join = (fun next a1 a2 -> next a1 a2);
+  };
+  register_assumption {
+    print = (fun next fmt -> function
+        | A_budget_abandoned_function f ->
+          Format.fprintf fmt "ignoring the behaviors of '%a' after exhaustion of its analysis budget"
+            (Debug.bold Format.pp_print_string) f
+        | a -> next fmt a
+      );
+    compare = (fun next a1 a2 ->
+        match a1, a2 with
+        | A_budget_abandoned_function f1, A_budget_abandoned_function f2 ->
+          String.compare f1 f2
+        | _ -> next a1 a2
+      );
+  }
+
+let abandon fname resource range flow =
+  let cs = Flow.get_callstack flow in
+  let alarm = mk_alarm (A_budget_exhausted (fname, resource)) cs range in
+  Flow.add_diagnostic (mk_unimplemented_diagnostic alarm) flow |>
+  Flow.add_local_assumption (A_budget_abandoned_function fname) range
@@ -0,0 +1,87 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Analysis budgets of entry functions.
+
+    Entry functions (unit tests, runtime tests, ...) can be analyzed under a
+    budget of wall-clock time, fixpoint iterations and major heap growth.
+    Iterators performing long computations call [tick], which raises
+    [Exhausted] when the budget of the current entry function is spent. The
+    driver of the entry function catches it with [run] and abandons the
+    function with [abandon], so that the rest of the analysis proceeds.
+*)
+
+open Mopsa_utils
+
+
+(** {2 Options} *)
+(** *********** *)
+
+val opt_time : int ref
+(** Wall-clock budget of an entry function, in seconds (0 for no limit) *)
+
+val opt_iterations : int ref
+(** Budget of fixpoint iterations of an entry function (0 for no limit) *)
+
+val opt_heap : int ref
+(** Budget of major heap growth of an entry function, in megabytes (0 for
+    no limit) *)
+
+val is_enabled : unit -> bool
+(** Check whether some budget is set *)
+
+
+(** {2 Budget accounting} *)
+(** ********************* *)
+
+type resource =
+  | R_time
+  | R_iterations
+  | R_heap
+
+val pp_resource : Format.formatter -> resource -> unit
+
+exception Exhausted of resource
+
+val tick : unit -> unit
+(** Account for one fixpoint iteration of the current entry function.
+    @raise Exhausted when one of its budgets is spent
+    @raise WorkerPool.Heap_exceeded in a worker process exceeding its heap
+    budget *)
+
+val run : (unit -> 'a) -> ('a, resource) result
+(** [run f] analyzes an entry function [f] under a fresh budget. Budgets
+    of nested calls are independent. *)
+
+
+(** {2 Diagnostics} *)
+(** *************** *)
+
+type Alarm.check += CHK_BUDGET
+
+type Alarm.alarm_kind += A_budget_exhausted of string * resource
+
+type Alarm.assumption_kind += A_budget_abandoned_function of string
+
+val abandon : string -> resource -> Location.range -> 'a Flow.flow -> 'a Flow.flow
+(** [abandon f r range flow] adds to [flow] an unimplemented diagnostic
+    and a soundness assumption stating that the analysis of [f] was
+    abandoned after exhaustion of resource [r] *)
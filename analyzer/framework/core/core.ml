@@ -17,5 +17,6 @@ module Id = Id
 module Manager = Manager
 module Hook = Hook
 module Cache = Cache
+module Budget = Budget
 module Utils = Utils
 module All = All
@@ -244,6 +244,48 @@ let rec fold_stmt_teffect f acc = function
     let acc'' = fold_stmt_teffect f acc' l in
     fold_stmt_teffect f acc'' r
 
+(** {2 Touched variables} *)
+(** ********************* *)
+
+(** Get the variables touched by a statement, i.e. variables that may
+    have changed or whose value may have been refined. Returns [None] if
+    the statement is not supported. *)
+let get_stmt_touched_vars stmt : VarSet.t option =
+  let vars_of_list el =
+    if List.for_all (function {ekind = E_var _} -> true | _ -> false) el
+    then Some (VarSet.of_list (List.map (function {ekind = E_var(v,_)} -> v | _ -> assert false) el))
+    else None
+  in
+  match skind stmt with
+  | S_add { ekind = E_var (var, _) }
+  | S_remove { ekind = E_var (var, _) }
+  | S_assign ({ ekind = E_var (var, _) },_)
+  | S_forget { ekind = E_var (var, _) } ->
+    Some (VarSet.singleton var)
+
+  | S_assume e ->
+    Some (VarSet.of_list (Ast.Visitor.expr_vars e))
+
+  | S_rename ( {ekind = E_var (var1, _)}, {ekind = E_var (var2, _)} ) ->
+    Some (VarSet.of_list [var1; var2])
+
+  | S_expand({ekind = E_var(var,_)}, vl)
+  | S_fold({ekind = E_var(var,_)}, vl) ->
+    vars_of_list vl |>
+    OptionExt.lift (VarSet.add var)
+
+  | _ -> None
+
+(** Get the variables touched by the statements of an effects tree *)
+let get_teffect_touched_vars teffect : VarSet.t option =
+  fold_stmt_teffect
+    (fun acc stmt ->
+       OptionExt.bind
+         (fun vars -> get_stmt_touched_vars stmt |> OptionExt.lift (VarSet.union vars))
+         acc
+    ) (Some VarSet.empty) teffect
+
+
 (** {2 Generic merge} *)
 (** ***************** *)
 
@@ -144,6 +144,17 @@ val join_teffect : teffect -> teffect -> teffect
 val fold_stmt_teffect : ('a -> stmt -> 'a) -> 'a -> teffect -> 'a
 (** Fold over the statements in the effects tree *)
 
+(** {1 Touched variables} *)
+
+val get_stmt_touched_vars : stmt -> VarSet.t option
+(** Get the variables touched by a statement, i.e. variables that may have
+    changed or whose value may have been refined. Returns [None] if the
+    statement is not supported. *)
+
+val get_teffect_touched_vars : teffect -> VarSet.t option
+(** Get the variables touched by the statements of an effects tree.
+    Returns [None] if some statement is not supported. *)
+
 (** {1 Generic merge} *)
 
 (** Effect of a statement in terms of modified and removed variables *)
@@ -306,16 +306,31 @@ struct
     let a = remove k a in
     set k' v a
 
-  (** Rename value [v] to [v'] *)
+  (** Rename value [v] to [v']. Only the keys bound to [v] in the inverse
+      index are visited: keys mapped to ⊤ are left unchanged. *)
   let rename_inverse (v: Value.t) (v': Value.t) (a:t) : t =
-    let ks = find_inverse v a in
-    let a = remove_inverse v a in
-    match ks with
-    | TOP ->
-       assert(a = TOP);
-       TOP
-    | Nt ks ->
-       add_inverse v' ks a
+    match a with
+    | BOT -> BOT
+    | TOP -> TOP
+    | Nbt m ->
+      let ks = Relation.inverse v m.relations in
+      if KeySet.is_empty ks then a
+      else
+        let relations = Relation.remove_inverse v m.relations |>
+                        Relation.add_inverse_set v' ks
+        in
+        Nbt { m with relations }
+
+  (** [copy_inverse v v' a] binds [v'] to every key bound to [v], using the
+      inverse index. Keys mapped to ⊤ are left unchanged. *)
+  let copy_inverse (v: Value.t) (v': Value.t) (a:t) : t =
+    match a with
+    | BOT -> BOT
+    | TOP -> TOP
+    | Nbt m ->
+      let ks = Relation.inverse v m.relations in
+      if KeySet.is_empty ks then a
+      else Nbt { m with relations = Relation.add_inverse_set v' ks m.relations }
 
   (** Create a map with singleton binding [(k,{v})] *)
   let singleton (k:Key.t) (v:Value.t) : t =
@@ -109,6 +109,9 @@ sig
   val rename_inverse : value -> value -> t -> t
   (** [rename k k' a] renames value [v] to [v'] in [a] *)
 
+  val copy_inverse : value -> value -> t -> t
+  (** [copy_inverse v v' a] binds [v'] to the keys bound to [v] in [a] *)
+
   val singleton :key -> value -> t
   (** [singleton k v] createw a map with the singleton binding [(k,{v})] *)
 
@@ -168,9 +168,21 @@ let render_env (var,value)  =
   ]
 
 
+(** Additional sections of the report, registered by other components,
+    such as front-ends. A section is omitted when its function returns
+    [None]. *)
+let sections : (string * (unit -> Yojson.Basic.t option)) list ref = ref []
+
+let register_section (name:string) (f:unit -> Yojson.Basic.t option) =
+  sections := !sections @ [name, f]
+
+let render_sections () =
+  List.filter_map (fun (name, f) -> Option.map (fun json -> name, json) (f ())) !sections
+
+
 let report man flow ~time ~files ~out : unit =
   let rep = Flow.get_report flow in
-  let json  = `Assoc [
+  let json  = `Assoc ([
       "success", `Bool true;
       "time", `Float time;
       "mopsa_version", `String Version.version;
@@ -178,7 +190,7 @@ let report man flow ~time ~files ~out : unit =
       "files", `List (List.map (fun f -> `String f) files);
       "checks", `List (render_alarms rep);
       "assumptions", `List (AssumptionSet.elements rep.report_assumptions |> List.map render_soudness_assumtion );
-    ]
+    ] @ render_sections ())
   in
   print out json
 
@@ -208,6 +220,7 @@ let panic exn ~btrace ~time ~files ~out =
     @ (match cs with
         | None -> []
         | Some c -> [ "callstack", render_callstack c ] )
+    @ render_sections ()
   in
   print out (`Assoc assoc)
 
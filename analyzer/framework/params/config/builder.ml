@@ -50,9 +50,11 @@ let rec make_value (value:value) : (module VALUE) =
 (** {2 Simplified domains} *)
 (** ********************** *)
 
-let make_nonrel_domain (value:value) : (module SIMPLIFIED_COMBINER) =
+let make_nonrel_domain (value:value) (env:nonrel_env) : (module SIMPLIFIED_COMBINER) =
   let module V = (val (make_value value)) in
-  (module SimplifiedToCombiner(Combiners.Value.Nonrel.Make(V)))
+  match env with
+  | NE_map      -> (module SimplifiedToCombiner(Combiners.Value.Nonrel.Make(V)))
+  | NE_patricia -> (module SimplifiedToCombiner(Combiners.Value.Nonrel.MakePatricia(V)))
 
 let rec is_simplified_domain d =
   match d.domain_kind with
@@ -72,7 +74,7 @@ let rec make_simplified_product (domains:domain list) (reductions:domain_reducti
 and make_simplified_domain_without_semantic (domain:domain) : (module SIMPLIFIED_COMBINER) =
   match domain.domain_kind with
   | D_simplified d                -> (module SimplifiedToCombiner(val d))
-  | D_nonrel value                -> make_nonrel_domain value
+  | D_nonrel (value,env)          -> make_nonrel_domain value env
   | D_product(domains,reductions) -> make_simplified_product domains reductions
   | D_functor(F_simplified f, d) ->
     let module F = (val f) in
@@ -181,7 +183,7 @@ and make_stacked_domain_without_semantic (domain:domain) : (module STACKED_COMBI
   | D_domain d      -> (module StandardToStacked(DomainToCombiner(val d)))
   | D_simplified d  -> (module StandardToStacked(SimplifiedToStandard(SimplifiedToCombiner(val d))))
   | D_stateless d   -> (module StandardToStacked(StatelessToDomain(StatelessToCombiner(val d))))
-  | D_nonrel(value) -> (module StandardToStacked(SimplifiedToStandard(val (make_nonrel_domain value))))
+  | D_nonrel(value,env) -> (module StandardToStacked(SimplifiedToStandard(val (make_nonrel_domain value env))))
 
   | D_functor(F_stacked f,d) ->
     let module F = (val f) in
@@ -93,8 +93,8 @@ let rec parse_domain json : domain =
     product = (fun semantic jsons reductions ->
         mk_domain (D_product (List.map parse_domain jsons, List.map parse_domain_reduction reductions)) ~semantic
       );
-    nonrel = (fun semantic json ->
-        mk_domain (D_nonrel(parse_value json)) ~semantic
+    nonrel = (fun semantic env json ->
+        mk_domain (D_nonrel(parse_value json, parse_nonrel_env env)) ~semantic
       );
     apply = (fun semantic funct arg ->
         mk_domain (D_functor(parse_domain_functor funct, parse_domain arg)) ~semantic
@@ -114,6 +114,12 @@ and parse_domain_functor name : domain_functor =
   try F_simplified(find_simplified_functor name)
   with Not_found -> Exceptions.panic "Domain functor '%s' not found" name
 
+and parse_nonrel_env (env:string option) : nonrel_env =
+  match env with
+  | None | Some "map" -> NE_map
+  | Some "patricia"   -> NE_patricia
+  | Some env -> Exceptions.panic "Non-relational environment '%s' not supported@.Available environments: map, patricia" env
+
 and parse_value json : value =
   json |> visit {
     leaf = (fun _ name -> try V_value (find_value_abstraction name) with Not_found -> Exceptions.panic "Value '%s' not found" name);
@@ -123,7 +129,7 @@ and parse_value json : value =
 
     switch = (fun _ jsons -> assert false);
     compose = (fun _ jsons -> assert false);
-    nonrel = (fun _ json -> assert false);
+    nonrel = (fun _ _ json -> assert false);
   }
 
 and parse_value_reduction (name:string) : value_reduction =
@@ -174,7 +180,7 @@ let domains file : string list =
     let rec name_visitor = Visitor.{
         leaf = (fun _ name -> [name]);
         switch = (fun _ l -> List.map get_names l |> List.flatten);
-        nonrel = (fun _ v -> get_names v);
+        nonrel = (fun _ _ v -> get_names v);
         apply = (fun _ f d -> f :: get_names d);
         compose = (fun _ l -> List.map get_names l |> List.flatten);
         product = (fun _ l r -> List.map get_names l |> List.flatten);
@@ -55,7 +55,7 @@ and domain_kind =
   | D_simplified of (module SIMPLIFIED)
   | D_stateless  of (module STATELESS)
   | D_functor    of domain_functor * domain
-  | D_nonrel     of value
+  | D_nonrel     of value * nonrel_env
   | D_switch   of domain list
   | D_compose    of domain list
   | D_product    of domain list * domain_reduction list
@@ -73,6 +73,11 @@ and value =
 
 and value_functor = (module VALUE_FUNCTOR)
 
+(** Representation of the environments of non-relational domains *)
+and nonrel_env =
+  | NE_map      (** balanced maps ordered by [compare_var] *)
+  | NE_patricia (** Patricia trees indexed by interned variables *)
+
 and domain_reduction =
   | DR_exec       of (module EXEC_REDUCTION)
   | DR_eval       of (module EVAL_REDUCTION)
@@ -171,9 +176,12 @@ and pp_domain_kind fmt = function
   | D_functor(f,d) ->
     fprintf fmt "%a(%a)" pp_domain_functor f pp_domain d
 
-  | D_nonrel v ->
+  | D_nonrel (v,NE_map) ->
     fprintf fmt "nonrel(%a)" pp_value v
 
+  | D_nonrel (v,NE_patricia) ->
+    fprintf fmt "nonrel[patricia](%a)" pp_value v
+
   | D_switch dl ->
     fprintf fmt "(%a)"
       (pp_print_list
@@ -33,7 +33,7 @@ type 'a visitor = {
   compose : string option -> Yojson.Basic.t list -> 'a;
   union : string option -> Yojson.Basic.t list -> 'a;
   apply : string option -> string -> Yojson.Basic.t -> 'a;
-  nonrel : string option -> Yojson.Basic.t -> 'a;
+  nonrel : string option -> string option -> Yojson.Basic.t -> 'a;
   product : string option -> Yojson.Basic.t list -> string list -> 'a;
 }
 
@@ -64,7 +64,8 @@ let visit_apply visitor obj =
 
 let visit_nonrel visitor obj =
   let v = List.assoc "nonrel" obj in
-  visitor.nonrel (get_semantic obj) v
+  let env = List.assoc_opt "env" obj |> OptionExt.lift to_string in
+  visitor.nonrel (get_semantic obj) env v
 
 let visit_union visitor obj =
   let l = List.assoc "union" obj |> to_list in
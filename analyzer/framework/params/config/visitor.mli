@@ -32,7 +32,7 @@ type 'a visitor = {
   compose : string option -> Yojson.Basic.t list -> 'a;
   union : string option -> Yojson.Basic.t list -> 'a;
   apply : string option -> string -> Yojson.Basic.t -> 'a;
-  nonrel : string option -> Yojson.Basic.t -> 'a;
+  nonrel : string option -> string option -> Yojson.Basic.t -> 'a;
   product : string option -> Yojson.Basic.t list -> string list -> 'a;
 }
 
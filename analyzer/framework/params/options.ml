@@ -194,6 +194,31 @@ let () =
   }
 
 
+(** Budgets of entry functions *)
+let () =
+  register_builtin_option {
+    key = "-entry-time-budget";
+    category = "Configuration";
+    doc = " wall-clock time limit in seconds for analyzing an entry function (0 for no limit)";
+    spec = ArgExt.Set_int Core.Budget.opt_time;
+    default = "0";
+  };
+  register_builtin_option {
+    key = "-entry-iteration-budget";
+    category = "Configuration";
+    doc = " maximal number of fixpoint iterations for analyzing an entry function (0 for no limit)";
+    spec = ArgExt.Set_int Core.Budget.opt_iterations;
+    default = "0";
+  };
+  register_builtin_option {
+    key = "-entry-heap-budget";
+    category = "Configuration";
+    doc = " maximal heap growth in megabytes when analyzing an entry function (0 for no limit)";
+    spec = ArgExt.Set_int Core.Budget.opt_heap;
+    default = "0";
+  }
+
+
 (** Debug channels *)
 
 (* Activate "print" channel by default *)
@@ -35,6 +35,9 @@ sig
   val name   : string
   (** Name of the reduction rule *)
 
+  val trigger : (expr -> bool) option
+  (** Optional trigger of the rule *)
+
   val reduce : expr -> ('a,'b) man -> 'a eval_reduction_man -> 'a flow -> expr list -> 'a flow -> 'a eval option
   (** [reduce e results man input_flow output_flow] reduces a product evaluation *)
 end
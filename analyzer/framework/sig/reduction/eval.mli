@@ -55,6 +55,10 @@ sig
   val name   : string
   (** Name of the reduction rule *)
 
+  val trigger : (expr -> bool) option
+  (** Optional trigger of the rule. When defined, the rule is fired only
+      when one of the evaluations of the product satisfies it. *)
+
   val reduce :
     expr -> ('a,'b) man -> 'a eval_reduction_man ->
     'a flow -> expr list -> 'a flow -> 'a eval option
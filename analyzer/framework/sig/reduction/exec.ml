@@ -35,6 +35,7 @@ type 'a exec_reduction_man = {
 module type EXEC_REDUCTION =
 sig
   val name   : string
+  val trigger : (var -> bool) option
   val reduce : stmt -> ('a,'b) man -> 'a exec_reduction_man ->
     'a flow -> 'a flow  -> teffect ->
     'a post option
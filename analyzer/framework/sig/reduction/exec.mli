@@ -43,6 +43,10 @@ sig
   val name   : string
   (** Name of the reduction rule *)
 
+  val trigger : (var -> bool) option
+  (** Optional trigger of the rule. When defined, the rule is fired only
+      when the statement or its effects touch a variable satisfying it. *)
+
   val reduce : stmt -> ('a,'b) man -> 'a exec_reduction_man ->
     'a flow -> 'a flow -> teffect -> 'a post option
   (** [reduce s man erman input output effects] reduces post-state [output]
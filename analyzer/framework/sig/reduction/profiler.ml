@@ -0,0 +1,85 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Profiling of reduction rules
+
+    Reduced products record, for each reduction rule, the number of times
+    it was fired or skipped, and the time spent in it.
+    Profiling is disabled by default and has no cost when disabled.
+*)
+
+
+(** Statistics of a reduction rule *)
+type stat = {
+  mutable fired   : int;   (** Number of times the rule was applied *)
+  mutable skipped : int;   (** Number of times the rule was skipped by its trigger, or because its input did not change *)
+  mutable time    : float; (** Total time spent in the rule *)
+}
+
+(** Flag enabling the profiler *)
+let enabled = ref false
+
+(** Statistics of reduction rules, indexed by name *)
+let stats : (string, stat) Hashtbl.t = Hashtbl.create 16
+
+let get_stat name =
+  try Hashtbl.find stats name
+  with Not_found ->
+    let s = { fired = 0; skipped = 0; time = 0. } in
+    Hashtbl.add stats name s;
+    s
+
+(** Record that rule [name] has been skipped *)
+let skip name =
+  if !enabled then
+    let s = get_stat name in
+    s.skipped <- s.skipped + 1
+
+(** [fire name f] applies the rule [name] implemented by [f] *)
+let fire name f =
+  if not !enabled then f () else
+  let s = get_stat name in
+  s.fired <- s.fired + 1;
+  let t = Sys.time () in
+  match f () with
+  | r ->
+    s.time <- s.time +. (Sys.time () -. t);
+    r
+  | exception e ->
+    s.time <- s.time +. (Sys.time () -. t);
+    raise e
+
+(** Return the statistics sorted by decreasing time *)
+let bindings () =
+  Hashtbl.fold (fun name s acc -> (name,s) :: acc) stats [] |>
+  List.sort (fun (_,s1) (_,s2) -> compare s2.time s1.time)
+
+(** Print the statistics table *)
+let print fmt () =
+  let l = bindings () in
+  let longest = List.fold_left (fun acc (name,_) -> max acc (String.length name)) 0 l in
+  Format.fprintf fmt "Reductions profiling:@.";
+  List.iter (fun (name,s) ->
+      Format.fprintf fmt "%s%s   %.4fs   x%d fired   x%d skipped@."
+        name
+        (String.make (longest - String.length name) ' ')
+        s.time s.fired s.skipped
+    ) l
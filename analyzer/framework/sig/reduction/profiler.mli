@@ -0,0 +1,51 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Profiling of reduction rules
+
+    Reduced products record, for each reduction rule, the number of times
+    it was fired or skipped, and the time spent in it.
+    Profiling is disabled by default and has no cost when disabled.
+*)
+
+
+(** Statistics of a reduction rule *)
+type stat = {
+  mutable fired   : int;   (** Number of times the rule was applied *)
+  mutable skipped : int;   (** Number of times the rule was skipped by its trigger, or because its input did not change *)
+  mutable time    : float; (** Total time spent in the rule *)
+}
+
+val enabled : bool ref
+(** Flag enabling the profiler *)
+
+val skip : string -> unit
+(** [skip name] records that rule [name] has been skipped *)
+
+val fire : string -> (unit -> 'a) -> 'a
+(** [fire name f] applies [f], the body of rule [name], and records its
+    execution time *)
+
+val bindings : unit -> (string * stat) list
+(** Statistics of all profiled rules, sorted by decreasing time *)
+
+val print : Format.formatter -> unit -> unit
+(** Print the statistics table *)
@@ -38,6 +38,7 @@ type ('a,'b) simplified_reduction_man = {
 module type SIMPLIFIED_REDUCTION =
 sig
   val name   : string
+  val trigger : (var -> bool) option
   val reduce : stmt -> ('a,'b) simplified_reduction_man -> 'a ctx -> 'b -> 'b -> 'b
 end
 
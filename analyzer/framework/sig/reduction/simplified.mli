@@ -64,6 +64,10 @@ sig
   val name   : string
   (** Name of the reduction rule *)
 
+  val trigger : (var -> bool) option
+  (** Optional trigger of the rule. When defined, the rule is fired only
+      when the statement touches a variable satisfying it. *)
+
   val reduce : stmt -> ('a,'b) simplified_reduction_man -> 'a ctx -> 'b -> 'b -> 'b
   (** [reduce s man ctx input output] applies a reduction rule on post-state
       [output] that resulted from executing statement [s] on pre-state [input] *)
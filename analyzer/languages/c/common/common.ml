@@ -2,6 +2,7 @@ module Alarms = Alarms
 module Base = Base
 module Builtins = Builtins
 module Points_to = Points_to
+module Pre_points_to = Pre_points_to
 module Quantified_offset = Quantified_offset
 module Scope_update = Scope_update
 module Soundness = Soundness
@@ -0,0 +1,552 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Flow-insensitive points-to pre-analysis.
+
+    Before the abstract interpretation starts, the whole linked program is
+    scanned once with a unification-based analysis à la Steensgaard. Memory
+    locations are partitioned into equivalence classes, and every class has
+    at most one pointee class. Records and arrays are collapsed into a single
+    location, and all heap blocks are represented by one abstract location.
+
+    The result over-approximates the targets of every pointer at every
+    program point, and is used where the flow-sensitive domains lose
+    precision, e.g. to resolve calls through unknown function pointers.
+
+    Functions without body are assumed to return pointers to the heap or to
+    the targets of their arguments. The locations they may write through
+    their arguments, according to the assigns clauses of their stubs, are
+    assumed to contain unknown pointers.
+*)
+
+open Mopsa
+open Universal.Ast
+open Ast
+
+
+let debug fmt = Debug.debug ~channel:"c.common.pre_points_to" fmt
+
+
+(** {2 Command-line options} *)
+(** ************************ *)
+
+let opt_pre_points_to = ref false
+
+let () = register_builtin_option {
+    key      = "-c-pre-points-to";
+    category = "C";
+    doc      = " run a flow-insensitive points-to pre-analysis of the program";
+    spec     = ArgExt.Set opt_pre_points_to;
+    default  = "";
+  }
+
+
+(** {2 Abstract locations} *)
+(** ********************** *)
+
+type loc =
+  | L_var of var        (** C variable *)
+  | L_fun of c_fundec   (** Function *)
+  | L_heap              (** Heap blocks *)
+  | L_string            (** String literals *)
+
+let compare_loc l1 l2 =
+  match l1, l2 with
+  | L_var v1, L_var v2 -> compare_var v1 v2
+  | L_fun f1, L_fun f2 -> compare f1.c_func_unique_name f2.c_func_unique_name
+  | _ -> compare l1 l2
+
+let pp_loc fmt = function
+  | L_var v -> pp_var fmt v
+  | L_fun f -> Format.fprintf fmt "fun %s" f.c_func_org_name
+  | L_heap -> Format.pp_print_string fmt "heap"
+  | L_string -> Format.pp_print_string fmt "string"
+
+module LocSet = SetExt.Make(struct type t = loc let compare = compare_loc end)
+
+
+(** {2 Equivalence classes} *)
+(** *********************** *)
+
+(** Nodes of the union-find structure. Only representatives hold the
+    locations, the pointee and the [unknown] flag of their class. *)
+type node = {
+  id: int;
+  mutable parent: node option;
+  mutable pointee: node option;
+  mutable locs: LocSet.t;
+  mutable unknown: bool; (** the class contains locations not modeled by the analysis *)
+}
+
+let counter = ref 0
+
+let fresh () =
+  incr counter;
+  { id = !counter; parent = None; pointee = None; locs = LocSet.empty; unknown = false }
+
+let rec find n =
+  match n.parent with
+  | None -> n
+  | Some p ->
+    let r = find p in
+    if r != p then n.parent <- Some r;
+    r
+
+(** Unknown classes only point to unknown classes *)
+let rec set_unknown n =
+  let r = find n in
+  if not r.unknown then begin
+    r.unknown <- true;
+    match r.pointee with
+    | None -> ()
+    | Some p -> set_unknown p
+  end
+
+let rec unify n1 n2 =
+  let r1 = find n1 and r2 = find n2 in
+  if r1 != r2 then begin
+    let unknown = r1.unknown || r2.unknown in
+    r2.parent <- Some r1;
+    r1.locs <- LocSet.union r1.locs r2.locs;
+    r1.unknown <- unknown;
+    r2.locs <- LocSet.empty;
+    let p2 = r2.pointee in
+    r2.pointee <- None;
+    begin match r1.pointee, p2 with
+      | _, None -> ()
+      | None, Some _ -> r1.pointee <- p2
+      | Some p1, Some p2 -> unify p1 p2
+    end;
+    if unknown then
+      match (find r1).pointee with
+      | None -> ()
+      | Some p -> set_unknown p
+  end
+
+let join n1 n2 =
+  unify n1 n2;
+  find n1
+
+(** Pointee class of a class, created on demand *)
+let pointee n =
+  let r = find n in
+  match r.pointee with
+  | Some p -> find p
+  | None ->
+    let p = fresh () in
+    p.unknown <- r.unknown;
+    r.pointee <- Some p;
+    p
+
+
+(** {2 Analysis state} *)
+(** ****************** *)
+
+(** Nodes of locations, indexed by unique names *)
+let nodes : (string, node) Hashtbl.t = Hashtbl.create 64
+
+(** Targets of the values returned by functions *)
+let returns : (string, node) Hashtbl.t = Hashtbl.create 16
+
+(** Targets of the variadic arguments of all functions *)
+let varargs = ref (fresh ())
+
+(** Calls through function pointers, with the functions already bound *)
+type indirect_call = {
+  callee: node;
+  args: node list;
+  ret: node;
+  mutable bound: SetExt.StringSet.t;
+}
+
+let indirect_calls : indirect_call list ref = ref []
+
+(** Function being analyzed *)
+let current_fun : c_fundec option ref = ref None
+
+(** Whether the pre-analysis has been run *)
+let computed = ref false
+
+(** Variables sharing their class with other variables, with the
+    identifier of the class *)
+let alias_classes : (string, int) Hashtbl.t = Hashtbl.create 16
+
+let loc_key = function
+  | L_var v -> "v:" ^ v.vname
+  | L_fun f -> "f:" ^ f.c_func_unique_name
+  | L_heap -> "heap"
+  | L_string -> "string"
+
+let node_of_loc l =
+  let k = loc_key l in
+  match Hashtbl.find_opt nodes k with
+  | Some n -> find n
+  | None ->
+    let n = fresh () in
+    n.locs <- LocSet.singleton l;
+    Hashtbl.add nodes k n;
+    n
+
+let return_node f =
+  match Hashtbl.find_opt returns f.c_func_unique_name with
+  | Some n -> find n
+  | None ->
+    let n = fresh () in
+    Hashtbl.add returns f.c_func_unique_name n;
+    n
+
+
+(** {2 Constraint generation} *)
+(** ************************* *)
+
+(** Arrays and functions decay into their address *)
+let decays t =
+  match remove_typedef_qual t with
+  | T_c_array _ | T_c_function _ -> true
+  | _ -> false
+
+(** Arguments of a call to function [f] without body through which [f] may
+    store values: the arguments of the parameters appearing in the assigns
+    clauses of its stub, and the variadic arguments. All arguments are
+    kept when [f] has no stub, or when its stub calls other functions. *)
+let stored_args f args =
+  match f.c_func_stub with
+  | None -> args
+  | Some stub when List.exists (fun l -> match l.content.Stubs.Ast.lval with Stubs.Ast.L_call _ -> true | _ -> false) stub.stub_func_locals -> args
+  | Some stub ->
+    let is_assigned p =
+      List.exists (fun a -> Visitor.is_var_in_expr p a.content.Stubs.Ast.assign_target) stub.stub_func_assigns
+    in
+    let rec iter params args =
+      match params, args with
+      | p :: params, a :: args -> if is_assigned p then a :: iter params args else iter params args
+      | [], args -> args
+      | _, [] -> []
+    in
+    iter stub.stub_func_params args
+
+(** Bind the arguments and the returned value of a call to function [f] *)
+let bind_call f args ret =
+  match f.c_func_body with
+  | Some _ ->
+    let rec iter params args =
+      match params, args with
+      | p :: params, a :: args ->
+        unify (pointee (node_of_loc (L_var p))) a;
+        iter params args
+      | [], args ->
+        List.iter (unify !varargs) args
+      | _, [] -> ()
+    in
+    iter f.c_func_parameters args;
+    unify ret (return_node f)
+
+  | None ->
+    (* Values stored through the arguments are not known *)
+    List.iter (fun a -> set_unknown (pointee a)) (stored_args f args);
+    if is_c_pointer_type f.c_func_return then begin
+      unify ret (node_of_loc L_heap);
+      List.iter (unify ret) args
+    end
+
+
+(** Class of the locations denoted by an lvalue *)
+let rec lval e : node =
+  match ekind e with
+  | E_var (v, _) -> node_of_loc (L_var v)
+  | E_c_deref p -> rval p
+  | E_c_arrow_access (p, _, _) -> rval p
+  | E_c_member_access (r, _, _) -> lval r
+  | E_c_array_subscript (a, i) -> ignore (rval i); rval a
+  | E_c_cast (e, _) -> lval e
+  | _ -> ignore (rval e); fresh ()
+
+(** Class of the locations targeted by the value of an expression *)
+and rval e : node =
+  match ekind e with
+  | E_var _ | E_c_deref _ | E_c_arrow_access _ | E_c_member_access _ | E_c_array_subscript _ ->
+    let n = lval e in
+    if decays e.etyp then n else pointee n
+
+  | E_c_function f -> node_of_loc (L_fun f)
+
+  | E_c_address_of e -> lval e
+
+  | E_constant (C_c_string _) -> node_of_loc L_string
+
+  | E_c_cast ({ ekind = E_constant (C_int n) }, _)
+    when is_c_pointer_type e.etyp && not (Z.equal n Z.zero) ->
+    (* Absolute addresses *)
+    let n = fresh () in
+    set_unknown n;
+    n
+
+  | E_c_cast (e, _) | E_unop (_, e) | E_c_block_object e -> rval e
+
+  | E_c_increment (_, _, e) -> rval e
+
+  | E_binop (op, e1, e2) ->
+    let n1 = rval e1 and n2 = rval e2 in
+    if is_comparison_op op || is_logic_op op then fresh ()
+    else join n1 n2
+
+  | E_c_conditional (c, e1, e2) ->
+    ignore (rval c);
+    join (rval e1) (rval e2)
+
+  | E_c_assign (l, r) ->
+    let n = rval r in
+    unify (pointee (lval l)) n;
+    find n
+
+  | E_c_compound_assign (l, _, _, r, _) ->
+    join (pointee (lval l)) (rval r)
+
+  | E_c_comma (e1, e2) ->
+    ignore (rval e1);
+    rval e2
+
+  | E_call ({ ekind = E_c_function f }, args) ->
+    let args = List.map rval args in
+    let ret = fresh () in
+    bind_call f args ret;
+    find ret
+
+  | E_call (f, args) ->
+    let callee = rval f in
+    let args = List.map rval args in
+    let ret = fresh () in
+    indirect_calls := { callee; args; ret; bound = SetExt.StringSet.empty } :: !indirect_calls;
+    ret
+
+  | E_c_builtin_call (_, args) ->
+    List.fold_left (fun acc a -> join acc (rval a)) (fresh ()) args
+
+  | E_c_var_args e ->
+    ignore (rval e);
+    find !varargs
+
+  | E_c_atomic (_, e1, e2) ->
+    let n = pointee (rval e1) in
+    join n (rval e2)
+
+  | E_c_statement s -> stmt_value s
+
+  | _ ->
+    Visitor.fold_sub_expr visit_expr visit_stmt () e;
+    fresh ()
+
+(** Value of a statement expression, given by its last statement *)
+and stmt_value s =
+  match skind s with
+  | S_block (l, _) when l <> [] ->
+    let rec iter = function
+      | [] -> fresh ()
+      | [ { skind = S_expression e } ] -> rval e
+      | [ s ] -> stmt_value s
+      | s :: tl -> walk_stmt s; iter tl
+    in
+    iter l
+  | S_expression e -> rval e
+  | _ -> walk_stmt s; fresh ()
+
+and init_loc n init =
+  match init with
+  | C_init_expr e -> unify (pointee n) (rval e)
+  | C_init_list (l, filler) ->
+    List.iter (init_loc n) l;
+    Option.iter (init_loc n) filler
+  | C_init_implicit _ -> ()
+
+and visit_expr () e =
+  ignore (rval e);
+  Keep ()
+
+and visit_stmt () s =
+  match skind s with
+  | S_assign (l, r) ->
+    unify (pointee (lval l)) (rval r);
+    Keep ()
+
+  | S_c_declaration (v, Some init, _) ->
+    init_loc (node_of_loc (L_var v)) init;
+    Keep ()
+
+  | S_c_return (Some e, _) ->
+    let n = rval e in
+    begin match !current_fun with
+      | Some f -> unify (return_node f) n
+      | None -> ()
+    end;
+    Keep ()
+
+  | S_c_ext_call (f, args) ->
+    bind_call f (List.map rval args) (fresh ());
+    Keep ()
+
+  | _ -> VisitParts ()
+
+and walk_stmt s =
+  Visitor.fold_stmt visit_expr visit_stmt () s
+
+
+(** Bind the targets of calls through function pointers until stability *)
+let rec resolve_indirect_calls () =
+  let changed =
+    List.fold_left (fun changed call ->
+        LocSet.fold (fun l changed ->
+            match l with
+            | L_fun f when not (SetExt.StringSet.mem f.c_func_unique_name call.bound) ->
+              call.bound <- SetExt.StringSet.add f.c_func_unique_name call.bound;
+              bind_call f call.args call.ret;
+              true
+            | _ -> changed
+          ) (find call.callee).locs changed
+      ) false !indirect_calls
+  in
+  if changed then resolve_indirect_calls ()
+
+
+(** {2 Entry point} *)
+(** *************** *)
+
+(** Run the pre-analysis on program [prog]. The parameters of the [entry]
+    function point to unknown locations. *)
+let analyze ?(entry="main") (prog:c_program) : unit =
+  Hashtbl.reset nodes;
+  Hashtbl.reset returns;
+  Hashtbl.reset alias_classes;
+  varargs := fresh ();
+  indirect_calls := [];
+  List.iter (fun (v, init) ->
+      Option.iter (init_loc (node_of_loc (L_var v))) init
+    ) prog.c_globals;
+  List.iter (fun f ->
+      match f.c_func_body with
+      | None -> ()
+      | Some body ->
+        current_fun := Some f;
+        if f.c_func_org_name = entry then
+          List.iter (fun p -> set_unknown (pointee (node_of_loc (L_var p)))) f.c_func_parameters;
+        walk_stmt body
+    ) prog.c_functions;
+  current_fun := None;
+  resolve_indirect_calls ();
+  (* Group the variables by class *)
+  let classes = Hashtbl.create 16 in
+  Hashtbl.iter (fun _ n ->
+      let r = find n in
+      if not (Hashtbl.mem classes r.id) then Hashtbl.add classes r.id r
+    ) nodes;
+  Hashtbl.iter (fun id r ->
+      let vars = LocSet.filter (function L_var _ -> true | _ -> false) r.locs in
+      if LocSet.cardinal vars > 1 then
+        LocSet.iter (function
+            | L_var v -> Hashtbl.replace alias_classes v.vname id
+            | _ -> ()
+          ) vars
+    ) classes;
+  computed := true;
+  debug "%d classes, %d calls through function pointers"
+    (Hashtbl.length classes) (List.length !indirect_calls)
+
+
+(** {2 Results} *)
+(** *********** *)
+
+type pre_points_to =
+  | Pre_top                (** Unknown targets *)
+  | Pre_set of LocSet.t    (** May-targets *)
+
+let pp_pre_points_to fmt = function
+  | Pre_top -> Format.pp_print_string fmt "⊤"
+  | Pre_set s -> LocSet.fprint SetExt.printer_default pp_loc fmt s
+
+(** Class of an lvalue, without creating classes. Only the path
+    compression of [find] changes the union-find structure. *)
+let rec peek_lval e : node option =
+  match ekind e with
+  | E_var (v, _) -> Hashtbl.find_opt nodes (loc_key (L_var v)) |> Option.map find
+  | E_c_deref p | E_c_arrow_access (p, _, _) | E_c_array_subscript (p, _) -> peek_rval p
+  | E_c_member_access (r, _, _) | E_c_cast (r, _) -> peek_lval r
+  | _ -> None
+
+and peek_rval e : node option =
+  match ekind e with
+  | E_var _ | E_c_deref _ | E_c_arrow_access _ | E_c_member_access _ | E_c_array_subscript _ ->
+    peek_lval e |> OptionExt.bind (fun n ->
+        if decays e.etyp then Some n
+        else (find n).pointee |> Option.map find
+      )
+  | E_c_function f -> Hashtbl.find_opt nodes (loc_key (L_fun f)) |> Option.map find
+  | E_c_address_of e -> peek_lval e
+  | E_c_cast (e, _) | E_unop (_, e) -> peek_rval e
+  | _ -> None
+
+(** Targets of the value of a pointer expression *)
+let targets (e:expr) : pre_points_to =
+  if not !computed then Pre_top
+  else
+    match peek_rval e with
+    | None -> Pre_top
+    | Some n ->
+      let r = find n in
+      if r.unknown then Pre_top else Pre_set r.locs
+
+(** Identifier of the class of a variable, when it may be accessed through
+    the same pointers as other variables *)
+let alias_class (v:var) : int option =
+  Hashtbl.find_opt alias_classes v.vname
+
+
+(** {2 Query} *)
+(** ********* *)
+
+type ('a,_) query += Q_c_pre_points_to : expr -> ('a,pre_points_to) query
+
+let () = register_query {
+    join = (
+      let f : type a r. query_pool -> (a,r) query -> r -> r -> r =
+        fun next query a b ->
+          match query with
+          | Q_c_pre_points_to _ ->
+            begin match a, b with
+              | Pre_top, _ | _, Pre_top -> Pre_top
+              | Pre_set s1, Pre_set s2 -> Pre_set (LocSet.union s1 s2)
+            end
+          | _ -> next.pool_join query a b
+      in
+      f
+    );
+    meet = (
+      let f : type a r. query_pool -> (a,r) query -> r -> r -> r =
+        fun next query a b ->
+          match query with
+          | Q_c_pre_points_to _ ->
+            begin match a, b with
+              | Pre_top, x | x, Pre_top -> x
+              | Pre_set s1, Pre_set s2 -> Pre_set (LocSet.inter s1 s2)
+            end
+          | _ -> next.pool_meet query a b
+      in
+      f
+    );
+  }
@@ -429,6 +429,44 @@ struct
       >>% fun flow ->
       Eval.singleton e flow
 
+  (** Functions that may be targeted by the function pointer [f], according
+      to the points-to pre-analysis. When the arguments [args] of the call
+      are given, only functions with a compatible arity are kept. [None] is
+      returned when [f] may also point to objects that are not functions,
+      e.g. heap blocks, as the call can not be resolved soundly. *)
+  let pre_resolve_function_pointer f ?args man flow =
+    match man.ask (Pre_points_to.Q_c_pre_points_to f) flow with
+    | Pre_points_to.Pre_top -> None
+    | Pre_points_to.Pre_set s when Pre_points_to.LocSet.exists (function Pre_points_to.L_fun _ -> false | _ -> true) s -> None
+    | Pre_points_to.Pre_set s ->
+      let targets =
+        Pre_points_to.LocSet.fold (fun l acc ->
+            match l, args with
+            | Pre_points_to.L_fun ff, None -> ff :: acc
+            | Pre_points_to.L_fun ff, Some args ->
+              let nargs = List.length args in
+              let nparams = List.length ff.c_func_parameters in
+              if nparams = nargs || (ff.c_func_variadic && nparams < nargs)
+              then ff :: acc
+              else acc
+            | _ -> acc
+          ) s []
+      in
+      if targets = [] then None else Some targets
+
+  (** Call [exp] through an undetermined function pointer [f], ignored under
+      a soundness assumption *)
+  let ignore_undetermined_call f exp man flow =
+    let flow =
+      Flow.add_local_assumption
+        (Soundness.A_ignore_undetermined_function_pointer f)
+        exp.erange flow
+    in
+    if is_c_void_type exp.etyp then
+      Eval.singleton (mk_unit exp.erange) flow
+    else
+      man.eval (mk_top exp.etyp exp.erange) flow
+
   (* 𝔼⟦ *p ⟧ where p is a pointer to a function *)
   let eval_deref_function_pointer p range man flow =
     resolve_pointer p man flow >>$ fun pt flow ->
@@ -437,15 +475,22 @@ struct
       Eval.singleton (mk_expr (E_c_function f) ~etyp:(under_type p.etyp) range) flow
 
     | P_top ->
-      let flow =
-        Flow.add_local_assumption
-          (Soundness.A_ignore_undetermined_function_pointer p)
-          range flow
-      in
-      if under_type p.etyp |> is_c_void_type then
-        Eval.singleton (mk_unit range) flow
-      else
-        man.eval (mk_top (under_type p.etyp) range) flow
+      begin match pre_resolve_function_pointer p man flow with
+        | Some targets ->
+          Eval.join_list ~empty:(fun () -> Eval.empty flow)
+            (List.map (fun f -> Eval.singleton (mk_expr (E_c_function f) ~etyp:(under_type p.etyp) range) flow) targets)
+
+        | None ->
+          let flow =
+            Flow.add_local_assumption
+              (Soundness.A_ignore_undetermined_function_pointer p)
+              range flow
+          in
+          if under_type p.etyp |> is_c_void_type then
+            Eval.singleton (mk_unit range) flow
+          else
+            man.eval (mk_top (under_type p.etyp) range) flow
+      end
 
     | _ ->
       panic_at range
@@ -467,18 +512,21 @@ struct
           eval_call f args exp.erange man flow |>
           OptionExt.return
 
+        | P_top ->
+          begin match pre_resolve_function_pointer f ~args man flow with
+            | Some targets ->
+              Eval.join_list ~empty:(fun () -> Eval.empty flow)
+                (List.map (fun ff -> eval_call ff args exp.erange man flow) targets) |>
+              OptionExt.return
+
+            | None ->
+              ignore_undetermined_call f exp man flow |>
+              OptionExt.return
+          end
+
         | _ ->
-          let flow =
-            Flow.add_local_assumption
-              (Soundness.A_ignore_undetermined_function_pointer f)
-              exp.erange flow
-          in
-          if is_c_void_type exp.etyp then
-            Eval.singleton (mk_unit exp.erange) flow |>
-            OptionExt.return
-          else
-            man.eval (mk_top exp.etyp exp.erange) flow |>
-            OptionExt.return
+          ignore_undetermined_call f exp man flow |>
+          OptionExt.return
       end
 
     | E_c_deref p when under_type p.etyp |> is_c_function_type
@@ -52,7 +52,7 @@ struct
   (** ==================== *)
 
   (** Name of the entry function to be analyzed. *)
-  let opt_entry_function = ref "main"
+  let opt_entry_function = Frontend.opt_entry_function
 
   let () =
     register_domain_option name {
@@ -136,6 +136,39 @@ struct
     default=""
   }
 
+  (** Number of worker processes analyzing runtime functions in parallel *)
+  let opt_runtimetest_jobs = ref 1
+
+  (** Time budget of the analysis of a runtime function, in seconds *)
+  let opt_runtimetest_timeout = ref 0
+
+  (** Heap budget of the analysis of a runtime function, in megabytes *)
+  let opt_runtimetest_max_memory = ref 0
+
+  let () = register_domain_option name {
+    key = "-runtimetest-jobs";
+    category="Runtime";
+    doc=" number of worker processes used to test C stubs in parallel";
+    spec = ArgExt.Set_int opt_runtimetest_jobs;
+    default="1"
+  }
+
+  let () = register_domain_option name {
+    key = "-runtimetest-timeout";
+    category="Runtime";
+    doc=" time limit in seconds for testing a C stub (0 for no limit)";
+    spec = ArgExt.Set_int opt_runtimetest_timeout;
+    default="0"
+  }
+
+  let () = register_domain_option name {
+    key = "-runtimetest-max-memory";
+    category="Runtime";
+    doc=" heap limit in megabytes for testing a C stub (0 for no limit)";
+    spec = ArgExt.Set_int opt_runtimetest_max_memory;
+    default="0"
+  }
+
 
 
 
@@ -167,7 +200,10 @@ struct
 
   let init prog man flow =
     match prog.prog_kind with
-    | C_program p -> set_c_program p flow
+    | C_program p ->
+      if !Pre_points_to.opt_pre_points_to then
+        Pre_points_to.analyze ~entry:!opt_entry_function p;
+      set_c_program p flow
     | _ -> flow
 
 
@@ -246,7 +282,13 @@ struct
 
   let exec_virtual_runtime_function_test f ty man flow =
     try
-      exec_virtual_runtime_function_test_exn f ty man flow
+      match Budget.run (fun () -> exec_virtual_runtime_function_test_exn f ty man flow |> post_to_flow man) with
+      | Ok flow -> Post.return flow
+      | Error r ->
+        (* the budget of the function is exhausted, abandon it *)
+        Budget.abandon f.c_func_org_name r f.c_func_range flow |>
+        Flow.remove T_cur |>
+        Post.return
     with e ->
       (* something went wrong in the analysis *)
       let flow = raise_ffi_internal_error "An unexpected exception was raised during the analysis." f.c_func_range man flow in
@@ -269,6 +311,165 @@ struct
         exec_all_runtime_functions fs man (flow' :: flows) ((f.c_func_org_name, res) :: results) flow
 
 
+  (** Reports of worker processes *)
+  (** ============================ *)
+
+  (** Checks, alarms and assumptions are extensible variants: an
+      unmarshalled extension constructor is a copy of the constructor of the
+      worker, and is recognized by none of the pattern matchings of the
+      parent process. Workers therefore send back their reports as plain
+      data, in which extensible values are replaced by their rendering. The
+      parent then rebuilds a report with its own constructors. *)
+  type check += CHK_rendered of string
+  type alarm_kind += A_rendered of string * check
+  type assumption_kind += A_rendered_assumption of string
+
+  let () =
+    register_check (fun next fmt -> function
+        | CHK_rendered s -> Format.pp_print_string fmt s
+        | a -> next fmt a
+      );
+    register_alarm {
+      check = (fun next -> function
+          | A_rendered (_, chk) -> chk
+          | a -> next a
+        );
+      compare = (fun next a1 a2 ->
+          match a1, a2 with
+          | A_rendered (s1, _), A_rendered (s2, _) -> String.compare s1 s2
+          | _ -> next a1 a2
+        );
+      print = (fun next fmt -> function
+          | A_rendered (s, _) -> Format.pp_print_string fmt s
+          | a -> next fmt a
+        );
+      join = (fun next a1 a2 -> next a1 a2);
+    };
+    register_assumption {
+      print = (fun next fmt -> function
+          | A_rendered_assumption s -> Format.pp_print_string fmt s
+          | a -> next fmt a
+        );
+      compare = (fun next a1 a2 ->
+          match a1, a2 with
+          | A_rendered_assumption s1, A_rendered_assumption s2 -> String.compare s1 s2
+          | _ -> next a1 a2
+        );
+    }
+
+  (** Rendered alarm: kind, check, range and callstack *)
+  type rendered_alarm = string * string * range * callstack
+
+  (** Rendered diagnostic *)
+  type rendered_diagnostic = {
+    rd_range     : range;
+    rd_callstack : callstack;
+    rd_check     : string;
+    rd_kind      : diagnostic_kind;
+    rd_alarms    : rendered_alarm list;
+  }
+
+  (** Rendered report, containing no extensible value *)
+  type rendered_report = {
+    rr_diagnostics : rendered_diagnostic list;
+    rr_assumptions : (assumption_scope * string) list;
+  }
+
+  let render pp x =
+    let color = !Debug.print_color in
+    Debug.print_color := false;
+    let s = Format.asprintf "%a" pp x in
+    Debug.print_color := color;
+    s
+
+  (** Render a report as plain data that can be marshalled *)
+  let render_report (r:report) : rendered_report =
+    let render_alarm a =
+      render pp_alarm_kind a.alarm_kind, render pp_check a.alarm_check, a.alarm_range, a.alarm_callstack
+    in
+    { rr_diagnostics =
+        RangeCallStackMap.fold (fun (range, cs) checks acc ->
+            CheckMap.fold (fun chk diag acc ->
+                { rd_range = range;
+                  rd_callstack = cs;
+                  rd_check = render pp_check chk;
+                  rd_kind = diag.diag_kind;
+                  rd_alarms = AlarmSet.elements diag.diag_alarms |> List.map render_alarm; } :: acc
+              ) checks acc
+          ) r.report_diagnostics [];
+      rr_assumptions =
+        AssumptionSet.elements r.report_assumptions |>
+        List.map (fun a -> a.assumption_scope, render pp_assumption_kind a.assumption_kind); }
+
+  (** Rebuild a report from its rendering, with the constructors of the
+      current process *)
+  let rebuild_report (r:rendered_report) : report =
+    let rebuild_alarm (kind, chk, range, cs) =
+      let chk = CHK_rendered chk in
+      { alarm_kind = A_rendered (kind, chk); alarm_check = chk; alarm_range = range; alarm_callstack = cs }
+    in
+    { report_diagnostics =
+        List.fold_left (fun acc d ->
+            let chk = CHK_rendered d.rd_check in
+            let diag = {
+              diag_range = d.rd_range;
+              diag_check = chk;
+              diag_kind = d.rd_kind;
+              diag_alarms = AlarmSet.of_list (List.map rebuild_alarm d.rd_alarms);
+              diag_callstack = d.rd_callstack;
+            }
+            in
+            let key = (d.rd_range, d.rd_callstack) in
+            let checks = RangeCallStackMap.find_opt key acc |> OptionExt.default CheckMap.empty in
+            RangeCallStackMap.add key (CheckMap.add chk diag checks) acc
+          ) RangeCallStackMap.empty r.rr_diagnostics;
+      report_assumptions =
+        List.fold_left (fun acc (scope, kind) ->
+            AssumptionSet.add { assumption_scope = scope; assumption_kind = A_rendered_assumption kind } acc
+          ) AssumptionSet.empty r.rr_assumptions; }
+
+
+  (** Analysis of a runtime function in a worker process. The worker sends
+      back the outcome of the function, the external functions that were
+      called, and its rendered report. *)
+  let exec_runtime_function_in_worker man flow (f, ty) =
+    let flow' = exec_virtual_runtime_function_test f ty man flow |> post_to_flow man in
+    let report = Flow.get_report flow' in
+    function_report_outcome report, StringSet.elements !ffitest_missing_funs, render_report report
+
+  (** Analyze runtime functions in a pool of worker processes. Outcomes are
+      merged in program order, whatever the order of completion. Workers
+      can not send back their abstract states, so the returned flow is the
+      initial one, with the join of the reports of all workers. Functions
+      whose analysis was aborted are reported as internal errors. *)
+  let exec_all_runtime_functions_parallel fs man flow =
+    let timeout = if !opt_runtimetest_timeout > 0 then Some (float_of_int !opt_runtimetest_timeout) else None in
+    let max_heap = if !opt_runtimetest_max_memory > 0 then Some (!opt_runtimetest_max_memory * 1024 * 1024) else None in
+    let names = Array.of_list (List.map (fun (f, _) -> f.c_func_org_name) fs) in
+    let outcomes =
+      WorkerPool.run ~jobs:!opt_runtimetest_jobs ?timeout ?max_heap
+        ~on_outcome:(fun i _ -> Debug.debug ~channel:"runtime_functions" "%s analyzed" names.(i))
+        (exec_runtime_function_in_worker man flow) fs
+    in
+    let results, report =
+      List.fold_left2 (fun (results, report) (f, _) outcome ->
+          let fname = f.c_func_org_name in
+          let failure msg =
+            let flow' = raise_ffi_internal_error ("Analysis aborted: " ^ msg) f.c_func_range man (Flow.remove_report flow) in
+            (fname, Unimplemented) :: results, join_report report (rebuild_report (render_report (Flow.get_report flow')))
+          in
+          match outcome with
+          | WorkerPool.Done (res, missing, report') ->
+            ffitest_missing_funs := List.fold_left (fun acc g -> StringSet.add g acc) !ffitest_missing_funs missing;
+            (fname, res) :: results, join_report report (rebuild_report report')
+          | WorkerPool.Failed msg -> failure msg
+          | WorkerPool.Timeout -> failure (Printf.sprintf "timeout after %ds" !opt_runtimetest_timeout)
+          | WorkerPool.Memory_exceeded -> failure (Printf.sprintf "heap exceeded %dMB" !opt_runtimetest_max_memory)
+        ) ([], rebuild_report (render_report (Flow.get_report flow))) fs outcomes
+    in
+    Cases.singleton (List.rev results) (Flow.set_report report flow)
+
+
   let output_results skipped_functions results to_test =
     let pp_unknown_functions fmt set =
       Format.pp_print_list ~pp_sep:(fun fmt () -> Format.pp_print_string fmt ","; Format.pp_print_space fmt ()) Format.pp_print_string fmt (StringSet.elements set)
@@ -296,7 +497,9 @@ struct
     let c_functions = List.sort (fun f g -> compare_range f.c_func_range g.c_func_range) c_functions in
     let ffi_functions = List.concat_map (fun f -> match type_shape_of_function f with None -> [] | Some sh -> [(f, sh)]) c_functions in
     (* Execute all the runtime functions, yielding a list of results for each function *)
-    exec_all_runtime_functions ffi_functions man [] [] flow >>$ fun results flow ->
+    let use_workers = !opt_runtimetest_jobs > 1 || !opt_runtimetest_timeout > 0 || !opt_runtimetest_max_memory > 0 in
+    (if use_workers then exec_all_runtime_functions_parallel ffi_functions man flow
+     else exec_all_runtime_functions ffi_functions man [] [] flow) >>$ fun results flow ->
     (* we output the results, the functions that were assumed to be missing,
        and compute the functions that should have been checked but were not. *)
     output_results (!ffitest_missing_funs) results (!ffitest_extfuns);
@@ -857,6 +1060,10 @@ struct
   let ask : type r. ('a,r) query -> _ man -> _ flow -> r option = fun query man flow ->
     let open Framework.Engines.Interactive in
     match query with
+    (* Targets of a pointer given by the pre-analysis *)
+    | Pre_points_to.Q_c_pre_points_to e ->
+      Some (Pre_points_to.targets e)
+
     (* Get the list of variables in the current scope *)
     | Q_defined_variables ->
       let prog = get_c_program flow in
@@ -69,6 +69,30 @@ let opt_stubs_files = ref []
 let opt_ignored_translation_units = ref []
 (** List of translation units to ignore during linking *)
 
+let opt_pch = ref false
+(** Use precompiled headers for the common system includes *)
+
+let opt_parse_threads = ref 1
+(** Number of threads parsing the source files given on the command line *)
+
+let opt_entry_function = ref "main"
+(** Name of the entry function, set by the option -c-entry of the program iterator *)
+
+let opt_reachable_only = ref false
+(** Translate only the functions reachable from the entry function *)
+
+let opt_stub_jobs = ref 1
+(** Number of worker processes parsing the stub comments *)
+
+let opt_stub_comments_only = ref true
+(** Translate only stub comments, and the macros they use, from Clang *)
+
+let opt_profile_parser = ref false
+(** Profile the phases of the parsing, in the JSON report *)
+
+let opt_profile_parser_trace = ref ""
+(** File where the profiled phases are saved as a Chrome trace *)
+
 let () =
   register_language_option "c" {
     key = "-I";
@@ -147,11 +171,120 @@ let () =
     spec = ArgExt.Set_string_list opt_ignored_translation_units;
     default = "";
   };
+  register_language_option "c" {
+    key = "-c-pch";
+    category = "C";
+    doc = " parse the system includes shared by the source files with a precompiled header.";
+    spec = ArgExt.Set opt_pch;
+    default = "unset";
+  };
+  register_language_option "c" {
+    key = "-c-parse-threads";
+    category = "C";
+    doc = " number of threads parsing the C source files, given on the command line or in a database. Ignored with -c-pch.";
+    spec = ArgExt.Set_int opt_parse_threads;
+    default = "1";
+  };
+  register_language_option "c" {
+    key = "-c-reachable-only";
+    category = "C";
+    doc = " translate only the functions reachable from the entry function, the initializers of globals and the stub directives.";
+    spec = ArgExt.Set opt_reachable_only;
+    default = "unset";
+  };
+  register_language_option "c" {
+    key = "-c-stub-jobs";
+    category = "C";
+    doc = " number of worker processes parsing the stub comments of the project.";
+    spec = ArgExt.Set_int opt_stub_jobs;
+    default = "1";
+  };
+  register_language_option "c" {
+    key = "-c-keep-all-comments";
+    category = "C";
+    doc = " keep all comments and macros of the parsed files, instead of stub comments and their macros only.";
+    spec = ArgExt.Clear opt_stub_comments_only;
+    default = "unset";
+  };
+  register_language_option "c" {
+    key = "-c-profile-parser";
+    category = "C";
+    doc = " report the time and allocations of the parsing phases of each translation unit in the JSON output.";
+    spec = ArgExt.Set opt_profile_parser;
+    default = "unset";
+  };
+  register_language_option "c" {
+    key = "-c-profile-parser-trace";
+    category = "C";
+    doc = " save the parsing phases in the given file, in the Chrome trace format.";
+    spec = ArgExt.Set_string opt_profile_parser_trace;
+    default = "";
+  };
   ()
 
 
 
 
+(** {2 Parser profiling} *)
+(** ===================== *)
+
+let render_profile_phase (e:C_profile.event) =
+  let open C_profile in
+  `Assoc [
+    "phase", `String e.ev_phase;
+    "time", `Float e.ev_wall;
+    "ocaml_words", `Float e.ev_words;
+    "minor_gcs", `Int e.ev_minor_gcs;
+    "major_gcs", `Int e.ev_major_gcs;
+    "clang_mem", `Float e.ev_clang_mem;
+  ]
+
+let render_profile () =
+  `List (
+    C_profile.summary () |>
+    List.map (fun (tu, phases) ->
+        `Assoc [
+          "translation_unit", `String tu;
+          "phases", `List (List.map render_profile_phase phases);
+        ]
+      )
+  )
+
+let () =
+  Framework.Output.Json.register_section "c_parser_profile" (fun () ->
+      if !C_profile.enabled then Some (render_profile ()) else None
+    )
+
+(** Save the profiled phases as complete events of the Chrome trace
+    format, with one track per parsing thread *)
+let export_profile_trace file =
+  let events = List.of_seq (Queue.to_seq C_profile.events) in
+  let t0 = List.fold_left (fun acc e -> min acc e.C_profile.ev_start) infinity events in
+  let us t = `Int (int_of_float (t *. 1e6)) in
+  let render (e:C_profile.event) =
+    let open C_profile in
+    `Assoc [
+      "name", `String e.ev_phase;
+      "cat", `String "c-parser";
+      "ph", `String "X";
+      "ts", us (e.ev_start -. t0);
+      "dur", us e.ev_wall;
+      "pid", `Int 1;
+      "tid", `Int e.ev_thread;
+      "args", `Assoc [
+        "translation_unit", `String e.ev_tu;
+        "ocaml_words", `Float e.ev_words;
+        "clang_mem", `Float e.ev_clang_mem;
+      ];
+    ]
+  in
+  Yojson.Basic.to_file file (`Assoc [
+      "traceEvents", `List (List.map render events);
+      "displayTimeUnit", `String "ms";
+    ])
+
+
+
 (** {2 Contexts} *)
 (** ============ *)
 
@@ -251,24 +384,46 @@ let rec parse_program (files: string list) =
   let target = !Ast.target_info in
   Mopsa_c_stubs_parser.Cst.target_info := target;
   let ctx = Clang_to_C.create_context "project" target in
+  Clang_parser.set_stub_comments_only !opt_stub_comments_only;
+  C_profile.enabled := !opt_profile_parser || !opt_profile_parser_trace <> "";
   let nb = List.length files in
   input_files := [];
+  if !opt_pch then
+    Clang_pch.init (List.filter (fun f -> List.mem (Filename.extension f) [".c"; ".h"; ".i"; ".cpp"; ".cc"; ".c++"]) files);
+  if !opt_pch && !opt_parse_threads > 1 then
+    warn "-c-parse-threads is ignored with -c-pch, source files are parsed one by one";
+  let is_c_source f = List.mem (Filename.extension f) [".c"; ".h"; ".i"] in
   let () =
     try
-      ListExt.iteri
-        (fun i file ->
-          match file, Filename.extension file with
-          | _, (".c" | ".h" | ".i") -> parse_file "clang" ~nb:(i,nb) [] file false false ctx
-          | _, (".cpp" | ".cc" | ".c++") -> parse_file "clang++" ~nb:(i,nb) [] file false true ctx
-          | _, ".db" | ".db", _ -> parse_db file ctx
-          | _, x -> Exceptions.panic "unknown C extension %s" x
-        ) files;
+      (* Consecutive C files are parsed in batches, sharing the file caches
+         of Clang *)
+      let rec iter i = function
+        | [] -> ()
+        | file :: _ as l when is_c_source file ->
+          let group, rest = span_batch is_c_source l in
+          let results = parse_group "clang" (List.map (fun f -> f, []) group) false in
+          List.combine group results |>
+          List.iteri (fun k (file, result) ->
+              parse_file "clang" ~nb:(i+k,nb) ?result [] file false false ctx
+            );
+          iter (i + List.length group) rest
+        | file :: rest ->
+          begin match file, Filename.extension file with
+            | _, (".cpp" | ".cc" | ".c++") -> parse_file "clang++" ~nb:(i,nb) [] file false true ctx
+            | _, ".db" | ".db", _ -> parse_db file ctx
+            | _, x -> Exceptions.panic "unknown C extension %s" x
+          end;
+          iter (i + 1) rest
+      in
+      iter 0 files
     with Exceptions.SyntaxErrorList es ->
       panic "Parsing error raised:@.%a" (Format.pp_print_list ~pp_sep:(fun fmt () -> Format.fprintf fmt "@.") (fun fmt (range, msg) -> Format.fprintf fmt "%a: %s" pp_range range msg)) es in
-  let () = parse_stubs ctx () in
-  let prj = Clang_to_C.link_project ctx in
+  let () = C_profile.phase "<stubs>" "stub-files" (parse_stubs ctx) in
+  let prj = C_profile.phase "<project>" "link-project" (fun () -> Clang_to_C.link_project ctx) in
+  let prog_kind = C_profile.phase "<project>" "translate-project" (fun () -> from_project prj) in
+  if !opt_profile_parser_trace <> "" then export_profile_trace !opt_profile_parser_trace;
   {
-    prog_kind = from_project prj;
+    prog_kind;
     prog_range = mk_program_range files;
   }
 
@@ -317,39 +472,87 @@ and parse_db (dbfile: string) ctx : unit =
       get_executable_sources db exec in
   let nb = List.length srcs in
   input_files := [];
+  if !opt_pch then
+    Clang_pch.init (List.map (fun src ->
+        if Filename.is_relative src.source_path then Filename.concat src.source_cwd src.source_path
+        else src.source_path
+      ) srcs);
   let cwd = Sys.getcwd() in
-  ListExt.iteri
-    (fun i src ->
-       match src.source_kind with
-       | SOURCE_C | SOURCE_CXX ->
-         let cmd = if src.source_kind = SOURCE_C then "clang" else "clang++" in
-         (* parse file in the original compilation directory *)
-         Sys.chdir src.source_cwd;
-         parse_file cmd ~nb:(i,nb) src.source_opts src.source_path !opt_enable_cache (src.source_kind=SOURCE_CXX) ctx;
-
-       | _ -> if !opt_warn_all then warn "ignoring file %s" src.source_path
-    ) srcs;
+  (* Consecutive sources compiled with the same command in the same
+     directory are parsed in batches, sharing the file caches of Clang *)
+  let rec iter = function
+    | [] -> ()
+    | (_, src) :: _ as l when src.source_kind = SOURCE_C || src.source_kind = SOURCE_CXX ->
+      let group, rest =
+        span_batch (fun (_, src') ->
+            src'.source_kind = src.source_kind &&
+            src'.source_cwd = src.source_cwd) l
+      in
+      let cmd = if src.source_kind = SOURCE_C then "clang" else "clang++" in
+      (* parse file in the original compilation directory *)
+      Sys.chdir src.source_cwd;
+      let results =
+        parse_group cmd (List.map (fun (_, src) -> src.source_path, src.source_opts) group) !opt_enable_cache
+      in
+      List.iter2 (fun (i, src) result ->
+          parse_file cmd ~nb:(i,nb) ?result src.source_opts src.source_path !opt_enable_cache (src.source_kind=SOURCE_CXX) ctx
+        ) group results;
+      iter rest
+
+    | (_, src) :: rest ->
+      if !opt_warn_all then warn "ignoring file %s" src.source_path;
+      iter rest
+  in
+  iter (ListExt.mapi (fun i src -> i, src) srcs);
   (* make sure we get back to cwd in all cases *)
   Sys.chdir cwd
 
-and parse_file (cmd: string) ?nb ?(stub=false) (opts: string list) (file: string) enable_cache ignore ctx =
-  if not (Sys.file_exists file) then panic "file %s not found" file;
-  debug "parsing file %s" file;
+(** Split the longest prefix of [l] whose elements satisfy [f] and that
+    fits in a batch. The parse results of a batch are kept alive until
+    they are translated, so batches are bounded. *)
+and span_batch : 'a. ('a -> bool) -> 'a list -> 'a list * 'a list = fun f l ->
+  let batch_size = max 16 (4 * !opt_parse_threads) in
+  let rec aux k = function
+    | x :: tl when k < batch_size && f x ->
+      let l1, l2 = aux (k + 1) tl in
+      x :: l1, l2
+    | l -> [], l
+  in
+  aux 0 l
+
+(** Parse a group of source files, given with their options, in one batch.
+    [None] is returned for files that should be parsed alone by
+    [parse_file], i.e. when the group has a single file, when a file is
+    missing, or when precompiled headers are enabled, as they are selected
+    per file. *)
+and parse_group cmd (group:(string * string list) list) enable_cache : Clang_parser.parse_result option list =
+  if !opt_pch || List.length group < 2 || not (List.for_all (fun (file, _) -> Sys.file_exists file) group) then
+    List.map (fun _ -> None) group
+  else
+    C_parser.parse_batch cmd (List.map (fun (file, opts) -> file, clang_options opts) group)
+      !opt_target_triple enable_cache !opt_parse_threads |>
+    List.map (fun r -> Some r)
+
+and clang_options (opts: string list) : string list =
   (* clang does not like -MT and -MD options *)
   let opts = List.filter (fun x -> x != "-MT" && x != "-MD") opts in
-  let opts' = ("-I" ^ (Paths.resolve_stub "c" "mopsa")) ::
-              ("-include" ^ "mopsa.h") ::
-              "-Wall" ::
-              "-Qunused-arguments"::
-              (List.map (fun dir -> "-I" ^ dir) !opt_include_dirs) @
-              opts @
-              !opt_clang
-  in
+  ("-I" ^ (Paths.resolve_stub "c" "mopsa")) ::
+  ("-include" ^ "mopsa.h") ::
+  "-Wall" ::
+  "-Qunused-arguments"::
+  (List.map (fun dir -> "-I" ^ dir) !opt_include_dirs) @
+  opts @
+  !opt_clang
+
+and parse_file (cmd: string) ?nb ?(stub=false) ?result (opts: string list) (file: string) enable_cache ignore ctx =
+  if not (Sys.file_exists file) then panic "file %s not found" file;
+  debug "parsing file %s" file;
+  let opts' = clang_options opts in
   input_files := file :: !input_files;
   (* if adding a stub file, keep all static functions as they may be used
      by stub annotations
    *)
-  C_parser.parse_file cmd file opts' !opt_target_triple !opt_warn_all enable_cache stub (ignore || is_ignored_translation_unit file) ctx
+  C_parser.parse_file cmd ?result file opts' !opt_target_triple !opt_warn_all enable_cache stub (ignore || is_ignored_translation_unit file) ctx
 
 
 and parse_stubs ctx () =
@@ -398,6 +601,11 @@ and parse_stubs ctx () =
 
 
 and from_project prj =
+  let prj =
+    if !opt_reachable_only
+    then C_profile.phase "<project>" "reachability" (fun () -> restrict_to_reachable prj)
+    else prj
+  in
   (* Preliminary parsing of functions *)
   let funcs_and_origins =
     StringMap.bindings prj.proj_funcs |>
@@ -426,6 +634,26 @@ and from_project prj =
     }
   in
 
+  (* Parse the stub comments of functions and directives in parallel *)
+  C_profile.phase "<stubs>" "stub-prefetch" (fun () ->
+      let open Mopsa_c_stubs_parser.Main in
+      let func_coms =
+        funcs_and_origins |> List.filter_map (fun (_, o) ->
+            if o.func_body = None || List.mem o.func_org_name !opt_use_stub
+            then List.find_opt is_stub_comment o.func_com
+            else None
+          )
+      in
+      let directive_coms =
+        C_AST.RangeMap.fold (fun _ com acc ->
+            match List.find_opt is_directive_comment com with
+            | Some c -> c :: acc
+            | None -> acc
+          ) prj.proj_comments []
+      in
+      prefetch_comments ~jobs:!opt_stub_jobs (func_coms @ directive_coms) ctx.ctx_predicates ctx.ctx_enums
+    );
+
   (* Parse functions *)
   List.iter (fun (f, o) ->
       debug "parsing function %s" o.func_org_name;
@@ -461,6 +689,40 @@ and from_project prj =
   }
 
 
+(** Restrict the functions of a project to the ones reachable from the
+    entry function, the initializers of globals, the stub directives and
+    the [_mopsa_] helpers called by the analyzer. Functions named in the
+    stub of a reachable function are reachable too. *)
+and restrict_to_reachable prj =
+  let open Mopsa_c_stubs_parser.Main in
+  let funcs = StringMap.bindings prj.proj_funcs |> List.map snd in
+  let by_name = Hashtbl.create 16 in
+  List.iter (fun f -> Hashtbl.add by_name f.func_org_name f) funcs;
+  let named ids = List.concat_map (Hashtbl.find_all by_name) ids in
+  let stub_refs coms = List.concat_map (fun (com,macros) -> named (comment_identifiers com macros)) coms in
+  match Hashtbl.find_all by_name !opt_entry_function with
+  | [] ->
+    warn "entry function %s not found, translating all functions" !opt_entry_function;
+    prj
+  | entry ->
+    let globals = ref [] in
+    StringMap.iter (fun _ v -> C_utils.iter_funcs_var (fun f -> globals := f :: !globals) v) prj.proj_vars;
+    let helpers = List.filter (fun f -> String.starts_with ~prefix:"_mopsa_" f.func_org_name) funcs in
+    let directives =
+      C_AST.RangeMap.fold (fun _ com acc ->
+          stub_refs (List.filter is_directive_comment com) @ acc
+        ) prj.proj_comments []
+    in
+    let reachable =
+      C_utils.reachable_functions
+        (entry @ !globals @ helpers @ directives)
+        (fun f -> stub_refs (List.filter is_stub_comment f.func_com))
+    in
+    let n = StringMap.cardinal prj.proj_funcs and m = StringMap.cardinal reachable in
+    Debug.info "translating %d reachable function%a out of %d (%d skipped)" m Debug.plurial_int m n (n - m);
+    { prj with proj_funcs = reachable }
+
+
 and find_target target targets =
   let re = Str.regexp (".*" ^ target ^ "$") in
   let search_targets r =
@@ -880,19 +1142,15 @@ and under_type t =
 (** ======================== *)
 
 and from_range (range:C_AST.range) =
-  let open Clang_AST in
   let open Location in
-  mk_orig_range
-    {
-      pos_file = range.range_begin.loc_file;
-      pos_line = range.range_begin.loc_line;
-      pos_column = range.range_begin.loc_column;
-    }
+  let from_loc l =
     {
-      pos_file = range.range_end.loc_file;
-      pos_line = range.range_end.loc_line;
-      pos_column = range.range_end.loc_column;
+      pos_file = Clang_utils.loc_file l;
+      pos_line = Clang_utils.loc_line l;
+      pos_column = Clang_utils.loc_column l;
     }
+  in
+  mk_orig_range (from_loc range.range_begin) (from_loc range.range_end)
 
 
 
@@ -901,11 +1159,15 @@ and from_range (range:C_AST.range) =
 
 and from_stub_comment ctx f =
   try
-    let stub = Mopsa_c_stubs_parser.Main.parse_function_comment f
-          ctx.ctx_prj
-          ctx.ctx_enums
-          ctx.ctx_predicates
-          ctx.ctx_stubs in
+    let stub =
+      C_profile.phase "<stubs>" "stub-comments" (fun () ->
+          Mopsa_c_stubs_parser.Main.parse_function_comment f
+            ctx.ctx_prj
+            ctx.ctx_enums
+            ctx.ctx_predicates
+            ctx.ctx_stubs
+        )
+    in
     Some (from_stub_func ctx f stub)
   with Mopsa_c_stubs_parser.Main.StubNotFound ->
     None
@@ -1087,13 +1349,16 @@ and from_stub_expr_unop = function
 and from_stub_directives ctx com_map =
   C_AST.RangeMap.fold (fun range com acc ->
       try
-        let stub = Mopsa_c_stubs_parser.Main.parse_directive_comment
-            com
-            range
-            ctx.ctx_prj
-            ctx.ctx_enums
-            ctx.ctx_predicates
-            ctx.ctx_stubs
+        let stub =
+          C_profile.phase "<stubs>" "stub-comments" (fun () ->
+              Mopsa_c_stubs_parser.Main.parse_directive_comment
+                com
+                range
+                ctx.ctx_prj
+                ctx.ctx_enums
+                ctx.ctx_predicates
+                ctx.ctx_stubs
+            )
         in
         from_stub_directive ctx stub :: acc
       with Mopsa_c_stubs_parser.Main.StubNotFound -> acc
@@ -1110,7 +1375,7 @@ and from_stub_directive ctx stub =
 
 and from_stub_predicates com_map =
   C_AST.RangeMap.fold (fun range com acc ->
-      Mopsa_c_stubs_parser.Main.parse_predicates_comment com |>
+      C_profile.phase "<stubs>" "stub-comments" (fun () -> Mopsa_c_stubs_parser.Main.parse_predicates_comment com) |>
       List.fold_left
         (fun acc pred ->
            let name = pred.Mopsa_c_stubs_parser.Passes.Preprocessor.pred_name in
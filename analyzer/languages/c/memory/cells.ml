@@ -306,6 +306,66 @@ struct
     else mk_c_cast (mk_var v ~mode range) typ range
 
 
+  (** {2 Summaries of smashed bases} *)
+  (** ****************************** *)
+
+  (** When a base is smashed, its cells are replaced by one weak summary
+      variable per cell type *)
+  type var_kind +=
+    | V_c_cell_summary of base * cell_typ
+
+  let pp_summary fmt (b,t) =
+    Format.fprintf fmt "⟪%a,%a⟫" pp_base b pp_cell_typ t
+
+  let compare_summary (b1,t1) (b2,t2) =
+    Compare.compose [
+      (fun () -> compare_base b1 b2);
+      (fun () -> compare_cell_typ t1 t2);
+    ]
+
+  let () =
+    register_var {
+
+      print = (fun next fmt v ->
+          match v.vkind with
+          | V_c_cell_summary (b,t) -> pp_summary fmt (b,t)
+          | _ -> next fmt v
+        );
+
+      compare = (fun next v1 v2 ->
+          match v1.vkind, v2.vkind with
+          | V_c_cell_summary (b1,t1), V_c_cell_summary (b2,t2) ->
+            compare_summary (b1,t1) (b2,t2)
+          | _ -> next v1 v2
+        );
+    }
+
+  let summary_type t =
+    match t with
+    | Numeric t -> t
+    | Pointer -> T_c_pointer T_c_void
+
+  (** Create the summary variable of cells of type [t] in base [b] *)
+  let mk_summary_var b t : var =
+    let name =
+      let () =
+        Format.fprintf Format.str_formatter "⟪%s,%a⟫"
+          (base_uniq_name b)
+          pp_cell_typ t
+      in
+      Format.flush_str_formatter ()
+    in
+    mkv name (V_c_cell_summary (b,t)) (summary_type t) ~mode:WEAK ~semantic:"C/Scalar"
+
+  (** Create an expression reading the summary of type [t] in base [b] as
+      a value of type [typ] *)
+  let mk_summary_var_expr b t typ range : expr =
+    let v = mk_var (mk_summary_var b t) range in
+    if compare_typ (summary_type t) (remove_typedef_qual typ) = 0
+    then v
+    else mk_c_cast v typ range
+
+
 
   (** {2 Cell sets} *)
   (** ************* *)
@@ -367,15 +427,30 @@ struct
       (b:Base.t) (lo:Z.t) (hi:Z.t) (m:CellSet.t) : cell list =
     cell_set_fold_range (fun (c:cell) (l:cell list) -> if f c then c::l else l) b lo hi m []
 
+  (** Folds the cells of base [b] that overlap the offset range [lo],
+      [hi] (bounds included). Since offsets are kept sorted in a balanced
+      map, the candidates are found with a single slice starting at the
+      first offset from which a cell can reach [lo]. The cost is
+      logarithmic in the number of offsets of the base, plus the size of
+      the slice.
+  *)
+  let cell_set_fold_overlapping_range
+      (f:cell -> 'a -> 'a)
+      (b:Base.t) (lo:Z.t) (hi:Z.t) (m:CellSet.t)
+      (acc:'a) : 'a =
+    cell_set_fold_range
+      (fun c acc -> if lo < Z.add c.offset (sizeof_cell c) then f c acc else acc)
+      b (Z.sub lo (Z.pred max_sizeof_cell)) hi m acc
+
   (** Returns the cells satisfying [f] only considering cells that overlap
       an offset range [lo], [hi] included.
   *)
   let cell_set_filter_overlapping_range
       (f:cell -> bool)
       (b:Base.t) (lo:Z.t) (hi:Z.t) (m:CellSet.t) : cell list =
-    cell_set_filter_range
-      (fun c -> c.offset  <= hi && lo < Z.add c.offset (sizeof_cell c) && f c)
-      b (Z.sub lo max_sizeof_cell) hi m
+    cell_set_fold_overlapping_range
+      (fun c l -> if f c then c :: l else l)
+      b lo hi m []
 
   (** Returns the cells satisfying [f] only considering cells that overlap
       [c] (including [c] itself, if it is in the map).
@@ -411,6 +486,10 @@ struct
       (fun _ s l -> Cells.fold (fun c l -> c :: l) s l)
       (CellSet.find b m) []
 
+  (** Cells of a base, moved to base [b'] *)
+  let rebase_cells (b':Base.t) (cells:OffCells.t) : OffCells.t =
+    OffCells.map (Cells.map (fun c -> { c with base = b' })) cells
+
 
 
   (** {2 Domain header} *)
@@ -422,20 +501,34 @@ struct
   module BaseSet = Framework.Lattices.Powerset.Make(Base)
 
 
+  (** Set of summaries of smashed bases *)
+  module SummarySet = Framework.Lattices.Powerset.Make(struct
+      type t = base * cell_typ
+      let compare = compare_summary
+      let print = unformat pp_summary
+    end)
+
+
   (** Abstract state *)
   type t = {
     cells: CellSet.t;
     bases: BaseSet.t;
+    smashed: BaseSet.t;       (** bases whose cells have been summarized *)
+    summaries: SummarySet.t;  (** summaries of smashed bases *)
   }
 
   let bottom = {
     cells = CellSet.bottom;
     bases = BaseSet.bottom;
+    smashed = BaseSet.bottom;
+    summaries = SummarySet.bottom;
   }
 
   let top = {
     cells = CellSet.top;
     bases = BaseSet.top;
+    smashed = BaseSet.top;
+    summaries = SummarySet.top;
   }
 
 
@@ -475,6 +568,17 @@ struct
       default = "";
     }
 
+  (** Maximal number of cells in a base before smashing it *)
+  let opt_smash_threshold = ref 0
+  let () =
+    register_domain_option name {
+      key = "-cell-smash-threshold";
+      category = "C";
+      doc = " maximal number of cells in a base before summarizing it into one weak cell per type (0 for no limit)";
+      spec = ArgExt.Set_int opt_smash_threshold;
+      default = "0";
+    }
+
 
   (** {2 Unification of cells} *)
   (** ======================== *)
@@ -590,8 +694,142 @@ struct
 
   let is_optional_base b a = not (BaseSet.mem b a.bases)
 
+  (** {2 Adaptive smashing} *)
+  (** ====================== *)
+
+  (** Smashed bases already reported to the user during the current
+      analysis *)
+  let reported_smashed_bases : (string, unit) Hashtbl.t = Hashtbl.create 16
+
+  let is_scalar_var_base b =
+    match b.base_kind with
+    | Var v -> is_c_scalar_type v.vtyp
+    | _ -> false
+
+  let is_smashed_base b a = BaseSet.mem b a.smashed
+
+  (** Number of cells in base [b]. Counting stops once [limit] cells are
+      found, so that checks done at each write do not traverse whole
+      bases. *)
+  let count_base_cells ?(limit=max_int) b a =
+    let exception Limit of int in
+    try
+      OffCells.fold (fun _ s n ->
+          let n = n + Cells.cardinal s in
+          if n >= limit then raise (Limit n) else n
+        ) (CellSet.find b a.cells) 0
+    with Limit n -> n
+
+  (** Check whether base [b] has more cells than the smashing threshold,
+      once [fresh] new cells are added to it *)
+  let exceeds_smash_threshold ?(fresh=Z.zero) b a =
+    !opt_smash_threshold > 0 &&
+    not (is_scalar_var_base b) &&
+    let n = count_base_cells ~limit:(!opt_smash_threshold + 1) b a in
+    Z.(of_int n + fresh > of_int !opt_smash_threshold)
+
+  (** Summarize the cells of base [b] into one weak summary variable per
+      cell type. A summary is created only when the cells of its type
+      cover the whole base, so that any read of this type in [b] is
+      over-approximated by the summary. Reading other types gives ⊤. *)
+  let summarize_base b range man flow =
+    let a = get_env T_cur man flow in
+    let cells = cell_set_find_base b a.cells in
+    let flow = set_env T_cur { a with cells = CellSet.remove b a.cells;
+                                      smashed = BaseSet.add b a.smashed } man flow in
+    eval_base_size b range man flow >>$ fun size flow ->
+    let size =
+      match Itv.bounds_opt (man.ask (mk_int_interval_query size) flow) with
+      | Some l, Some u when Z.equal l u -> Some l
+      | _ -> None
+    in
+    (* Cells of type t, if they cover the base *)
+    let covering t =
+      match size with
+      | None -> []
+      | Some size ->
+        let elm = sizeof_type (summary_type t) in
+        let cl = List.filter (fun c -> compare_cell_typ c.typ t = 0) cells in
+        if Z.(rem size elm = zero) &&
+           List.for_all (fun c -> Z.(rem c.offset elm = zero && c.offset + elm <= size)) cl &&
+           Z.(of_int (List.length cl) = div size elm)
+        then cl
+        else []
+    in
+    let types = List.sort_uniq compare_cell_typ (List.map (fun c -> c.typ) cells) in
+    (* Create the summaries and populate them with the values of cells *)
+    List.fold_left (fun acc t ->
+        match covering t with
+        | [] -> acc
+        | hd :: tl ->
+          acc >>% fun flow ->
+          let v = mk_summary_var b t in
+          let flow = map_env T_cur (fun a -> { a with summaries = SummarySet.add (b,t) a.summaries }) man flow in
+          man.exec (mk_add_var v range) ~route:scalar flow >>%
+          man.exec (mk_assign (mk_var v ~mode:(Some STRONG) range) (mk_var (mk_cell_var hd) range) range) ~route:scalar >>% fun flow ->
+          List.fold_left (fun acc c ->
+              Post.bind (man.exec (mk_assign (mk_var v range) (mk_var (mk_cell_var c) range) range) ~route:scalar) acc
+            ) (Post.return flow) tl
+      ) (Post.return flow) types
+    >>% fun flow ->
+    (* Remove the cells *)
+    List.fold_left (fun acc c ->
+        Post.bind (man.exec (mk_remove_var (mk_cell_var c) range) ~route:scalar) acc
+      ) (Post.return flow) cells
+
+  (** Smash base [b] when a write exceeds the threshold *)
+  let smash_base b range man flow =
+    let name = base_uniq_name b in
+    if not (Hashtbl.mem reported_smashed_bases name) then (
+      Hashtbl.add reported_smashed_bases name ();
+      warn_at range "base %a summarized after reaching %d cells" pp_base b (count_base_cells b (get_env T_cur man flow))
+    );
+    summarize_base b range man flow
+
+  (** Summaries of base [b] *)
+  let find_summaries b a =
+    SummarySet.filter (fun (b',_) -> compare_base b b' = 0) a.summaries |>
+    SummarySet.elements
+
+  (** Remove the summaries of base [b] satisfying [f] *)
+  let remove_summaries ?(f=fun _ -> true) b range man flow =
+    let a = get_env T_cur man flow in
+    let l = List.filter (fun (_,t) -> f t) (find_summaries b a) in
+    let flow = set_env T_cur { a with summaries = List.fold_left (fun s x -> SummarySet.remove x s) a.summaries l } man flow in
+    List.fold_left (fun acc (b,t) ->
+        Post.bind (man.exec (mk_remove_var (mk_summary_var b t) range) ~route:scalar) acc
+      ) (Post.return flow) l
+
+  (** Make bases smashed in one state also smashed in the other one, and
+      keep only their common summaries. Bases are smashed by writes only:
+      here, the cells of the other state are just summarized in the same
+      way, silently. *)
+  let unify_smashed man sman ctx (a,s) (a',s') =
+    let smash_missing a s a' s' =
+      BaseSet.fold (fun b (a',s') ->
+          if is_smashed_base b a' then (a',s')
+          else sub_env_exec (summarize_base b unify_range man) ctx man sman a' s'
+        ) (BaseSet.diff a.smashed a'.smashed) (a',s')
+    in
+    let a', s' = smash_missing a s a' s' in
+    let a, s = smash_missing a' s' a s in
+    let remove_missing a s a' =
+      SummarySet.fold (fun (b,t) (a,s) ->
+          sub_env_exec (remove_summaries ~f:(fun t' -> compare_cell_typ t t' = 0) b unify_range man) ctx man sman a s
+        ) (SummarySet.diff a.summaries a'.summaries) (a,s)
+    in
+    let a, s = remove_missing a s a' in
+    let a', s' = remove_missing a' s' a in
+    (a,s), (a',s')
+
+
   (** [unify a a'] finds non-common cells in [a] and [a'] and adds them. *)
   let unify man sman ctx (a,s) (a',s') =
+    let (a,s), (a',s') =
+      if BaseSet.equal a.smashed a'.smashed && SummarySet.equal a.summaries a'.summaries
+      then (a,s), (a',s')
+      else unify_smashed man sman ctx (a,s) (a',s')
+    in
     let doit ss aa acc =
       Cells.fold
         (fun c acc ->
@@ -624,7 +862,8 @@ struct
            )
            m1 m2 acc
       )
-      a.cells a'.cells (s,s')
+      a.cells a'.cells (s,s') |>
+    fun (s,s') -> (a,s), (a',s')
 
 
   (** {2 Lattice operators} *)
@@ -633,14 +872,16 @@ struct
   let is_bottom _ = false
 
   let subset man sman ctx (a,s) (a',s') =
-    let s, s' = unify man sman ctx (a, s) (a', s') in
+    let (_,s), (_,s') = unify man sman ctx (a, s) (a', s') in
     (true, s, s')
 
   let join man sman ctx (a,s) (a',s') =
-    let s, s' = unify man sman ctx (a,s) (a',s') in
+    let (a,s), (a',s') = unify man sman ctx (a,s) (a',s') in
     let a = {
       cells = CellSet.join a.cells a'.cells;
       bases = BaseSet.join a.bases a'.bases;
+      smashed = BaseSet.join a.smashed a'.smashed;
+      summaries = SummarySet.meet a.summaries a'.summaries;
     }
     in
     (a, s, s')
@@ -662,6 +903,7 @@ struct
   type expansion =
     | Cell of cell * mode option
     | Region of base * Z.t (** offset lower bound *) * Z.t (** offset higher bound *) * Z.t (** offset step *)
+    | Smashed of base * expr (** offset *)
     | Top
 
   let pp_expansion fmt = function
@@ -669,6 +911,8 @@ struct
        Format.fprintf fmt "Cell(%a, %a)" pp_cell c (OptionExt.print pp_mode) om
     | Region (b, l, u, s) ->
        Format.fprintf fmt "Region(%a, %a, %a, %a)" pp_base b Z.pp_print l Z.pp_print u Z.pp_print s
+    | Smashed (b, o) ->
+       Format.fprintf fmt "Smashed(%a, %a)" pp_base b pp_expr o
     | Top -> Format.fprintf fmt "T"
 
 
@@ -692,13 +936,19 @@ struct
       (* UNSOUND: If we cannot resolve a pointer, we continue with [None] (similar to [P_top]) instead of failing. *)
       Cases.singleton None flow
 
-  (** Expand a pointer dereference into a cell. *)
-  let expand p range man flow : ('a, expansion) cases =
+  (** Expand a pointer dereference into a cell. When [smash] is set, i.e.
+      for writes, a base that would exceed the smashing threshold to
+      represent a write to a range of offsets is summarized. Writes to
+      single cells are checked after the assignment, see [exec_assign]. *)
+  let expand ?(smash=false) p range man flow : ('a, expansion) cases =
     eval_pointed_base_offset p range man flow >>$ fun pp flow ->
     match pp with
     | None ->
       Cases.singleton Top flow
 
+    | Some (base,offset,mode) when is_smashed_base base (get_env T_cur man flow) ->
+      Cases.singleton (Smashed (base,offset)) flow
+
     | Some (base,offset,mode) ->
       let typ = under_type p.etyp |> void_to_char in
       let elm = sizeof_type typ in
@@ -742,6 +992,22 @@ struct
           (* guanranteed to be out of bounds, we set the location to top *)
           let region = Region (base, Z.zero, Z.sub us elm,step) in
             Cases.singleton region flow
+        else if smash
+             && nb > Z.of_int !opt_deref_expand
+             && is_interesting_base base
+             && (let a = get_env T_cur man flow in
+                 (* Cells needed to represent the write precisely *)
+                 let ct = (mk_cell base lo typ).typ in
+                 let existing =
+                   cell_set_fold_range (fun c n ->
+                       if compare_cell_typ c.typ ct = 0 && Z.(rem (c.offset - lo) step = zero) then n + 1 else n
+                     ) base lo uo a.cells 0
+                 in
+                 exceeds_smash_threshold ~fresh:Z.(nb - of_int existing) base a)
+        then
+          (* too many cells for the base -> summarize it *)
+          smash_base base range man flow >>% fun flow ->
+          Cases.singleton (Smashed (base,offset)) flow
         else if nb > Z.of_int !opt_deref_expand || not (is_interesting_base base) then
           (* too many cases -> top *)
           let region = Region (base, lo, uo ,step) in
@@ -833,30 +1099,20 @@ struct
   (** Remove cells overlapping with cell [c] *)
   let remove_cell_overlappings c range man flow =
     let a = get_env T_cur man flow in
-    let overlappings = cell_set_find_overlapping_cell c a.cells in
-    List.fold_left (fun acc c' ->
-        Post.bind (remove_cell c' range man) acc
-      ) (Post.return flow) overlappings
+    cell_set_fold_overlapping_range
+      (fun c' acc ->
+         if compare_cell c c' = 0 then acc
+         else Post.bind (remove_cell c' range man) acc
+      ) c.base c.offset (Z.pred (Z.add c.offset (sizeof_cell c))) a.cells
+      (Post.return flow)
 
 
-  (** Remove cells overlapping with cell [c] *)
+  (** Remove cells overlapping with the region [lo], [hi] of [base] *)
   let remove_region_overlappings base lo hi step range man flow =
     let a = get_env T_cur man flow in
-    let overlappings = cell_set_filter_overlapping_range (fun _ -> true) base lo hi a.cells in
-    List.fold_left (fun acc c' ->
-        Post.bind (remove_cell c' range man) acc
-      ) (Post.return flow) overlappings
-
-
-  let rename_cell c1 c2 range man flow =
-    let v1 = mk_cell_var c1 in
-    let v2 = mk_cell_var c2 in
-    let flow = map_env T_cur (fun a ->
-        { a with cells = cell_set_remove c1 a.cells |>
-                         cell_set_add c2 }
-      ) man flow in
-    let stmt = mk_rename_var v1 v2 range in
-    man.exec ~route:scalar stmt flow
+    cell_set_fold_overlapping_range
+      (fun c' acc -> Post.bind (remove_cell c' range man) acc)
+      base lo hi a.cells (Post.return flow)
 
 
   let assign_cell c e mode range man flow =
@@ -881,16 +1137,30 @@ struct
       remove_region_overlappings base lo hi step range man flow
 
 
-  let expand_cell c cl range man flow =
-    (* Add cells in cl to the state *)
-    let flow = map_env T_cur (fun a ->
-        { a with cells = List.fold_left (fun s c -> cell_set_add c s) a.cells cl; }
-      ) man flow in
-    (* Expand cell variables *)
-    let v = mk_cell_var c in
-    let vl = List.map mk_cell_var cl in
-    let stmt = mk_expand_var v vl range in
-    man.exec stmt ~route:scalar flow
+  (** Weak update of the summary of a smashed base. Summaries of other
+      types, or of the same type when the offset is not aligned, no longer
+      over-approximate the contents of the base and are removed. An aligned
+      write of a type without summary creates it with value ⊤, as the
+      other elements of this type are unknown. *)
+  let assign_summary base offset typ e range man flow =
+    let ct = (mk_cell base Z.zero typ).typ in
+    let aligned = Quantified_offset.is_aligned offset (sizeof_type typ) man flow in
+    remove_summaries ~f:(fun t -> compare_cell_typ t ct <> 0 || not aligned) base range man flow >>% fun flow ->
+    if not aligned then
+      man.eval e flow >>$ fun _ flow ->
+      Post.return flow
+    else
+      let v = mk_summary_var base ct in
+      begin
+        if SummarySet.mem (base,ct) (get_env T_cur man flow).summaries then Post.return flow
+        else
+          let flow = map_env T_cur (fun a -> { a with summaries = SummarySet.add (base,ct) a.summaries }) man flow in
+          man.exec (mk_add_var v range) ~route:scalar flow >>%
+          man.exec (mk_havoc_var v (summary_type ct) range) ~route:scalar
+      end
+      >>% fun flow ->
+      man.exec (mk_assign (mk_var v range) e range) ~route:scalar flow
+
 
   let fold_cells c cl range man flow =
     let flow = map_env T_cur (fun a ->
@@ -921,7 +1191,13 @@ struct
   (** ***************** *)
 
   let init prog man flow =
-    set_env T_cur { cells = CellSet.empty; bases = BaseSet.empty } man flow
+    Hashtbl.reset reported_smashed_bases;
+    set_env T_cur {
+      cells = CellSet.empty;
+      bases = BaseSet.empty;
+      smashed = BaseSet.empty;
+      summaries = SummarySet.empty;
+    } man flow
 
 
   (** {2 Abstract evaluations} *)
@@ -940,6 +1216,16 @@ struct
       smash_region base lo hi step t range man flow >>$ fun ret flow ->
       man.eval ret flow ~route:scalar
 
+    | Smashed (base,offset) ->
+      let ct = (mk_cell base Z.zero (void_to_char t)).typ in
+      (* Summaries cover the aligned elements of their type only *)
+      if SummarySet.mem (base,ct) (get_env T_cur man flow).summaries
+      && Quantified_offset.is_aligned offset (sizeof_type (void_to_char t)) man flow
+      then
+        man.eval (mk_summary_var_expr base ct (void_to_char t) range) flow ~route:scalar
+      else
+        man.eval (mk_top (void_to_char t) range) flow
+
     | Cell (c,mode) ->
       add_cell c range man flow >>% fun flow ->
       let v =
@@ -965,39 +1251,135 @@ struct
   let assume_exists_ne2 i a b base1 offset1 mode1 ctype1 base2 offset2 mode2 ctyp2 range man flow =
     Post.return flow
 
+  (** Value of a quantified offset expression, when it is constant *)
+  let constant_offset e range man flow =
+    match offset_interval e range man flow with
+    | Nb (Finite l, Finite u) when Z.equal l u -> Some l
+    | _ -> None
+
+  (** Lower bound of a quantified offset expression *)
+  let min_offset e range man flow =
+    match offset_interval e range man flow with
+    | Nb (Finite l, _) -> Some l
+    | _ -> None
+
+  (** Byte range [lo, hi] that is written in all executions by an
+      assignment of cells of size [elm] at quantified offset [offset] *)
+  let quantified_block i a b offset elm range man flow =
+    let lo, hi = Quantified_offset.bound offset [FORALL,i,S_interval(a,b)] in
+    match constant_offset lo range man flow, min_offset hi range man flow with
+    | Some lo, Some hi when Z.(hi >= lo) -> Some (lo, Z.(hi + elm - one))
+    | _ -> None
+
+  (** Check whether a write to [base] through a pointer of mode [mode] is a
+      strong update. Weak bases, such as recency summaries, are always
+      updated weakly. *)
+  let is_strong_write base mode =
+    base_mode base = STRONG &&
+    (match mode with None | Some STRONG -> true | Some WEAK -> false)
+
+  (** 𝕊⟦ ∀i ∈ [a,b]: *(p + i) == *(q + i) ⟧, as a block copy of q to p.
+      The cells of q lying within the copied range are copied to p
+      altogether: the cell set is updated once, and the scalar domain only
+      sees the expansion of each copied cell. When p points to a weak base,
+      the previous contents of p remain possible: existing cells of p that
+      match a copied cell are weakly updated, and the other cells
+      overlapping the range are removed. *)
   let assume_forall_eq2 i a b base1 offset1 mode1 ctype1 base2 offset2 mode2 ctype2 range man flow =
-    let itv_a = offset_interval a range man flow in
-    let itv_b = offset_interval b range man flow in
-    match itv_a, itv_b with
-    | BOT, _ | _, BOT -> Post.return flow
-    | Nb (_, itv_amax), Nb (itv_bmin, _) ->
-       let safe_itv = ItvUtils.IntItv.of_bound itv_amax itv_bmin in
-       let cur = get_env T_cur man flow in
-       let cells1 = CellSet.find base1 cur.cells in
-       let cells2 = cell_set_find_base base2 cur.cells in
-       let () = debug "assume_forall_eq2 (%a, %a, %a) (%a, %a, %a), safe_itv = %a"
-                  pp_base base1 pp_expr offset1 (OptionExt.print pp_mode) mode1
-                  pp_base base2 pp_expr offset2 (OptionExt.print pp_mode) mode2
-              ItvUtils.IntItv.fprint safe_itv
-       in
-       (* let's handle the case appearing most in stubs: copying the contents to a newly allocated memory without any cells *)
-       if OffCells.is_empty cells1 || OffCells.for_all2 (fun _ cs1 cs2 -> Cells.cardinal cs1 = 1 && Cells.cardinal cs2 = 1 && compare_cell_typ (Cells.choose cs1).typ (Cells.choose cs2).typ = 0) cells1 (CellSet.find base2 cur.cells) then
-         let () = debug "trying expansion to copy cells from %a" (Format.pp_print_list ~pp_sep:(fun fmt () -> Format.fprintf fmt ", ") pp_cell) cells2 in
-         let post =
-         List.fold_left (fun acc c2 ->
-             if ItvUtils.IntItv.contains c2.offset safe_itv then
-             (* Create the corresponding expanded cells *)
-               let c1 = {c2 with base = base1} in
-               (* FIXME: what happens if c1 exists already? *)
-               Post.bind (expand_cell c2 [c1] range man) acc
-             else
-               acc
-           ) (Post.return flow) cells2 in
-         let () = debug "copy finished" in
-         post
-       else
-         let () = debug "cells1 = %a, transfer function not implemented" (format OffCells.print) cells1 (* (format @@ man.lattice.print) (Flow.get T_cur man.lattice flow)  *) in
-         Post.return flow
+    let elm = sizeof_type ctype1 in
+    if compare_base base1 base2 = 0
+    || not (Z.equal elm (sizeof_type ctype2))
+    || is_smashed_base base1 (get_env T_cur man flow)
+    then
+      Post.return flow
+    else
+      match quantified_block i a b offset1 elm range man flow,
+            quantified_block i a b offset2 elm range man flow with
+      | Some (lo1, hi1), Some (lo2, _) ->
+        let shift = Z.sub lo2 lo1 in
+        let cur = get_env T_cur man flow in
+        let () = debug "assume_forall_eq2 %a[%a,%a] <- %a[%a,%a]"
+            pp_base base1 Z.pp_print lo1 Z.pp_print hi1
+            pp_base base2 Z.pp_print lo2 Z.pp_print (Z.add hi1 shift)
+        in
+        (* Cells of p overlapping the destination *)
+        let old = cell_set_filter_overlapping_range (fun _ -> true) base1 lo1 hi1 cur.cells in
+        (* Cells of q fully inside the source, with their copies in p *)
+        let copies =
+          cell_set_fold_range
+            (fun c acc ->
+               if Z.(c.offset + sizeof_cell c - one <= hi1 + shift)
+               then (c, { c with base = base1; offset = Z.sub c.offset shift }) :: acc
+               else acc
+            ) base2 lo2 (Z.add hi1 shift) cur.cells []
+        in
+        if is_strong_write base1 mode1 then
+          (* Cells of p overlapping the destination are replaced *)
+          let cells = List.fold_left (fun s c -> cell_set_remove c s) cur.cells old in
+          let cells = List.fold_left (fun s (_,c') -> cell_set_add c' s) cells copies in
+          let flow = set_env T_cur { cur with cells } man flow in
+          let post = List.fold_left (fun acc c ->
+              Post.bind (man.exec (mk_remove_var (mk_cell_var c) range) ~route:scalar) acc
+            ) (Post.return flow) old
+          in
+          List.fold_left (fun acc (c,c') ->
+              let stmt = mk_expand_var (mk_cell_var c) [mk_cell_var c'] range in
+              Post.bind (man.exec stmt ~route:scalar) acc
+            ) post copies
+        else
+          (* Copies that are not already cells of p are left unconstrained *)
+          let updated = List.filter (fun (_,c') -> cell_set_mem c' cur.cells) copies in
+          let removed = List.filter (fun c -> not (List.exists (fun (_,c') -> compare_cell c c' = 0) updated)) old in
+          let flow = set_env T_cur { cur with cells = List.fold_left (fun s c -> cell_set_remove c s) cur.cells removed } man flow in
+          let post = List.fold_left (fun acc c ->
+              Post.bind (man.exec (mk_remove_var (mk_cell_var c) range) ~route:scalar) acc
+            ) (Post.return flow) removed
+          in
+          List.fold_left (fun acc (c,c') ->
+              let stmt = mk_assign (mk_var (mk_cell_var c') ~mode:(Some WEAK) range) (mk_var (mk_cell_var c) range) range in
+              Post.bind (man.exec stmt ~route:scalar) acc
+            ) post updated
+
+      | _ ->
+        (* The copied range is not known: the destination was already
+           forgotten by the assigns clause *)
+        Post.return flow
+
+  (** 𝕊⟦ ∀i ∈ [a,b]: *(p + i) == e ⟧, where [e] does not depend on i, as a
+      block fill. Existing cells of the filled range having the type of
+      the lvalue are constrained at once. No cell is created, so the
+      remaining bytes of the range stay unconstrained. Fills of weak bases
+      do not constrain any cell. *)
+  let assume_forall_fill i a b base offset mode ctype e range man flow =
+    let elm = sizeof_type ctype in
+    if not (is_strong_write base mode) then Post.return flow else
+    match quantified_block i a b offset elm range man flow with
+    | None -> Post.return flow
+    | Some (lo, hi) ->
+      let cur = get_env T_cur man flow in
+      let typ = Numeric (remove_typedef_qual ctype) in
+      let cells = cell_set_filter_range
+          (fun c ->
+             compare_cell_typ c.typ typ = 0 &&
+             Z.(rem (c.offset - lo) elm = zero) &&
+             Z.(c.offset + elm - one <= hi))
+          base lo hi cur.cells
+      in
+      List.fold_left (fun acc c ->
+          let v = mk_numeric_cell_var_expr c ~mode:(Some STRONG) range in
+          let v = if compare_typ (cell_type c) e.etyp = 0 then v else mk_c_cast v e.etyp range in
+          Post.bind (man.exec (mk_assume (eq v e range) range) ~route:scalar) acc
+        ) (Post.return flow) cells
+
+  let eval_forall_fill i a b lval e range man flow =
+    man.eval e flow >>$ fun e flow ->
+    eval_pointed_base_offset (mk_c_address_of lval range) range man flow >>$ fun bo flow ->
+    match bo with
+    | Some (base,offset,mode) when is_interesting_base base ->
+      Eval.join
+        (assume_forall_fill i a b base offset mode lval.etyp e range man flow >>% Eval.singleton (mk_true range))
+        (Eval.singleton (mk_false range) flow)
+    | _ -> Eval.singleton (mk_top T_bool range) flow
 
   let eval_forall_eq2 i a b lval1 lval2 range man flow =
     let ctype1 = (remove_casts lval1).etyp
@@ -1049,6 +1431,17 @@ struct
         eval_forall_eq2 i a b (remove_casts lval1) (remove_casts lval2) exp.erange man flow |>
        OptionExt.return
 
+    (* 𝕊⟦ ∀i ∈ [a,b]: *(p + i) == e ⟧ *)
+    | E_stub_quantified_formula([FORALL,i,S_interval(a,b)], { ekind = E_binop(O_eq, lval, e)})
+      when is_c_deref lval &&
+           is_c_num_type lval.etyp &&
+           is_c_num_type e.etyp &&
+           is_var_in_expr i lval &&
+           not (is_var_in_expr i e)
+      ->
+      eval_forall_fill i a b lval e exp.erange man flow |>
+      OptionExt.return
+
     | _ -> None
 
 
@@ -1079,19 +1472,27 @@ struct
   (** 𝕊⟦ lval = e; ⟧ *)
   let exec_assign lval e range man flow =
     let ptr = mk_c_address_of lval range in
-    expand ptr range man flow >>$ fun expansion flow ->
+    expand ~smash:true ptr range man flow >>$ fun expansion flow ->
     match expansion with
     | Top ->
       (* UNSOUND: If we cannot determine where a pointer points to, we treat assignment as a no-op. *)
       Post.return flow
 
     | Cell (c,mode) ->
-      assign_cell c e mode range man flow
+      assign_cell c e mode range man flow >>% fun flow ->
+      (* The base is summarized after the write, so that the summaries
+         include the written cell *)
+      if exceeds_smash_threshold c.base (get_env T_cur man flow)
+      then smash_base c.base range man flow
+      else Post.return flow
 
     | Region (base,lo,hi,step) ->
       man.eval e flow >>$ fun _ flow ->
       assign_region base lo hi step range man flow
 
+    | Smashed (base,offset) ->
+      assign_summary base offset lval.etyp e range man flow
+
 
 
   let exec_add b range man flow =
@@ -1109,11 +1510,17 @@ struct
   (* 𝕊⟦ remove v ⟧ *)
   let exec_remove b range man flow =
     let a = get_env T_cur man flow in
-    let flow = set_env T_cur { a with bases = BaseSet.remove b a.bases } man flow in
+    (* The cells of b are removed from the map at once, before removing
+       their variables *)
     let cells = cell_set_find_base b a.cells in
+    let flow = set_env T_cur { a with bases = BaseSet.remove b a.bases;
+                                      smashed = BaseSet.remove b a.smashed;
+                                      cells = CellSet.remove b a.cells } man flow in
     List.fold_left (fun acc c ->
-        Post.bind (remove_cell c range man) acc
+        Post.bind (man.exec ~route:scalar (mk_remove_var (mk_cell_var c) range)) acc
       ) (Post.return flow) cells
+    >>%
+    remove_summaries b range man
     >>% fun flow ->
     match b with
     | { base_kind = Var v; base_valid = true; } when is_c_scalar_type v.vtyp ->
@@ -1130,24 +1537,49 @@ struct
     (* Remove base1 and add base2 *)
     let a = { a with
               bases = BaseSet.remove base1 a.bases |>
-                      BaseSet.add base2; }
+                      BaseSet.add base2;
+              smashed =
+                if is_smashed_base base1 a
+                then BaseSet.remove base1 a.smashed |> BaseSet.add base2
+                else BaseSet.remove base2 a.smashed; }
     in
     let flow = set_env T_cur a man flow in
 
+    (* Replace the summaries of base2 by those of base1 *)
+    let summaries1 = find_summaries base1 a in
+    remove_summaries base2 range man flow >>% fun flow ->
+    let flow = map_env T_cur (fun a ->
+        { a with summaries = List.fold_left (fun s (_,t) ->
+              SummarySet.remove (base1,t) s |>
+              SummarySet.add (base2,t)
+            ) a.summaries summaries1 }
+      ) man flow
+    in
+    List.fold_left (fun acc (_,t) ->
+        let stmt = mk_rename_var (mk_summary_var base1 t) (mk_summary_var base2 t) range in
+        Post.bind (man.exec stmt ~route:scalar) acc
+      ) (Post.return flow) summaries1
+    >>% fun flow ->
+    let a = get_env T_cur man flow in
+
     (* Cells of base1 *)
     let cells1 = cell_set_find_base base1 a.cells in
 
     (* Cells of base2 *)
     let cells2 = cell_set_find_base base2 a.cells in
 
+    (* Replace the cells of base2 by those of base1 in the map at once *)
+    let flow = set_env T_cur { a with cells = CellSet.remove base1 a.cells |>
+                                              CellSet.add base2 (rebase_cells base2 (CellSet.find base1 a.cells)) } man flow in
+
     (* Remove cells of base2 *)
-    let post = List.fold_left (fun acc c2 -> Post.bind (remove_cell c2 range man) acc) (Post.return flow) cells2 in
+    let post = List.fold_left (fun acc c2 -> Post.bind (man.exec ~route:scalar (mk_remove_var (mk_cell_var c2) range)) acc) (Post.return flow) cells2 in
 
     (* Rename cells in base1 by rebasing to base2 *)
     List.fold_left
       (fun acc c1 ->
          let c2 = { c1 with base = base2 } in
-         Post.bind (rename_cell c1 c2 range man) acc
+         Post.bind (man.exec ~route:scalar (mk_rename_var (mk_cell_var c1) (mk_cell_var c2) range)) acc
       )
       post cells1
 
@@ -1158,13 +1590,30 @@ struct
     (* Add the list of bases bl to abstract state a *)
     let aa = { a with bases = BaseSet.union a.bases (BaseSet.of_list bl) } in
     let flow = set_env T_cur aa man flow in
+    if is_smashed_base b a then
+      (* Expand the summaries of b *)
+      let summaries = find_summaries b a in
+      let flow = map_env T_cur (fun a ->
+          { a with smashed = BaseSet.union a.smashed (BaseSet.of_list bl);
+                   summaries = List.fold_left (fun s (_,t) ->
+                       List.fold_left (fun s bb -> SummarySet.add (bb,t) s) s bl
+                     ) a.summaries summaries }
+        ) man flow
+      in
+      List.fold_left (fun acc (_,t) ->
+          let stmt = mk_expand_var (mk_summary_var b t) (List.map (fun bb -> mk_summary_var bb t) bl) range in
+          Post.bind (man.exec stmt ~route:scalar) acc
+        ) (Post.return flow) summaries
+    else
     (* Get the cells of base b *)
     let cells = cell_set_find_base b a.cells in
-    (* Expand each cell *)
+    (* Copy the cells of b to each base of bl in the map at once *)
+    let m = CellSet.find b a.cells in
+    let flow = set_env T_cur { aa with cells = List.fold_left (fun acc bb -> CellSet.apply bb (OffCells.join (rebase_cells bb m)) acc) aa.cells bl } man flow in
+    (* Expand each cell variable *)
     List.fold_left (fun acc c ->
-        (* Create the corresponding expanded cells *)
-        let cl = List.map (fun bb -> { c with base = bb } ) bl in
-        Post.bind (expand_cell c cl range man) acc
+        let vl = List.map (fun bb -> mk_cell_var { c with base = bb }) bl in
+        Post.bind (man.exec (mk_expand_var (mk_cell_var c) vl range) ~route:scalar) acc
       ) (Post.return flow) cells
 
 
@@ -1175,9 +1624,58 @@ struct
     end)
 
 
+  (** Fold a set of bases into a single base, when some of them are
+      smashed. All bases are smashed and their common summaries are
+      folded. *)
+  let exec_fold_smashed b bl range man flow =
+    let a = get_env T_cur man flow in
+    let bl' = if BaseSet.mem b a.bases then b :: bl else bl in
+    List.fold_left (fun acc bb ->
+        acc >>% fun flow ->
+        if is_smashed_base bb (get_env T_cur man flow) then Post.return flow
+        else smash_base bb range man flow
+      ) (Post.return flow) bl'
+    >>% fun flow ->
+    let a = get_env T_cur man flow in
+    let types bb = find_summaries bb a |> List.map snd in
+    let common =
+      match bl' with
+      | [] -> []
+      | hd :: tl ->
+        List.filter (fun t ->
+            List.for_all (fun bb -> List.exists (fun t' -> compare_cell_typ t t' = 0) (types bb)) tl
+          ) (types hd)
+    in
+    (* Remove the summaries of b that are not common *)
+    remove_summaries ~f:(fun t -> not (List.exists (fun t' -> compare_cell_typ t t' = 0) common)) b range man flow >>% fun flow ->
+    let flow = map_env T_cur (fun a ->
+        { a with bases = BaseSet.add b a.bases;
+                 smashed = BaseSet.add b a.smashed;
+                 summaries = List.fold_left (fun s t -> SummarySet.add (b,t) s) a.summaries common }
+      ) man flow
+    in
+    List.fold_left (fun acc t ->
+        let stmt = mk_fold_var (mk_summary_var b t) (List.map (fun bb -> mk_summary_var bb t) bl) range in
+        Post.bind (man.exec stmt ~route:scalar) acc
+      ) (Post.return flow) common
+    >>% fun flow ->
+    (* Summaries of bl have been folded *)
+    let flow = map_env T_cur (fun a ->
+        { a with summaries = SummarySet.filter (fun (bb,_) -> not (List.exists (fun b' -> compare_base bb b' = 0) bl)) a.summaries }
+      ) man flow
+    in
+    List.fold_left
+      (fun acc bb ->
+         Post.bind (exec_remove bb range man) acc
+      ) (Post.return flow) bl
+
+
   (** Fold a set of bases into a single base *)
   let exec_fold b bl range man flow =
     let a = get_env T_cur man flow in
+    if List.exists (fun bb -> is_smashed_base bb a) (b :: bl) then
+      exec_fold_smashed b bl range man flow
+    else
     (* Add the base b *)
     let a = { a with bases = BaseSet.add b a.bases } in
     (* Find common offsets and types of cells in bases bl *)
@@ -1231,7 +1729,10 @@ struct
     let havoc_cells (cells: cell list) = List.fold_left (fun acc c -> Post.bind (havoc_cell c) acc) (Post.return flow) cells in
     let cells_of c = OffCells.fold (fun z c a -> ((Cells.elements c) @ a)) c [] in
     let cells = CellSet.fold (fun a b c -> cells_of b @ c ) env.cells [] in
-    havoc_cells cells
+    havoc_cells cells >>% fun flow ->
+    SummarySet.fold (fun (b,t) acc ->
+        Post.bind (man.exec (mk_havoc_var (mk_summary_var b t) (summary_type t) range)) acc
+      ) env.summaries (Post.return flow)
 
 
   (** Forget the value of an lval *)
@@ -1250,6 +1751,9 @@ struct
       let a = get_env T_cur man flow in
       let cells = cell_set_find_overlapping_itv base itv a.cells in
       List.fold_left (fun acc c -> Post.bind (forget_cell c range man) acc) (Post.return flow) cells
+      >>%
+      (* Summaries of a smashed base are no longer valid *)
+      remove_summaries base range man
 
     | _ -> Post.return flow
 
@@ -1269,6 +1773,9 @@ struct
       let a = get_env T_cur man flow in
       let cells = cell_set_find_overlapping_itv base itv a.cells in
       List.fold_left (fun acc c -> Post.bind (forget_cell c range man) acc) (Post.return flow) cells
+      >>%
+      (* Summaries of a smashed base are no longer valid *)
+      remove_summaries base range man
 
     | _ -> Post.return flow
 
@@ -1335,7 +1842,9 @@ struct
   (** ****************** *)
 
   let print_state printer a =
-    pprint printer (pbox CellSet.print a.cells) ~path:[Key "cells"]
+    pprint printer (pbox CellSet.print a.cells) ~path:[Key "cells"];
+    if not (BaseSet.is_empty a.smashed) then
+      pprint printer (pbox SummarySet.print a.summaries) ~path:[Key "summaries"]
 
   let print_expr man flow printer exp =
     let exp = remove_casts exp in
@@ -32,6 +32,9 @@ module Reduction =
 struct
   let name = "c.memory.reductions.pointer_eval"
 
+  (* Reduce only evaluations of pointers *)
+  let trigger = Some (fun e -> is_c_pointer_type e.etyp)
+
   let reduce exp man rman pre results flow =
     if not @@ List.exists (fun e -> is_c_pointer_type e.etyp) results then None
     else
@@ -406,17 +406,15 @@ struct
       Post.return flow'
 
 
+  (* Operations on bases only visit the pointers found in the inverse
+     index of the map, i.e. pointers that may point to the base. Their
+     cost does not depend on the total number of pointers. *)
+
   (** Rename a base *)
   let exec_rename_base e e' range man flow =
     let base = expr_to_base e in
     let base' = expr_to_base e' in
-    map_env T_cur (fun a ->
-        match Map.find_inverse (PointerValue.Base base) a with
-        | TOP -> a
-        | Nt pset ->
-          Map.add_inverse (PointerValue.Base base') pset a |>
-          Map.remove_inverse (PointerValue.Base base)
-      ) man flow |>
+    map_env T_cur (Map.rename_inverse (PointerValue.Base base) (PointerValue.Base base')) man flow |>
     Post.return
 
 
@@ -425,12 +423,9 @@ struct
     let base = expr_to_base e in
     let basel = List.map expr_to_base el in
     map_env T_cur (fun a ->
-        match Map.find_inverse (PointerValue.Base base) a with
-        | TOP -> a
-        | Nt pset ->
-          List.fold_left (fun acc base' ->
-              Map.add_inverse (PointerValue.Base base') pset acc
-            ) a basel
+        List.fold_left (fun acc base' ->
+            Map.copy_inverse (PointerValue.Base base) (PointerValue.Base base') acc
+          ) a basel
       ) man flow |>
     Post.return
 
@@ -438,23 +433,11 @@ struct
   let exec_fold_bases e el range man flow =
     let base = expr_to_base e in
     let basel = List.map expr_to_base el in
+    (* Make pointers to bases in basel point to base *)
     map_env T_cur (fun a ->
-        try
-          (* get the set pointers pointing to bases in basel *)
-          let pset = List.fold_left (fun acc base' ->
-              match Map.find_inverse (PointerValue.Base base') a with
-              | TOP -> raise Top.Found_TOP
-              | Nt pset -> Map.KeySet.union pset acc
-            ) Map.KeySet.empty basel
-          in
-          (* Make pointers in pset point to base *)
-          let a' = Map.add_inverse (PointerValue.Base base) pset a in
-          (* Remove bases in basel *)
-          List.fold_left (fun acc base' ->
-              Map.remove_inverse (PointerValue.Base base') acc
-            ) a' basel
-        with Top.Found_TOP ->
-          a
+        List.fold_left (fun acc base' ->
+            Map.rename_inverse (PointerValue.Base base') (PointerValue.Base base) acc
+          ) a basel
       ) man flow |>
     Post.return
 
@@ -466,15 +449,9 @@ struct
       | _ -> assert false
     in
     let flow = map_env T_cur (fun a ->
-        match Map.find_inverse (PointerValue.Base valid_base) a with
-        | TOP -> a
-        | Nt pset ->
-          if base_mode valid_base = STRONG
-          then
-            Map.remove_inverse (PointerValue.Base valid_base) a |>
-            Map.add_inverse (PointerValue.Base invalid_base) pset
-          else
-            Map.add_inverse (PointerValue.Base invalid_base) pset a
+        if base_mode valid_base = STRONG
+        then Map.rename_inverse (PointerValue.Base valid_base) (PointerValue.Base invalid_base) a
+        else Map.copy_inverse (PointerValue.Base valid_base) (PointerValue.Base invalid_base) a
       ) man flow
     in
     Post.return flow
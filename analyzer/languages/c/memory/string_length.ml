@@ -424,6 +424,242 @@ struct
           man.exec ~route:universal (mk_forget length range) flow
 
 
+  (** {2 Loop idioms} *)
+  (** *************** *)
+
+  (** Loops over strings that follow one of these idioms are summarized in
+      one step, instead of being iterated by the loop iterator:
+      - scan: [while ( *p) p++;] and [while (a[i]) i++;]
+      - copy: [while ((*d++ = *s++) != 0);]
+      - fill: [while (i < n) { a[i] = c; i++; }], including the
+        equivalent [for] loops.
+
+      The number of iterations is kept in a fresh variable [n], which is
+      constrained by quantified formulas over the buffers. These formulas
+      relate [n] with the length variables in a single update. The
+      accesses of the first and the last iterations are executed
+      explicitly, so that out-of-bound accesses are still reported. *)
+
+  let opt_summarize_loops = ref false
+
+  let () =
+    register_domain_option name {
+      key = "-c-summarize-string-loops";
+      category = "C";
+      doc = " summarize scan, copy and fill loops over strings";
+      spec = ArgExt.Set opt_summarize_loops;
+      default = "";
+    }
+
+  type loop_idiom =
+    | Scan_ptr of var                      (** while ( *p) p++; *)
+    | Scan_index of expr * var             (** while (a[i]) i++; *)
+    | Copy of var * var                    (** while ((*d++ = *s++) != 0); *)
+    | Fill of expr * var * expr * expr     (** while (i < n) { a[i] = c; i++; } *)
+
+  let is_char_type t =
+    is_c_int_type t && sizeof_type t = Z.of_int elem_size
+
+  let is_char_pointer_var v =
+    match remove_typedef_qual v.vtyp with
+    | T_c_pointer t -> is_char_type t
+    | _ -> false
+
+  (** Expressions without side effects nor memory reads *)
+  let rec is_pure e =
+    match ekind e with
+    | E_var _ | E_constant _ -> true
+    | E_c_cast (e, _) | E_unop (_, e) -> is_pure e
+    | E_binop (_, e1, e2) -> is_pure e1 && is_pure e2
+    | _ -> false
+
+  let rec flatten_block s =
+    match skind s with
+    | S_block (sl, []) -> List.concat (List.map flatten_block sl)
+    | _ -> [s]
+
+  (** Test whether [s] is [v++] or [++v] *)
+  let is_incr v s =
+    match skind s with
+    | S_expression e ->
+      begin match ekind (remove_casts e) with
+        | E_c_increment (INC, _, { ekind = E_var (v', _) }) -> compare_var v v' = 0
+        | _ -> false
+      end
+    | _ -> false
+
+  (** Expression [e] of a condition [e != 0] *)
+  let nonzero_operand cond =
+    let cond = remove_casts cond in
+    match ekind cond with
+    | E_binop (O_ne, e, z) ->
+      begin match c_expr_to_z z with
+        | Some z when Z.equal z Z.zero -> remove_casts e
+        | _ -> cond
+      end
+    | _ -> cond
+
+  let match_loop_idiom cond body : loop_idiom option =
+    match ekind (nonzero_operand cond), flatten_block body with
+    | E_c_deref { ekind = E_var (p, _) }, [s]
+      when is_char_pointer_var p && is_incr p s ->
+      Some (Scan_ptr p)
+
+    | E_c_array_subscript (a, { ekind = E_var (i, _) }), [s]
+      when is_char_type (under_type a.etyp) &&
+           is_c_int_type i.vtyp &&
+           is_incr i s &&
+           is_pure a &&
+           not (is_var_in_expr i a) ->
+      Some (Scan_index (a, i))
+
+    | E_c_assign ({ ekind = E_c_deref { ekind = E_c_increment (INC, POST, { ekind = E_var (d, _) }) } }, rhs), [] ->
+      begin match ekind (remove_casts rhs) with
+        | E_c_deref { ekind = E_c_increment (INC, POST, { ekind = E_var (s, _) }) }
+          when is_char_pointer_var d &&
+               is_char_pointer_var s &&
+               compare_var d s <> 0 ->
+          Some (Copy (d, s))
+        | _ -> None
+      end
+
+    | _ ->
+      match ekind (remove_casts cond), flatten_block body with
+      | E_binop (O_lt, i, n), [s1; s2] ->
+        begin match ekind (remove_casts i), skind s1 with
+          | E_var (i, _), S_expression { ekind = E_c_assign ({ ekind = E_c_array_subscript (a, j) } as lval, c) }
+            when is_c_int_type i.vtyp &&
+                 is_incr i s2 &&
+                 is_char_type lval.etyp &&
+                 (match ekind (remove_casts j) with E_var (j, _) -> compare_var i j = 0 | _ -> false) &&
+                 is_pure a && is_pure n && is_pure c &&
+                 not (is_var_in_expr i a) &&
+                 not (is_var_in_expr i n) &&
+                 not (is_var_in_expr i c) ->
+            Some (Fill (a, i, n, c))
+          | _ -> None
+        end
+      | _ -> None
+
+
+  (** Execute [f n k] with a fresh variable [n] for the number of iterations
+      and a fresh quantified variable [k] *)
+  let with_iterations_var f range man flow =
+    let nv = mktmp ~typ:sl () in
+    let kv = mktmp ~typ:sl () in
+    let n = mk_var nv range in
+    man.exec (mk_add_var nv range) flow >>% fun flow ->
+    man.exec (mk_add_var kv range) flow >>% fun flow ->
+    man.exec (mk_assume (ge n (mk_zero range) ~etyp:s32 range) range) flow >>% fun flow ->
+    f n kv flow >>% fun flow ->
+    man.exec (mk_remove_var kv range) flow >>% fun flow ->
+    man.exec (mk_remove_var nv range) flow
+
+  (** 𝕊⟦ ∀k ∈ [lo,hi]: cond(k) ⟧ *)
+  let assume_forall kv lo hi cond range man flow =
+    let k = mk_var kv range in
+    man.exec (mk_assume (mk_in k lo hi range) range) flow >>% fun flow ->
+    man.exec (mk_assume (mk_stub_quantified_formula [FORALL, kv, S_interval (lo, hi)] (cond k) range) range) flow
+
+  (** Scan: [elem k] is the k-th scanned character and [advance n] moves the
+      iterator after n iterations *)
+  let summarize_scan cond elem advance range man flow =
+    (* The first test of the loop checks the first access *)
+    man.eval cond flow >>$ fun _ flow ->
+    with_iterations_var (fun n kv flow ->
+        assume_forall kv (mk_zero range) (pred n range)
+          (fun k -> ne (elem k) (mk_zero range) ~etyp:s32 range) range man flow >>% fun flow ->
+        man.exec (mk_assume (eq (elem n) (mk_zero range) ~etyp:s32 range) range) flow >>% fun flow ->
+        man.exec (advance n) flow
+      ) range man flow
+
+  (** Test whether [d] and [s] may point to the same block. The summary of
+      a copy assumes that the source is not modified by the copy, which does
+      not hold when the buffers overlap. *)
+  let may_overlap d s range man flow =
+    let bases v =
+      resolve_pointer (mk_var v range) man flow |>
+      Cases.fold_result (fun acc pt _ ->
+          match acc, pt with
+          | Some l, P_block (b, _, _) -> Some (b :: l)
+          | Some l, (P_null | P_invalid) -> Some l
+          | _ -> None
+        ) (Some [])
+    in
+    match bases d, bases s with
+    | Some bd, Some bs -> List.exists (fun b -> List.exists (fun b' -> compare_base b b' = 0) bs) bd
+    | _ -> true
+
+  (** Copy until the terminating character, included *)
+  let summarize_copy d s range man flow =
+    let dst k = mk_c_deref (add (mk_var d range) k range) range in
+    let src k = mk_c_deref (add (mk_var s range) k range) range in
+    with_iterations_var (fun n kv flow ->
+        assume_forall kv (mk_zero range) (pred n range)
+          (fun k -> ne (src k) (mk_zero range) ~etyp:s32 range) range man flow >>% fun flow ->
+        man.exec (mk_assume (eq (src n) (mk_zero range) ~etyp:s32 range) range) flow >>% fun flow ->
+        (* First and last writes *)
+        man.exec (mk_assign (dst (mk_zero range)) (src (mk_zero range)) range) flow >>% fun flow ->
+        man.exec (mk_forget (mk_stub_quantified_formula [FORALL, kv, S_interval (mk_zero range, pred n range)] (dst (mk_var kv range)) range) range) flow >>% fun flow ->
+        assume_forall kv (mk_zero range) (pred n range)
+          (fun k -> eq (dst k) (src k) ~etyp:s32 range) range man flow >>% fun flow ->
+        man.exec (mk_assign (dst n) (src n) range) flow >>% fun flow ->
+        man.exec (mk_assign (mk_var d range) (add (mk_var d range) (succ n range) range) range) flow >>% fun flow ->
+        man.exec (mk_assign (mk_var s range) (add (mk_var s range) (succ n range) range) range) flow
+      ) range man flow
+
+  (** Fill a[i..n-1] with c *)
+  let summarize_fill a i n c range man flow =
+    let elem k = mk_c_subscript_access a k range in
+    let iv = mk_var i range in
+    assume (lt iv n ~etyp:s32 range) man flow
+      ~fthen:(fun flow ->
+          let last = pred n range in
+          (* First and last writes *)
+          man.exec (mk_assign (elem iv) c range) flow >>% fun flow ->
+          man.exec (mk_assign (elem last) c range) flow >>% fun flow ->
+          let kv = mktmp ~typ:sl () in
+          man.exec (mk_add_var kv range) flow >>% fun flow ->
+          man.exec (mk_forget (mk_stub_quantified_formula [FORALL, kv, S_interval (iv, last)] (elem (mk_var kv range)) range) range) flow >>% fun flow ->
+          assume_forall kv iv last (fun k -> eq (elem k) c ~etyp:s32 range) range man flow >>% fun flow ->
+          man.exec (mk_remove_var kv range) flow >>% fun flow ->
+          man.exec (mk_assign iv n range) flow
+        )
+      ~felse:(fun flow -> Post.return flow)
+
+  (** 𝕊⟦ while (cond) body; ⟧ for loop idioms *)
+  let exec_loop_idiom cond body range man flow =
+    match match_loop_idiom cond body with
+    | None -> None
+    | Some (Copy (d, s)) when may_overlap d s range man flow -> None
+    | Some idiom ->
+      debug "summarizing loop at %a" pp_range range;
+      match idiom with
+      | Scan_ptr p ->
+        let pv = mk_var p range in
+        summarize_scan cond
+          (fun k -> mk_c_deref (add pv k range) range)
+          (fun n -> mk_assign pv (add pv n range) range)
+          range man flow |>
+        OptionExt.return
+
+      | Scan_index (a, i) ->
+        let iv = mk_var i range in
+        summarize_scan cond
+          (fun k -> mk_c_subscript_access a (add iv k ~typ:sl range) range)
+          (fun n -> mk_assign iv (add iv n range) range)
+          range man flow |>
+        OptionExt.return
+
+      | Copy (d, s) ->
+        summarize_copy d s range man flow |>
+        OptionExt.return
+
+      | Fill (a, i, n, c) ->
+        summarize_fill a i n c range man flow |>
+        OptionExt.return
+
+
   (** Transformers entry point *)
   let exec stmt man flow =
     match skind stmt with
@@ -465,6 +701,11 @@ struct
       exec_assign lval rval stmt.srange man flow |>
       OptionExt.return
 
+    | S_while(cond, body)
+      when !opt_track_length && !opt_summarize_loops
+      ->
+      exec_loop_idiom cond body stmt.srange man flow
+
     | _ -> None
 
 
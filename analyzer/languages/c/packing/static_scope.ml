@@ -124,6 +124,7 @@ struct
     | Globals             (** Pack of global variables *)
     | Locals of string    (** Pack of local variables of a function *)
     | User   of user_pack (** User-defined packs *)
+    | Alias  of int       (** Variables targeted by the same pointers *)
 
 
   (** Generate a unique ID for the strategy *)
@@ -139,6 +140,7 @@ struct
     | Globals, Globals -> 0
     | Locals f1, Locals f2 -> compare f1 f2
     | User u1, User u2 -> compare_user_pack u1 u2
+    | Alias a1, Alias a2 -> compare a1 a2
     | _ -> compare k1 k2
 
 
@@ -147,6 +149,7 @@ struct
     | Globals  -> pp_string printer "[globals]"
     | Locals f -> pp_string printer f
     | User u  -> pp_user_pack printer u
+    | Alias a -> pprint printer (fbox "[alias %d]" a)
 
 
   (** Initialization *)
@@ -206,15 +209,27 @@ struct
     List.map (fun u -> User u)
 
 
+  (** Get the pack of a variable that may be accessed through the same
+      pointers as other variables, according to the points-to
+      pre-analysis *)
+  let alias_packs_of_var ?(user_only=false) v =
+    if user_only then []
+    else
+      match Common.Pre_points_to.alias_class v with
+      | None -> []
+      | Some a -> [Alias a]
+
+
   (** Get the packs of a base *)
   let rec packs_of_base ?(user_only=false) ctx b =
     (* Invalid bases are not packed *)
     if b.base_valid = false then [] else
     match b.base_kind with
     (* Global variables *)
-    | Var ({ vkind = V_cvar ({cvar_scope = Variable_global} as cvar); vtyp })
+    | Var ({ vkind = V_cvar ({cvar_scope = Variable_global} as cvar); vtyp } as v)
       ->
-      user_packs_of_cvar cvar
+      user_packs_of_cvar cvar @
+      alias_packs_of_var ~user_only v
 
     (* Local temporary variables are not packed *)
     | Var { vkind = V_cvar {cvar_scope = Variable_local f; cvar_orig_name}; vtyp }
@@ -223,11 +238,12 @@ struct
       []
 
     (* Local scalar variables are packed in the function's pack *)
-    | Var ({ vkind = V_cvar ({cvar_scope = Variable_local f} as cvar); vtyp })
-    | Var ({ vkind = V_cvar ({cvar_scope = Variable_func_static f} as cvar); vtyp })
+    | Var ({ vkind = V_cvar ({cvar_scope = Variable_local f} as cvar); vtyp } as v)
+    | Var ({ vkind = V_cvar ({cvar_scope = Variable_func_static f} as cvar); vtyp } as v)
       ->
       packs_of_function ~user_only f.c_func_unique_name @
-      user_packs_of_cvar cvar
+      user_packs_of_cvar cvar @
+      alias_packs_of_var ~user_only v
 
     (* Formal scalar parameters are part of the caller and the callee packs *)
     | Var { vkind = V_cvar {cvar_scope = Variable_parameter f}; vtyp }
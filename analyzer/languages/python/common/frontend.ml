@@ -46,6 +46,35 @@ let () =
       default = "";
     }
 
+let opt_parse_jobs = ref 1
+let () =
+  register_domain_option "python.frontend" {
+      key = "-py-parse-jobs";
+      category = "Python";
+      doc = " number of worker processes parsing the modules given on the command line";
+      spec = ArgExt.Set_int opt_parse_jobs;
+      default = "1";
+    };
+  register_domain_option "python.frontend" {
+      key = "-py-disable-parser-cache";
+      category = "Python";
+      doc = " disable the cache of parsed modules";
+      spec = ArgExt.Clear Mopsa_py_parser.Main.enable_cache;
+      default = "";
+    }
+
+(** Modules of the project given on the command line after the analyzed
+    program, found by imports before the search path *)
+let project_modules : string list ref = ref []
+
+(** Files of the project modules that may define module [name], given
+    with '/' as separator *)
+let find_project_module name =
+  List.filter (fun f ->
+      List.exists (fun suffix -> f = suffix || String.ends_with ~suffix:("/" ^ suffix) f)
+        [name ^ ".py"; name ^ "/__init__.py"]
+    ) !project_modules
+
 let opt_check_type_annot = ref true
 
 let debug fmt = Debug.debug ~channel:"python.frontend" fmt
@@ -81,7 +110,12 @@ let rec parse_program (files: string list) : program =
 
   | [] -> panic "no input file"
 
-  | _ -> panic "analysis of multiple files not supported"
+  | filename :: modules ->
+    (* The first file is the analyzed program, the others are modules it
+       may import. All are parsed up front, in parallel. *)
+    project_modules := modules;
+    Mopsa_py_parser.Main.prefetch ~jobs:!opt_parse_jobs files;
+    parse_program [filename]
 
 (** Create a Universal.var variable from Mopsa_py_parser.Ast.var *)
 and from_var (v:Mopsa_py_parser.Ast.var) =
@@ -197,8 +197,9 @@ module Domain =
               let filename =
                 let file_candidates = [dir ^ "/" ^ name ^ ".py";
                                        name ^ ".py";
-                                       name ^ "/__init__.py";
-                                       dir ^ "/typeshed/" ^ name ^ ".pyi";
+                                       name ^ "/__init__.py"] @
+                                      Frontend.find_project_module name @
+                                      [dir ^ "/typeshed/" ^ name ^ ".pyi";
                                        (* name ^ "module.c"; *)
                                        "mopsa.db"
                                        ]
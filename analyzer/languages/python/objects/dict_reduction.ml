@@ -32,6 +32,8 @@ module Reduction =
 struct
   let name = "python.objects.dict_reduction"
 
+  let trigger = None
+
   let reduce exp man rman pre results flow =
     if List.length results = 1 then
       let () = debug "reduction with %a" (format @@ Flow.print man.lattice.print) flow in
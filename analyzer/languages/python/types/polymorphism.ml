@@ -140,6 +140,8 @@ struct
 
   let debug fmt = Debug.debug ~channel:name fmt
 
+  let trigger = None
+
   let addrenv = Addr_env.Domain.id
   let polymorphism = Poly.id
 
@@ -70,6 +70,86 @@ let mk_addr_stack addr_kind addr_mode range cs =
 let mk_addr_all addr_kind addr_mode range cs  =
   { addr_kind; addr_mode; addr_partitioning = G_all }
 
+
+(** The budgeted policy starts as [range_callstack] and, once an allocation
+    site reaches its budget of partitions, truncates all the callstacks of
+    the site to a shorter suffix, until they fit in the budget. *)
+
+let opt_alloc_site_budget = ref 8
+
+let () = register_builtin_option {
+    key = "-alloc-site-budget";
+    category = "Heap";
+    doc = " maximal number of callstacks per allocation site for the policy range_callstack_budget";
+    spec = ArgExt.Set_int opt_alloc_site_budget;
+    default = "8";
+  }
+
+module CallstackSet = SetExt.Make(struct type t = callstack let compare = compare_callstack end)
+
+(** Partitions of an allocation site *)
+type site_budget = {
+  mutable depth : int option;       (** Maximal length of callstacks, if truncated *)
+  mutable stacks : CallstackSet.t;  (** Callstacks of the partitions *)
+}
+
+module SiteMap = MapExt.Make(struct
+    type t = addr_kind * range
+    let compare = Compare.pair compare_addr_kind compare_range
+  end)
+
+let budget_sites : site_budget SiteMap.t ref = ref SiteMap.empty
+
+(** Number of times an allocation site has been truncated *)
+let budget_truncations = ref 0
+
+(** Number of allocation sites and partitions created by the budgeted
+    policy, and number of truncations *)
+let budget_stats () =
+  let sites = SiteMap.cardinal !budget_sites in
+  let partitions = SiteMap.fold (fun _ s acc -> acc + CallstackSet.cardinal s.stacks) !budget_sites 0 in
+  sites, partitions, !budget_truncations
+
+let rec truncate_callstack n (cs:callstack) : callstack =
+  if n <= 0 then []
+  else
+    match cs with
+    | [] -> []
+    | c :: tl -> c :: truncate_callstack (n - 1) tl
+
+let mk_addr_stack_range_budget addr_kind addr_mode range cs =
+  let key = (addr_kind, range) in
+  let site =
+    match SiteMap.find_opt key !budget_sites with
+    | Some site -> site
+    | None ->
+      let site = { depth = None; stacks = CallstackSet.empty } in
+      budget_sites := SiteMap.add key site !budget_sites;
+      site
+  in
+  let rec fit () =
+    let cs' = match site.depth with None -> cs | Some d -> truncate_callstack d cs in
+    if CallstackSet.mem cs' site.stacks then cs'
+    else if CallstackSet.cardinal site.stacks < max 1 !opt_alloc_site_budget
+         || site.depth = Some 0
+    then (site.stacks <- CallstackSet.add cs' site.stacks; cs')
+    else
+      (* Drop the outermost call of the longest callstacks of the site *)
+      let longest =
+        CallstackSet.fold (fun c acc -> max acc (callstack_length c))
+          site.stacks (callstack_length cs')
+      in
+      let d = max 0 (longest - 1) in
+      site.depth <- Some d;
+      site.stacks <- CallstackSet.map (truncate_callstack d) site.stacks;
+      incr budget_truncations;
+      fit ()
+  in
+  { addr_kind;
+    addr_mode;
+    addr_partitioning = G_stack_range (fit (), range) }
+
+
 let mk_addr_chain : (addr_kind -> mode -> range -> callstack -> addr) ref =
   ref (fun ak _ _ _ -> assert false)
 let mk_addr ak m r cs = !mk_addr_chain ak m r cs
@@ -80,7 +160,7 @@ let register_option (opt: string ref) (domain_name: string) (key: string) (descr
       key;
       category = "Heap";
       doc = Format.asprintf " allocation policy used %s" descr;
-      spec = ArgExt.Symbol (["all"; "range"; "callstack"; "range_callstack"],
+      spec = ArgExt.Symbol (["all"; "range"; "callstack"; "range_callstack"; "range_callstack_budget"],
                             (function s -> opt := s));
       default = !opt;
     };
@@ -91,4 +171,5 @@ let of_string opt = match opt with
     | "range" -> mk_addr_range
     | "callstack" -> mk_addr_stack
     | "range_callstack" -> mk_addr_stack_range
+    | "range_callstack_budget" -> mk_addr_stack_range_budget
     | _ -> panic "unknown policy %s" opt
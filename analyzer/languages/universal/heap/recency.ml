@@ -73,6 +73,78 @@ let gc_time = ref 0.
 let gc_nb_collections = ref 0
 let gc_nb_addr_collected = ref 0
 let gc_max_heap_size = ref 0
+let gc_nb_skipped = ref 0
+let gc_nb_major_collections = ref 0
+
+
+(** {2 Generational scheduling} *)
+(** =========================== *)
+
+(** Addresses allocated since the last collection form the young
+    generation. A minor collection only checks these addresses, and is
+    performed once the young generation reaches [opt_gc_minor_threshold]
+    addresses. A major collection checks all addresses, and is performed
+    when the heap grew by [opt_gc_major_growth] percent since the last major
+    collection. With a null threshold, every GC call is a major collection.
+
+    The generations are kept in the context of flows, not in the abstract
+    state: they only decide which addresses are checked, and skipping a
+    dead address is sound.
+
+    Alive addresses are still computed by the whole reduced product with
+    [Q_alive_addresses_aspset], whose cost does not depend on the checked
+    addresses: minor collections only reduce the number of addresses
+    checked, and the gain comes from the collections that are skipped. *)
+
+let opt_gc_minor_threshold = ref 0
+
+let () = register_domain_option name {
+    key = "-gc-minor-threshold";
+    category = "Heap";
+    doc = " number of young addresses triggering a minor garbage collection (0 to collect at every call)";
+    spec = ArgExt.Set_int opt_gc_minor_threshold;
+    default = "0";
+  }
+
+let opt_gc_major_growth = ref 100
+
+let () = register_domain_option name {
+    key = "-gc-major-growth";
+    category = "Heap";
+    doc = " growth of the heap, in percent, triggering a major garbage collection";
+    spec = ArgExt.Set_int opt_gc_major_growth;
+    default = "100";
+  }
+
+type generations = {
+  young: Pool.t;       (** addresses allocated since the last collection *)
+  size_at_major: int;  (** size of the heap after the last major collection *)
+}
+
+module GenerationsKey = GenContextKey(struct
+    type 'a t = generations
+    let print pp fmt g =
+      Format.fprintf fmt "young addresses: @[%a@]@,heap size at last major collection: %d"
+        (format Pool.print) g.young g.size_at_major
+  end)
+
+let generations_ctx_key = GenerationsKey.key
+
+let get_generations flow =
+  match find_ctx_opt generations_ctx_key (Flow.get_ctx flow) with
+  | Some g -> g
+  | None -> { young = Pool.empty; size_at_major = 0 }
+
+let set_generations g flow =
+  Flow.set_ctx (add_ctx generations_ctx_key g (Flow.get_ctx flow)) flow
+
+(** Add an allocated address to the young generation *)
+let add_young addr flow =
+  if !opt_gc_minor_threshold <= 0 then flow
+  else
+    let g = get_generations flow in
+    set_generations { g with young = Pool.add addr g.young } flow
+
 (** {2 Domain definition} *)
 (** ===================== *)
 
@@ -177,8 +249,28 @@ struct
     | S_perform_gc ->
        let startt = Sys.time () in
        let all = get_env T_cur man flow in
+       let g = get_generations flow in
+       let young = Pool.meet g.young all in
+       let major =
+         !opt_gc_minor_threshold <= 0 ||
+         100 * Pool.cardinal all >= (100 + !opt_gc_major_growth) * max 1 g.size_at_major
+       in
+       if not major && Pool.cardinal young < !opt_gc_minor_threshold then begin
+         incr gc_nb_skipped;
+         Post.return flow |> OptionExt.return
+       end
+       else
+       let candidates = if major then all else young in
        let alive = man.ask Q_alive_addresses_aspset flow in
-       let dead = Pool.diff all alive in
+       let dead = Pool.diff candidates alive in
+       let flow =
+         if !opt_gc_minor_threshold <= 0 then flow
+         else set_generations {
+             young = Pool.empty;
+             size_at_major = if major then Pool.cardinal all - Pool.cardinal dead else g.size_at_major;
+           } flow
+       in
+       if major then incr gc_nb_major_collections;
        debug "at %a, |dead| = %d@.dead = %a" pp_range range (Pool.cardinal dead) (format Pool.print) dead;
        let trange = tag_range range "agc" in
        (* let's free weak addresses first, and then the strong ones *)
@@ -210,6 +302,7 @@ struct
       let pool = get_env T_cur man flow in
 
       let recent_addr = Policies.mk_addr addr_kind STRONG range (Flow.get_callstack flow) in
+      let flow = add_young recent_addr flow in
 
       if not (Pool.mem recent_addr pool) then
         (* first allocation at this site: just add the address to the pool and return it *)
@@ -218,6 +311,7 @@ struct
         OptionExt.return
       else
         let old_addr = Policies.mk_addr addr_kind WEAK range (Flow.get_callstack flow) in
+        let flow = add_young old_addr flow in
         if not (Pool.mem old_addr pool) then
           (* old address not present: rename the existing recent as old and return the new recent *)
           map_env T_cur (Pool.add old_addr) man flow |>
@@ -233,6 +327,7 @@ struct
     | E_alloc_addr(addr_kind, WEAK) ->
       let pool = get_env T_cur man flow in
       let weak_addr = Policies.mk_addr addr_kind WEAK range (Flow.get_callstack flow) in
+      let flow = add_young weak_addr flow in
 
       let flow' =
         if Pool.mem weak_addr pool then
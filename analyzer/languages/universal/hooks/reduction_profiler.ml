@@ -0,0 +1,57 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Hook to profile the reduction rules of reduced products *)
+
+open Mopsa
+open Hook
+
+
+module Hook =
+struct
+
+  (** {2 Hook header} *)
+  (** *************** *)
+
+  let name = "reduction_profiler"
+
+
+  (** {2 Events handlers} *)
+  (** ******************* *)
+
+  let init ctx =
+    Sig.Reduction.Profiler.enabled := true
+
+  let on_before_exec route stmt man flow = ()
+
+  let on_after_exec route stmt man flow post = ()
+
+  let on_before_eval route semantic exp man flow = ()
+
+  let on_after_eval route semantic exp man flow eval = ()
+
+  let on_finish man flow =
+    Sig.Reduction.Profiler.print Format.std_formatter ()
+
+end
+
+let () =
+  register_stateless_hook (module Hook)
@@ -285,6 +285,8 @@ struct
 
   let rec lfp count delay cond body man flow_init flow =
     debug "lfp called, range = %a, count = %d" pp_range body.srange count;
+    (* Account for the iteration in the budget of the entry function *)
+    Budget.tick ();
     (* Ignore continue and break flows of the previous iterations *)
     Flow.remove T_continue flow |>
     Flow.remove T_break |>
@@ -318,6 +320,7 @@ struct
     debug "unrolling iteration %a in %a"
       (OptionExt.print ~none:"" ~some:"" Format.pp_print_int) i
       pp_range (srange body);
+    Budget.tick ();
     if i = Some 0 then
       Cases.singleton (false, Flow.bottom (Flow.get_ctx flow) (Flow.get_report flow)) flow
     else
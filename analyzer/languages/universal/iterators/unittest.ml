@@ -163,8 +163,14 @@ struct
         debug "Executing %s" name;
         (* Fold the context *)
         let flow = Flow.copy_ctx acc flow in
-        (* Call the function *)
-        let flow1 = man.exec test flow |> post_to_flow man in
+        (* Call the function, within the budget of entry functions *)
+        let flow1 =
+          match Budget.run (fun () -> man.exec test flow |> post_to_flow man) with
+          | Ok flow1 -> flow1
+          | Error r ->
+            Budget.abandon name r test.srange flow |>
+            Flow.remove T_cur
+        in
         let flow1 = flow_cleaner man flow1 in
         (* let info_flow1 = Flow.bottom (Flow.get_ctx flow1) (Flow.get_report flow1) in *)
         Flow.join man.lattice acc flow1
@@ -33,6 +33,9 @@ struct
   let name = "universal.numeric.reductions.intervals_rel"
   let debug fmt = Debug.debug ~channel:name fmt
 
+  (* Only numeric variables are reduced *)
+  let trigger = Some (fun v -> is_numeric_type v.vtyp)
+
   module I = Values.Intervals.Integer.Value
   module R = Relational.Domain
 
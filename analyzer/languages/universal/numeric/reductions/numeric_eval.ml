@@ -31,14 +31,16 @@ module Reduction =
 struct
   let name = "universal.numeric.reductions.numeric_eval"
 
+  (* Reduce only evaluations having a numeric translation *)
+  let is_numeric e =
+    let n = get_expr_translation "Universal" e in
+    is_numeric_type n.etyp
+
+  let trigger = Some is_numeric
+
   let reduce exp man rman pre results flow =
     (* No reduction if no numeric expression found *)
-    if not @@ List.exists
-        (fun e ->
-           let n = get_expr_translation "Universal" e in
-           is_numeric_type n.etyp
-        ) results
-    then None
+    if not @@ List.exists is_numeric results then None
     else
     (* Simplify constant expressions *)
     let results' =
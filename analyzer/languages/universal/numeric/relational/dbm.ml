@@ -0,0 +1,363 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Sparse difference-bound matrices.
+
+    A DBM encodes a conjunction of constraints [y - x <= c] over integer
+    variables. A distinguished node [Zero] stands for the constant 0, so that
+    bounds [x <= c] and [-x <= c] are encoded as [x - 0 <= c] and
+    [0 - x <= c].
+
+    Only finite bounds are stored: the edge [x -> y] labelled [c]
+    represents [y - x <= c], and missing edges denote +oo. Edges are indexed
+    by source and by destination, so that both the successors and the
+    predecessors of a node are found without scanning the matrix.
+
+    A matrix is closed when every stored bound is the length of the
+    shortest path between its two nodes. Matrices carry a flag telling
+    whether they are closed. Widening returns matrices that are not closed,
+    as closing them could reintroduce unstable bounds; operators needing a
+    closed matrix close their arguments with [close] first.
+*)
+
+open Mopsa
+open Bot
+
+
+(** {2 Nodes} *)
+(** ********* *)
+
+type node =
+  | Zero
+  | Var of var
+
+let compare_node n1 n2 =
+  match n1, n2 with
+  | Zero, Zero -> 0
+  | Zero, _ -> -1
+  | _, Zero -> 1
+  | Var v1, Var v2 -> compare_var v1 v2
+
+let pp_node fmt = function
+  | Zero -> Format.pp_print_string fmt "0"
+  | Var v -> pp_var fmt v
+
+module NodeMap = MapExt.Make(struct
+    type t = node
+    let compare = compare_node
+  end)
+
+module NodeSet = SetExt.Make(struct
+    type t = node
+    let compare = compare_node
+  end)
+
+
+(** {2 Matrices} *)
+(** ************ *)
+
+type t = {
+  edges: Z.t NodeMap.t NodeMap.t;  (** bounds of the edges, by source *)
+  preds: NodeSet.t NodeMap.t;      (** sources of the edges, by destination *)
+  closed: bool;                    (** whether the matrix is closed *)
+}
+
+let empty : t = {
+  edges = NodeMap.empty;
+  preds = NodeMap.empty;
+  closed = true;
+}
+
+let is_empty (m:t) = NodeMap.is_empty m.edges
+
+let is_closed (m:t) = m.closed
+
+(** Bound of [y - x], if any *)
+let find (x:node) (y:node) (m:t) : Z.t option =
+  match NodeMap.find_opt x m.edges with
+  | None -> None
+  | Some row -> NodeMap.find_opt y row
+
+(** Set the bound of [y - x], keeping the closure flag of [m] *)
+let set (x:node) (y:node) (c:Z.t) (m:t) : t =
+  let row = try NodeMap.find x m.edges with Not_found -> NodeMap.empty in
+  let srcs = try NodeMap.find y m.preds with Not_found -> NodeSet.empty in
+  { m with
+    edges = NodeMap.add x (NodeMap.add y c row) m.edges;
+    preds = NodeMap.add y (NodeSet.add x srcs) m.preds; }
+
+(** Remove the bound of [y - x], keeping the closure flag of [m] *)
+let unset (x:node) (y:node) (m:t) : t =
+  match NodeMap.find_opt x m.edges with
+  | None -> m
+  | Some row ->
+    let row' = NodeMap.remove y row in
+    let srcs' = try NodeSet.remove x (NodeMap.find y m.preds) with Not_found -> NodeSet.empty in
+    { m with
+      edges = if NodeMap.is_empty row' then NodeMap.remove x m.edges else NodeMap.add x row' m.edges;
+      preds = if NodeSet.is_empty srcs' then NodeMap.remove y m.preds else NodeMap.add y srcs' m.preds; }
+
+let fold (f:node -> node -> Z.t -> 'a -> 'a) (m:t) (acc:'a) : 'a =
+  NodeMap.fold (fun x row acc ->
+      NodeMap.fold (fun y c acc -> f x y c acc) row acc
+    ) m.edges acc
+
+let for_all (f:node -> node -> Z.t -> bool) (m:t) : bool =
+  NodeMap.for_all (fun x row ->
+      NodeMap.for_all (fun y c -> f x y c) row
+    ) m.edges
+
+(** Predecessors of [y] with the bounds of their edges *)
+let preds (y:node) (m:t) : (node * Z.t) list =
+  match NodeMap.find_opt y m.preds with
+  | None -> []
+  | Some srcs ->
+    NodeSet.fold (fun x acc ->
+        match find x y m with
+        | None -> acc
+        | Some c -> (x,c) :: acc
+      ) srcs []
+
+let succs (x:node) (m:t) : (node * Z.t) list =
+  match NodeMap.find_opt x m.edges with
+  | None -> []
+  | Some row -> NodeMap.bindings row
+
+let nodes (m:t) : NodeSet.t =
+  NodeMap.fold (fun x _ acc -> NodeSet.add x acc) m.edges NodeSet.empty |>
+  NodeMap.fold (fun y _ acc -> NodeSet.add y acc) m.preds
+
+
+(** {2 Closure} *)
+(** *********** *)
+
+exception Negative_cycle
+
+(** Shortest-path closure, following the sparse Floyd-Warshall algorithm:
+    paths through each node are only combined for the predecessors and the
+    successors of this node. Returns ⊥ when the matrix has a negative
+    cycle. *)
+let close (m:t) : t with_bot =
+  if m.closed then Nb m
+  else
+    try
+      let m =
+        NodeSet.fold (fun k acc ->
+            let pre = preds k acc and post = succs k acc in
+            List.fold_left (fun acc (i,ci) ->
+                List.fold_left (fun acc (j,cj) ->
+                    let d = Z.(ci + cj) in
+                    if compare_node i j = 0 then
+                      if Z.(d < zero) then raise Negative_cycle else acc
+                    else
+                      match find i j acc with
+                      | Some d' when Z.(d' <= d) -> acc
+                      | _ -> set i j d acc
+                  ) acc post
+              ) acc pre
+          ) (nodes m) m
+      in
+      Nb { m with closed = true }
+    with Negative_cycle -> BOT
+
+
+(** {2 Constraints} *)
+(** *************** *)
+
+(** [add_cons x y c m] adds the constraint [y - x <= c] to [m] and closes
+    the result incrementally: once [m] is closed, a shortest path uses the
+    new edge at most once, so only the pairs (i,j) where i reaches [x] and
+    [y] reaches j need to be tightened. *)
+let add_cons (x:node) (y:node) (c:Z.t) (m:t) : t with_bot =
+  if compare_node x y = 0 then
+    if Z.(c < zero) then BOT else Nb m
+  else
+    bot_absorb1 (fun m ->
+        match find x y m with
+        | Some c' when Z.(c' <= c) -> Nb m
+        | _ ->
+          (* A negative cycle through the new edge means that the constraint is
+             not satisfiable *)
+          match find y x m with
+          | Some c' when Z.(c' + c < zero) -> BOT
+          | _ ->
+            let pre = (x,Z.zero) :: preds x m in
+            let post = (y,Z.zero) :: succs y m in
+            let m' =
+              List.fold_left (fun acc (i,ci) ->
+                  List.fold_left (fun acc (j,cj) ->
+                      if compare_node i j = 0 then acc
+                      else
+                        let d = Z.(ci + c + cj) in
+                        match find i j acc with
+                        | Some d' when Z.(d' <= d) -> acc
+                        | _ -> set i j d acc
+                    ) acc post
+                ) m pre
+            in
+            Nb m'
+      ) (close m)
+
+(** Conjunction of constraints, with early exit on emptiness *)
+let add_cons_list (l:(node * node * Z.t) list) (m:t) : t with_bot =
+  List.fold_left (fun acc (x,y,c) ->
+      bot_absorb1 (add_cons x y c) acc
+    ) (Nb m) l
+
+
+(** {2 Projections} *)
+(** *************** *)
+
+(** Remove all constraints involving node [n]. Removing a node from a closed
+    matrix keeps it closed. *)
+let forget (n:node) (m:t) : t =
+  let m = List.fold_left (fun acc (y,_) -> unset n y acc) m (succs n m) in
+  List.fold_left (fun acc (x,_) -> unset x n acc) m (preds n m)
+
+(** Rename node [n] into [n']. [n'] is supposed to be absent from [m]. *)
+let rename (n:node) (n':node) (m:t) : t =
+  let out = succs n m and inc = preds n m in
+  let m = forget n m in
+  let m = List.fold_left (fun acc (y,c) -> set n' y c acc) m out in
+  List.fold_left (fun acc (x,c) -> set x n' c acc) m inc
+
+(** Copy the constraints of node [n] to a fresh node [n'], without relating
+    [n] and [n']. The constraints are added one by one to the closed
+    matrix, so that the constraints between [n'] and [n] implied by the
+    copies are found. *)
+let expand (n:node) (n':node) (m:t) : t with_bot =
+  bot_absorb1 (fun m ->
+      let out = List.map (fun (y,c) -> (n',y,c)) (succs n m) in
+      let inc = List.map (fun (x,c) -> (x,n',c)) (preds n m) in
+      add_cons_list (out @ inc) m
+    ) (close m)
+
+(** Keep only the constraints whose nodes satisfy [f] *)
+let filter (f:node -> bool) (m:t) : t =
+  fold (fun x y c acc ->
+      if f x && f y then set x y c acc else acc
+    ) m { empty with closed = m.closed }
+
+(** Interval bounds of a node, as the pair (lower,upper) *)
+let bounds (n:node) (m:t) : Z.t option * Z.t option =
+  let lo = match find n Zero m with None -> None | Some c -> Some (Z.neg c) in
+  let hi = find Zero n m in
+  lo, hi
+
+(** Translation of node [n] by an interval [lo,hi] of bounds, i.e.
+    [n = n + c] with [c] in [lo,hi]. Infinite bounds are given as [None].
+    Translation keeps the closure of [m]. *)
+let shift (n:node) (lo:Z.t option) (hi:Z.t option) (m:t) : t =
+  fold (fun x y w acc ->
+      if compare_node y n = 0 then
+        (* w bounds [n - x] *)
+        match hi with
+        | Some h -> set x y Z.(w + h) acc
+        | None -> acc
+      else if compare_node x n = 0 then
+        (* w bounds [y - n] *)
+        match lo with
+        | Some l -> set x y Z.(w - l) acc
+        | None -> acc
+      else
+        set x y w acc
+    ) m { empty with closed = m.closed }
+
+(** Nodes sharing a constraint with [n], apart from [Zero] *)
+let related (n:node) (m:t) : node list =
+  let out = List.map fst (succs n m) in
+  let inc = List.map fst (preds n m) in
+  List.sort_uniq compare_node (out @ inc) |>
+  List.filter (function Zero -> false | Var _ as n' -> compare_node n n' <> 0)
+
+
+(** {2 Lattice operators} *)
+(** ********************* *)
+
+(** Pointwise merge of two matrices on their common edges *)
+let merge_common ~closed (f:node -> node -> Z.t -> Z.t -> Z.t option) (m1:t) (m2:t) : t =
+  fold (fun x y c1 acc ->
+      match find x y m2 with
+      | None -> acc
+      | Some c2 ->
+        match f x y c1 c2 with
+        | None -> acc
+        | Some c -> set x y c acc
+    ) m1 { empty with closed }
+
+(** Inclusion test. Complete only when [m1] is closed. *)
+let subset (m1:t) (m2:t) : bool =
+  m1 == m2 ||
+  for_all (fun x y c2 ->
+      match find x y m1 with
+      | Some c1 -> Z.(c1 <= c2)
+      | None -> false
+    ) m2
+
+(** The pointwise maximum of two closed matrices is closed *)
+let join (m1:t) (m2:t) : t =
+  if m1 == m2 then m1
+  else merge_common ~closed:(m1.closed && m2.closed) (fun _ _ c1 c2 -> Some (Z.max c1 c2)) m1 m2
+
+let meet (m1:t) (m2:t) : t with_bot =
+  if m1 == m2 then Nb m1
+  else
+    fold (fun x y c acc ->
+        bot_absorb1 (add_cons x y c) acc
+      ) m2 (Nb m1)
+
+(** Widening with thresholds: the stable bounds of [m1] are kept, and an
+    unstable bound is replaced by the smallest threshold above its new
+    value given by [thresholds x y], or removed when there is none. [m1]
+    should be the result of the previous widening, without closure, and the
+    result is not closed, otherwise the closure could reintroduce unstable
+    bounds. *)
+let widen ?(thresholds=fun _ _ -> []) (m1:t) (m2:t) : t =
+  if m1 == m2 then m1
+  else
+    merge_common ~closed:false (fun x y c1 c2 ->
+        if Z.(c2 <= c1) then Some c1
+        else
+          List.fold_left (fun acc t ->
+              if Z.(t < c2) then acc
+              else match acc with
+                | Some t' when Z.(t' <= t) -> acc
+                | _ -> Some t
+            ) None (thresholds x y)
+      ) m1 m2
+
+
+(** {2 Printing} *)
+(** ************ *)
+
+let print fmt (m:t) =
+  let l = fold (fun x y c acc -> (x,y,c) :: acc) m [] |> List.rev in
+  if l = [] then Format.pp_print_string fmt "⊤"
+  else
+    Format.fprintf fmt "@[<v>%a@]"
+      (Format.pp_print_list
+         (fun fmt (x,y,c) ->
+            match x, y with
+            | Zero, _ -> Format.fprintf fmt "%a <= %a" pp_node y Z.pp_print c
+            | _, Zero -> Format.fprintf fmt "-%a <= %a" pp_node x Z.pp_print c
+            | _ -> Format.fprintf fmt "%a - %a <= %a" pp_node y pp_node x Z.pp_print c
+         )
+      ) l
@@ -61,7 +61,7 @@ let () =
     category = "Numeric";
     doc = " select the relational numeric domain.";
     spec = ArgExt.Symbol (
-        ["octagon"; "polyhedra"; "lineq"],
+        ["octagon"; "polyhedra"; "lineq"; "zone"],
         (function
           | "octagon"   ->
             opt_numeric := "octagon";
@@ -78,6 +78,11 @@ let () =
             numeric_domain := (module LinEqualities : RELATIONAL);
             register_simplified_domain (module LinEqualities)
 
+          | "zone" ->
+            opt_numeric := "zone";
+            numeric_domain := (module Zone : RELATIONAL);
+            register_simplified_domain (module Zone)
+
           | _ -> assert false
         )
       );
@@ -0,0 +1,412 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Zone abstract domain, based on sparse difference-bound matrices.
+
+    Zones infer constraints [x - y <= c] and [±x <= c] between integer
+    variables. They are cheaper than octagons and polyhedra and are enough
+    to relate loop counters and buffer sizes. Float variables are not
+    tracked. Transfer functions handle precisely assignments [x = y + c] and
+    tests between such linear forms, where [c] is an interval. Other
+    expressions are approximated by their interval.
+*)
+
+open Mopsa
+open Sig.Abstraction.Simplified
+open Common
+open Ast
+open Bot
+
+module I = ItvUtils.IntItv
+module Itv = Intervals.Integer.Value
+
+
+(** Abstract element: a DBM, or ⊥. Matrices are closed, except after a
+    widening: they are closed again before being used by the other
+    operators. *)
+type t = Dbm.t with_bot
+
+include GenDomainId(struct
+    type nonrec t = t
+    let name = "universal.numeric.relational"
+  end)
+
+
+(** {2 Lattice operators} *)
+(** ********************* *)
+
+let top : t = Nb Dbm.empty
+
+let bottom : t = BOT
+
+let close (a:t) : t = bot_absorb1 Dbm.close a
+
+let is_bottom (a:t) =
+  match close a with BOT -> true | Nb _ -> false
+
+let subset (a1:t) (a2:t) = bot_included Dbm.subset (close a1) a2
+
+let join (a1:t) (a2:t) = bot_neutral2 Dbm.join (close a1) (close a2)
+
+let meet (a1:t) (a2:t) = bot_absorb2 Dbm.meet a1 a2
+
+(** Thresholds of the bound of [y - x], from the widening thresholds of
+    the variables. Only the bounds of variables have thresholds. *)
+let widening_thresholds ctx x y =
+  let find v =
+    match Framework.Combiners.Value.Nonrel.find_var_ctx_opt v widening_thresholds_ctx_key ctx with
+    | None -> []
+    | Some s -> SetExt.ZSet.elements s
+  in
+  match x, y with
+  | Dbm.Zero, Dbm.Var v -> find v
+  | Dbm.Var v, Dbm.Zero -> List.map Z.neg (find v)
+  | _ -> []
+
+(** The left argument is the result of the previous widening, which must
+    not be closed to ensure termination *)
+let widen ctx (a1:t) (a2:t) =
+  bot_neutral2 (Dbm.widen ~thresholds:(widening_thresholds ctx)) a1 (close a2)
+
+
+(** {2 Utility functions} *)
+(** ********************* *)
+
+let is_tracked v = is_int_type (vtyp v)
+
+let is_var_numeric_type v = is_numeric_type (vtyp v)
+
+let forget_var v (a:t) : t =
+  bot_lift1 (Dbm.forget (Dbm.Var v)) a
+
+let var_itv v (m:Dbm.t) : I.t =
+  let lo, hi = Dbm.bounds (Dbm.Var v) m in
+  I.of_bound
+    (match lo with None -> I.B.MINF | Some l -> I.B.Finite l)
+    (match hi with None -> I.B.PINF | Some h -> I.B.Finite h)
+
+let bound_var v (a:t) : Itv.t =
+  bot_lift1 (var_itv v) a
+
+let vars (a:t) : var list =
+  match a with
+  | BOT -> []
+  | Nb m ->
+    Dbm.fold (fun x y _ acc ->
+        let acc = match x with Dbm.Var v -> VarSet.add v acc | Dbm.Zero -> acc in
+        match y with Dbm.Var v -> VarSet.add v acc | Dbm.Zero -> acc
+      ) m VarSet.empty |>
+    VarSet.elements
+
+let related_vars v (a:t) : var list =
+  match a with
+  | BOT -> []
+  | Nb m ->
+    Dbm.related (Dbm.Var v) m |>
+    List.fold_left (fun acc -> function Dbm.Var v' -> v' :: acc | Dbm.Zero -> acc) []
+
+let constant_vars (a:t) : var list =
+  List.filter (fun v ->
+      match bound_var v a with
+      | Nb (I.B.Finite l, I.B.Finite h) -> Z.equal l h
+      | _ -> false
+    ) (vars a)
+
+
+(** {2 Linear forms} *)
+(** **************** *)
+
+(** Linear form [x + c] (or [c] when there is no variable), where [c] is an
+    interval *)
+type linear = var option * I.t
+
+let node_of_linear = function
+  | None -> Dbm.Zero
+  | Some v -> Dbm.Var v
+
+(** Translate an expression into a linear form. Sub-expressions that are
+    not linear are approximated by [fallback]. Weak variables represent
+    several concrete values, so they are replaced by their bounds to
+    avoid relating them to other variables. *)
+let rec linearize (fallback:expr -> I.t option) (e:expr) (m:Dbm.t) : linear option =
+  if not (is_int_type e.etyp) then None
+  else
+    let approx () = OptionExt.lift (fun c -> (None, c)) (fallback e) in
+    match ekind e with
+    | E_constant (C_int n) -> Some (None, I.of_z n n)
+
+    | E_constant (C_int_interval (lo,hi)) ->
+      begin match I.of_bound_bot lo hi with
+        | BOT -> None
+        | Nb c -> Some (None, c)
+      end
+
+    | E_constant (C_bool b) -> Some (None, if b then I.one else I.zero)
+
+    | E_var (v,mode) when is_tracked v ->
+      if var_mode v mode = STRONG then Some (Some v, I.zero)
+      else Some (None, var_itv v m)
+
+    | E_unop (O_plus, e1) -> linearize fallback e1 m
+
+    | E_unop (O_minus, e1) ->
+      begin match linearize fallback e1 m with
+        | Some (None, c) -> Some (None, I.neg c)
+        | _ -> approx ()
+      end
+
+    | E_binop (O_plus, e1, e2) ->
+      begin match linearize fallback e1 m, linearize fallback e2 m with
+        | Some (x, c1), Some (None, c2)
+        | Some (None, c2), Some (x, c1) -> Some (x, I.add c1 c2)
+        | _ -> approx ()
+      end
+
+    | E_binop (O_minus, e1, e2) ->
+      begin match linearize fallback e1 m, linearize fallback e2 m with
+        | Some (x, c1), Some (None, c2) -> Some (x, I.sub c1 c2)
+        | _ -> approx ()
+      end
+
+    | _ -> approx ()
+
+(** Interval of a linear form *)
+let linear_itv ((x,c):linear) (m:Dbm.t) : I.t =
+  match x with
+  | None -> c
+  | Some v -> I.add (var_itv v m) c
+
+(** Constraints encoding [l1 <= l2 + k]. With [l1 = x + a] and
+    [l2 = y + b], this is [x - y <= max(b) - min(a) + k]. *)
+let le_cons ?(k=Z.zero) ((x,a):linear) ((y,b):linear) : (Dbm.node * Dbm.node * Z.t) list =
+  match fst a, snd b with
+  | I.B.Finite al, I.B.Finite bu -> [(node_of_linear y, node_of_linear x, Z.(bu - al + k))]
+  | _ -> []
+
+
+(** {2 Transfer functions} *)
+(** ********************** *)
+
+let init prog = top
+
+(** Translation of [v] by the interval [c], i.e. [v = v + c] *)
+let shift_var v ((lo,hi):I.t) (m:Dbm.t) : Dbm.t =
+  let bound = function I.B.Finite z -> Some z | _ -> None in
+  Dbm.shift (Dbm.Var v) (bound lo) (bound hi) m
+
+let assign_var v e man (a:t) : t =
+  if not (is_tracked v) then a
+  else
+    bot_absorb1 (fun m ->
+        let fallback e =
+          match man.ask (mk_int_interval_query e) with
+          | BOT -> None
+          | Nb c -> Some c
+        in
+        match linearize fallback e m with
+        | Some (Some x, c) when compare_var x v = 0 ->
+          Nb (shift_var v c m)
+
+        | Some l ->
+          let m = Dbm.forget (Dbm.Var v) m in
+          let lv = (Some v, I.zero) in
+          Dbm.add_cons_list (le_cons lv l @ le_cons l lv) m
+
+        | None ->
+          Nb (Dbm.forget (Dbm.Var v) m)
+      ) a
+
+(** Refine a zone with a condition, or its negation when [b] is false *)
+let rec assume_cond (b:bool) (e:expr) (m:Dbm.t) : t =
+  match ekind e with
+  | E_constant (C_bool c) -> if c = b then Nb m else BOT
+
+  | E_unop (O_log_not, e1) -> assume_cond (not b) e1 m
+
+  | E_binop (O_log_and, e1, e2) when b ->
+    bot_absorb1 (assume_cond b e2) (assume_cond b e1 m)
+
+  | E_binop (O_log_or, e1, e2) when not b ->
+    bot_absorb1 (assume_cond b e2) (assume_cond b e1 m)
+
+  | E_binop ((O_log_and | O_log_or), e1, e2) ->
+    join (assume_cond b e1 m) (assume_cond b e2 m)
+
+  | E_binop (op, e1, e2)
+    when is_comparison_op op && is_int_type e1.etyp && is_int_type e2.etyp ->
+    let op = if b then op else negate_comparison_op op in
+    let fallback _ = None in
+    begin match linearize fallback e1 m, linearize fallback e2 m with
+      | Some l1, Some l2 ->
+        let cons = match op with
+          | O_le -> le_cons l1 l2
+          | O_lt -> le_cons ~k:Z.minus_one l1 l2
+          | O_ge -> le_cons l2 l1
+          | O_gt -> le_cons ~k:Z.minus_one l2 l1
+          | O_eq -> le_cons l1 l2 @ le_cons l2 l1
+          | _ -> []
+        in
+        Dbm.add_cons_list cons m
+      | _ -> Nb m
+    end
+
+  | _ -> Nb m
+
+let assume stmt ask (a:t) : t option =
+  match skind stmt with
+  | S_assume e -> Some (bot_absorb1 (assume_cond true e) a)
+  | _ -> assert false
+
+let merge pre (a1,e1) (a2,e2) =
+  let x1,x2 =
+    generic_merge
+      ~add:(fun v () a -> forget_var v a)
+      ~find:(fun v a -> ())
+      ~remove:(fun v a -> forget_var v a)
+      (a1,e1) (a2,e2)
+  in
+  meet x1 x2
+
+let rec exec stmt man ctx (a:t) : t option =
+  let a = close a in
+  match skind stmt with
+  | S_add { ekind = E_var (var, _) } when is_var_numeric_type var ->
+    Some a
+
+  | S_remove { ekind = E_var (var, _) }
+  | S_forget { ekind = E_var (var, _) } when is_var_numeric_type var ->
+    forget_var var a |>
+    OptionExt.return
+
+  | S_rename ({ ekind = E_var (var1, _) }, { ekind = E_var (var2, _) })
+    when is_var_numeric_type var1 && is_var_numeric_type var2 ->
+    forget_var var2 a |>
+    bot_lift1 (Dbm.rename (Dbm.Var var1) (Dbm.Var var2)) |>
+    OptionExt.return
+
+  | S_project vars
+    when List.for_all (function { ekind = E_var (v, _) } -> is_var_numeric_type v | _ -> false) vars
+    ->
+    let vars = List.fold_left (fun acc -> function
+        | { ekind = E_var (v, _) } -> VarSet.add v acc
+        | _ -> assert false
+      ) VarSet.empty vars
+    in
+    bot_lift1 (Dbm.filter (function Dbm.Zero -> true | Dbm.Var v -> VarSet.mem v vars)) a |>
+    OptionExt.return
+
+  | S_assign ({ ekind = E_var (var, mode) }, e) when var_mode var mode = STRONG && is_var_numeric_type var ->
+    assign_var var e man a |>
+    OptionExt.return
+
+  | S_assign ({ ekind = E_var (var, mode) } as lval, e) when var_mode var mode = WEAK && is_var_numeric_type var ->
+    let lval' = { lval with ekind = E_var (var, Some STRONG) } in
+    exec { stmt with skind = S_assign (lval', e) } man ctx a |>
+    OptionExt.lift @@ fun a' ->
+    join a a'
+
+  | S_expand ({ ekind = E_var (v, _) }, vl)
+    when is_var_numeric_type v && List.for_all (function { ekind = E_var (v, _) } -> is_var_numeric_type v | _ -> false) vl
+    ->
+    List.fold_left (fun acc -> function
+        | { ekind = E_var (v', _) } -> bot_absorb1 (Dbm.expand (Dbm.Var v) (Dbm.Var v')) acc
+        | _ -> assert false
+      ) a vl |>
+    OptionExt.return
+
+  | S_fold ({ ekind = E_var (v, _) }, vl)
+    when is_var_numeric_type v && List.for_all (function { ekind = E_var (v, _) } -> is_var_numeric_type v | _ -> false) vl
+    ->
+    let vl = List.map (function
+        | { ekind = E_var (v, _) } -> v
+        | _ -> assert false
+      ) vl
+    in
+    (* [v] becomes the join of the renaming of each folded variable into [v] *)
+    let remove_all l a = List.fold_left (fun acc v -> forget_var v acc) a l in
+    let base = remove_all vl a in
+    List.fold_left (fun acc v' ->
+        let others = List.filter (fun v'' -> compare_var v'' v' <> 0) vl in
+        let a' =
+          remove_all (v :: others) a |>
+          bot_lift1 (Dbm.rename (Dbm.Var v') (Dbm.Var v))
+        in
+        join acc a'
+      ) base vl |>
+    OptionExt.return
+
+  | S_assume e when is_numeric_type (etyp e) ->
+    assume stmt man.ask a
+
+  | _ -> None
+
+
+(** {2 Queries} *)
+(** *********** *)
+
+let eval_interval e (a:t) : Itv.t option =
+  match a with
+  | BOT -> Some Itv.bottom
+  | Nb m ->
+    linearize (fun _ -> None) e m |>
+    OptionExt.lift (fun l -> Nb (linear_itv l m))
+
+let ask : type r. ('a,r) query -> ('a,t) simplified_man -> 'a ctx -> t -> r option =
+  fun query man ctx a ->
+    let a = close a in
+    match query with
+    | Q_avalue (e, Common.V_int_interval) ->
+      eval_interval e a
+
+    | Domain.Q_related_vars v ->
+      related_vars v a |>
+      OptionExt.return
+
+    | Domain.Q_constant_vars ->
+      constant_vars a |>
+      OptionExt.return
+
+    | _ -> None
+
+
+(** {2 Pretty printers} *)
+(** ******************* *)
+
+let pp fmt (a:t) = bot_fprint Dbm.print fmt a
+
+let print_state printer (a:t) =
+  unformat pp printer a ~path:[Key "numeric-relations"]
+
+let print_expr man ctx (a:t) printer exp =
+  match a with
+  | BOT -> ()
+  | Nb m ->
+    let vars = expr_vars exp |> List.filter is_tracked |> VarSet.of_list in
+    if VarSet.is_empty vars then ()
+    else
+      let vars' = VarSet.fold (fun v acc ->
+          related_vars v a |>
+          VarSet.of_list |>
+          VarSet.union acc
+        ) vars vars
+      in
+      let m' = Dbm.filter (function Dbm.Zero -> true | Dbm.Var v -> VarSet.mem v vars') m in
+      print_state printer (Nb m')
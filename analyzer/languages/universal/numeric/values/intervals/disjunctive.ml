@@ -0,0 +1,503 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Bounded disjunctions of integer intervals.
+
+    An abstract value is a sorted array of disjoint and non-adjacent
+    intervals. The number of intervals is bounded by a budget: when an
+    operation exceeds it, the two closest intervals are merged until the
+    budget is satisfied, instead of going to ⊤.
+*)
+
+open Mopsa
+open Ast
+open Bot
+open Sig.Abstraction.Simplified_value
+open Common
+
+
+module SimplifiedValue =
+struct
+
+  module I = ItvUtils.IntItv
+  module B = I.B
+
+
+  (** {2 Types} *)
+  (** ********* *)
+
+  (** Sorted array of disjoint and non-adjacent intervals. The empty array
+      represents ⊥. *)
+  type t = I.t array
+
+  include GenValueId(struct
+      type nonrec t = t
+      let name = "universal.numeric.values.intervals.disjunctive"
+      let display = "disj-itv"
+    end)
+
+
+  (** {2 Options} *)
+  (** *********** *)
+
+  let opt_max_disjuncts = ref 5
+
+  let () =
+    register_domain_option name {
+      key = "-max-itv-disjuncts";
+      category = "Numeric";
+      doc = " maximum number of intervals in a disjunction";
+      spec = ArgExt.Set_int opt_max_disjuncts;
+      default = string_of_int !opt_max_disjuncts;
+    }
+
+
+  (** {2 Normalization} *)
+  (** ***************** *)
+
+  (* Merge the closest pair of consecutive intervals until the budget is
+     satisfied. Intervals are sorted, so that the gaps between consecutive
+     intervals have finite bounds. *)
+  let rec bound (a:t) : t =
+    let n = Array.length a in
+    if n <= max 1 !opt_max_disjuncts then a
+    else
+      let gap i = B.sub (fst a.(i+1)) (snd a.(i)) in
+      let best = ref 0 in
+      for i = 1 to n - 2 do
+        if B.lt (gap i) (gap !best) then best := i
+      done;
+      let i = !best in
+      let a' = Array.make (n - 1) a.(0) in
+      Array.blit a 0 a' 0 i;
+      a'.(i) <- (fst a.(i), snd a.(i+1));
+      Array.blit a (i+2) a' (i+1) (n - i - 2);
+      bound a'
+
+  (* Coalesce a list of valid intervals sorted by lower bounds *)
+  let of_sorted_list (l:I.t list) : t =
+    let rec aux acc = function
+      | [] -> List.rev acc
+      | (lo,up) as itv :: tl ->
+        match acc with
+        | (lo',up') :: acc' when B.leq lo (B.succ up') ->
+          aux ((lo', B.max up up') :: acc') tl
+        | _ -> aux (itv :: acc) tl
+    in
+    aux [] l |>
+    Array.of_list |>
+    bound
+
+  (** Normalize a list of intervals *)
+  let of_list (l:I.t list) : t =
+    List.filter I.is_valid l |>
+    List.sort (fun (lo1,_) (lo2,_) -> B.compare lo1 lo2) |>
+    of_sorted_list
+
+  let of_bot (itv:I.t_with_bot) : t =
+    match itv with
+    | BOT -> [||]
+    | Nb itv -> of_list [itv]
+
+  let of_itv (itv:I.t) : t = of_list [itv]
+
+  (** Convex hull *)
+  let hull (a:t) : I.t_with_bot =
+    let n = Array.length a in
+    if n = 0 then BOT
+    else Nb (fst a.(0), snd a.(n-1))
+
+
+  (** {2 Lattice operators} *)
+  (** ********************* *)
+
+  let bottom : t = [||]
+
+  let top : t = [| I.minf_inf |]
+
+  let top_of_typ = function
+    | T_bool -> of_itv (I.of_int 0 1)
+    | _      -> top
+
+  let is_bottom (a:t) : bool = Array.length a = 0
+
+  let accept_type = function
+    | T_int | T_bool -> true
+    | _ -> false
+
+  let subset (a1:t) (a2:t) : bool =
+    a1 == a2 ||
+    let n2 = Array.length a2 in
+    (* Each interval of [a1] should be included in an interval of [a2] *)
+    let rec aux i j =
+      if i >= Array.length a1 then true
+      else if j >= n2 then false
+      else
+        let (lo1,up1) = a1.(i) and (lo2,up2) = a2.(j) in
+        if B.lt up2 lo1 then aux i (j+1)
+        else B.geq lo1 lo2 && B.leq up1 up2 && aux (i+1) j
+    in
+    aux 0 0
+
+  let join (a1:t) (a2:t) : t =
+    if a1 == a2 || is_bottom a2 then a1 else
+    if is_bottom a1 then a2 else
+      (* Merge the two sorted arrays, coalescing overlapping and adjacent
+         intervals on the fly *)
+      let n1 = Array.length a1 and n2 = Array.length a2 in
+      let r = Array.make (n1 + n2) a1.(0) in
+      let k = ref 0 in
+      let push ((lo,up) as itv) =
+        if !k > 0 && B.leq lo (B.succ (snd r.(!k-1))) then
+          let (lo',up') = r.(!k-1) in
+          r.(!k-1) <- (lo', B.max up up')
+        else (
+          r.(!k) <- itv;
+          incr k
+        )
+      in
+      let i = ref 0 and j = ref 0 in
+      while !i < n1 || !j < n2 do
+        if !j >= n2 || (!i < n1 && B.leq (fst a1.(!i)) (fst a2.(!j))) then (
+          push a1.(!i);
+          incr i
+        ) else (
+          push a2.(!j);
+          incr j
+        )
+      done;
+      bound (Array.sub r 0 !k)
+
+  let meet (a1:t) (a2:t) : t =
+    if a1 == a2 then a1 else
+      (* Intersect pairs of overlapping intervals *)
+      let rec aux acc i j =
+        if i >= Array.length a1 || j >= Array.length a2 then List.rev acc
+        else
+          let (_,up1) = a1.(i) and (_,up2) = a2.(j) in
+          let acc = match I.meet a1.(i) a2.(j) with
+            | BOT -> acc
+            | Nb itv -> itv :: acc
+          in
+          if B.lt up1 up2 then aux acc (i+1) j
+          else if B.lt up2 up1 then aux acc i (j+1)
+          else aux acc (i+1) (j+1)
+      in
+      aux [] 0 0 |>
+      Array.of_list |>
+      bound
+
+  (* The gaps of [a1] that are not present in [a2] are closed, and the
+     extremal bounds that grow are sent to the next widening threshold, or
+     to infinity. This ensures that the number of gaps is decreasing and
+     stabilizes. *)
+  let widen ctx (a1:t) (a2:t) : t =
+    if is_bottom a1 then a2 else
+    if subset a2 a1 then a1 else
+      let thresholds =
+        match find_ctx_opt Common.widening_thresholds_ctx_key ctx with
+        | None -> []
+        | Some s -> SetExt.ZSet.elements s |> List.map (fun n -> B.Finite n)
+      in
+      let widen_lo lo = List.filter (B.geq lo) thresholds |> List.fold_left B.max B.MINF in
+      let widen_up up = List.filter (B.leq up) thresholds |> List.fold_left B.min B.PINF in
+      let j = join a1 a2 in
+      let is_up b = Array.exists (fun (_,up) -> B.eq up b) a1 in
+      let is_lo b = Array.exists (fun (lo,_) -> B.eq lo b) a1 in
+      let n = Array.length j in
+      let rec aux acc i =
+        if i >= n then List.rev acc
+        else
+          match acc with
+          | (lo,up) :: acc' when not (is_up up && is_lo (fst j.(i))) ->
+            aux ((lo, snd j.(i)) :: acc') (i+1)
+          | _ -> aux (j.(i) :: acc) (i+1)
+      in
+      let l = aux [j.(0)] 1 |> Array.of_list in
+      let m = Array.length l in
+      let lo1,_ = a1.(0) and _,up1 = a1.(Array.length a1 - 1) in
+      let lo,up0 = l.(0) in
+      if B.lt lo lo1 then l.(0) <- (widen_lo lo, up0);
+      let lo0,up = l.(m-1) in
+      if B.gt up up1 then l.(m-1) <- (lo0, widen_up up);
+      l
+
+  let print printer (a:t) =
+    if is_bottom a then pp_string printer "⊥"
+    else
+      pp_string printer
+        (Array.to_list a |>
+         List.map I.to_string |>
+         String.concat " ∪ ")
+
+
+  (** {2 Lifting of interval operators} *)
+  (** ********************************* *)
+
+  let lift1 (f:I.t -> I.t) (a:t) : t =
+    Array.to_list a |>
+    List.map f |>
+    of_list
+
+  let absorb1 (f:I.t -> I.t_with_bot) (a:t) : t =
+    Array.fold_left (fun acc itv ->
+        match f itv with
+        | BOT -> acc
+        | Nb itv' -> itv' :: acc
+      ) [] a |>
+    of_list
+
+  let lift2 (f:I.t -> I.t -> I.t) (a1:t) (a2:t) : t =
+    Array.fold_left (fun acc itv1 ->
+        Array.fold_left (fun acc itv2 -> f itv1 itv2 :: acc) acc a2
+      ) [] a1 |>
+    of_list
+
+  let absorb2 (f:I.t -> I.t -> I.t_with_bot) (a1:t) (a2:t) : t =
+    Array.fold_left (fun acc itv1 ->
+        Array.fold_left (fun acc itv2 ->
+            match f itv1 itv2 with
+            | BOT -> acc
+            | Nb itv -> itv :: acc
+          ) acc a2
+      ) [] a1 |>
+    of_list
+
+  (* Apply a backward or filtering operator [f] on all pairs of intervals,
+     and join the refined arguments *)
+  let refine2 (f:I.t -> I.t -> (I.t*I.t) with_bot) (a1:t) (a2:t) : t * t =
+    let l1, l2 =
+      Array.fold_left (fun acc itv1 ->
+          Array.fold_left (fun (acc1,acc2) itv2 ->
+              match f itv1 itv2 with
+              | BOT -> acc1,acc2
+              | Nb (itv1',itv2') -> itv1' :: acc1, itv2' :: acc2
+            ) acc a2
+        ) ([],[]) a1
+    in
+    let b1 = of_list l1 and b2 = of_list l2 in
+    if is_bottom b1 || is_bottom b2 then bottom, bottom
+    else b1, b2
+
+  (* Remove an integer from a disjunction, possibly splitting an interval *)
+  let remove_int (n:Z.t) (a:t) : t =
+    let c = B.Finite n in
+    Array.fold_left (fun acc ((lo,up) as itv) ->
+        if B.lt c lo || B.gt c up then itv :: acc
+        else (B.succ c, up) :: (lo, B.pred c) :: acc
+      ) [] a |>
+    of_list
+
+  let is_singleton (a:t) : Z.t option =
+    match a with
+    | [| (B.Finite l, B.Finite u) |] when Z.equal l u -> Some l
+    | _ -> None
+
+
+  (** {2 Forward operators} *)
+  (** ********************* *)
+
+  let constant c t =
+    match c with
+    | C_bool true -> of_itv (I.cst_int 1)
+    | C_bool false -> of_itv (I.cst_int 0)
+    | C_top T_bool -> of_itv (I.of_int 0 1)
+    | C_int i -> of_itv (I.of_z i i)
+    | C_int_interval (i1,i2) -> of_itv (I.of_bound i1 i2)
+    | C_avalue(V_int_interval, itv) -> of_bot itv
+    | C_avalue(V_int_interval_fast, itv) -> of_bot itv
+    | _ -> top_of_typ t
+
+  let unop op t a tr =
+    if is_bottom a then bottom else
+    match op with
+    | O_log_not -> lift1 I.log_not a
+    | O_minus  -> lift1 I.neg a
+    | O_plus  -> a
+    | O_abs -> lift1 I.abs a
+    | O_wrap(l, u) -> lift1 (fun itv -> I.wrap itv l u) a
+    | O_bit_invert -> lift1 I.bit_not a
+    | _ -> top_of_typ tr
+
+  let binop op t1 a1 t2 a2 tr =
+    if is_bottom a1 || is_bottom a2 then bottom else
+    match op with
+    | O_plus   -> lift2 I.add a1 a2
+    | O_minus  -> lift2 I.sub a1 a2
+    | O_mult   -> lift2 I.mul a1 a2
+    | O_div    -> absorb2 I.div a1 a2
+    | O_ediv   -> absorb2 I.ediv a1 a2
+    | O_pow    -> lift2 I.pow a1 a2
+    | O_eq     -> lift2 I.log_eq a1 a2
+    | O_ne     -> lift2 I.log_neq a1 a2
+    | O_lt     -> lift2 I.log_lt a1 a2
+    | O_le     -> lift2 I.log_leq a1 a2
+    | O_gt     -> lift2 I.log_gt a1 a2
+    | O_ge     -> lift2 I.log_geq a1 a2
+    | O_log_or   -> lift2 I.log_or a1 a2
+    | O_log_and  -> lift2 I.log_and a1 a2
+    | O_log_xor -> lift2 I.log_xor a1 a2
+    | O_mod    -> absorb2 I.rem a1 a2
+    | O_erem   -> absorb2 I.erem a1 a2
+    | O_bit_and -> lift2 I.bit_and a1 a2
+    | O_bit_or -> lift2 I.bit_or a1 a2
+    | O_bit_xor -> lift2 I.bit_xor a1 a2
+    | O_bit_rshift -> absorb2 I.shift_right a1 a2
+    | O_bit_lshift -> absorb2 I.shift_left a1 a2
+    | _     -> top_of_typ tr
+
+  let filter b t a =
+    if b then remove_int Z.zero a
+    else meet a (of_itv I.zero)
+
+
+  (** {2 Backward operators} *)
+  (** ********************** *)
+
+  let backward_unop op t a tr r =
+    let f = match op with
+      | O_minus  -> I.bwd_neg
+      | O_wrap(l,u) -> (fun a r -> I.bwd_wrap a (l,u) r)
+      | O_bit_invert -> I.bwd_bit_not
+      | _ -> I.bwd_default_unary
+    in
+    fst (refine2 (fun itv ritv -> bot_lift1 (fun itv' -> itv',ritv) (f itv ritv)) a r)
+
+  let backward_binop op t1 a1 t2 a2 tr r =
+    if is_bottom a1 || is_bottom a2 || is_bottom r then bottom, bottom else
+    let f = match op with
+      | O_plus   -> I.bwd_add
+      | O_minus  -> I.bwd_sub
+      | O_mult   -> I.bwd_mul
+      | O_div    -> I.bwd_div
+      | O_ediv   -> I.bwd_ediv
+      | O_mod    -> I.bwd_rem
+      | O_erem   -> I.bwd_erem
+      | O_pow    -> I.bwd_pow
+      | O_eq     -> I.bwd_log_eq
+      | O_ne     -> I.bwd_log_neq
+      | O_lt     -> I.bwd_log_lt
+      | O_le     -> I.bwd_log_leq
+      | O_gt     -> I.bwd_log_gt
+      | O_ge     -> I.bwd_log_geq
+      | O_bit_and -> I.bwd_bit_and
+      | O_bit_or  -> I.bwd_bit_or
+      | O_bit_xor -> I.bwd_bit_xor
+      | O_bit_rshift -> I.bwd_shift_right
+      | O_bit_lshift -> I.bwd_shift_left
+      | _ -> Exceptions.panic "bwd_binop: unknown operator %a" pp_operator op
+    in
+    (* Refine each pair of intervals with each interval of the result *)
+    Array.fold_left (fun (acc1,acc2) ritv ->
+        let b1,b2 = refine2 (fun itv1 itv2 -> f itv1 itv2 ritv) a1 a2 in
+        join acc1 b1, join acc2 b2
+      ) (bottom,bottom) r
+
+
+  let compare op b t1 a1 t2 a2 =
+    if is_bottom a1 || is_bottom a2 then bottom, bottom else
+    let op = if b then op else negate_comparison_op op in
+    match op with
+    | O_eq ->
+      let a = meet a1 a2 in
+      if is_bottom a then bottom, bottom else a, a
+    | O_ne ->
+      (* Disequalities with singletons split intervals *)
+      let a1' = match is_singleton a2 with Some n -> remove_int n a1 | None -> a1 in
+      let a2' = match is_singleton a1 with Some n -> remove_int n a2 | None -> a2 in
+      if is_bottom a1' || is_bottom a2' then bottom, bottom else a1', a2'
+    | O_lt -> refine2 I.filter_lt a1 a2
+    | O_gt -> refine2 I.filter_gt a1 a2
+    | O_le -> refine2 I.filter_leq a1 a2
+    | O_ge -> refine2 I.filter_geq a1 a2
+    | _ -> Exceptions.panic "compare: unknown operator %a" pp_operator op
+
+  let avalue : type r. r avalue_kind -> t -> r option =
+    fun aval a ->
+    match aval with
+    | V_int_interval -> Some (hull a)
+    | V_int_interval_fast -> Some (hull a)
+    | V_int_congr_interval -> Some (hull a, Bot.Nb Common.C.minf_inf)
+    | _ -> None
+
+end
+
+
+(** We lift now to the advanced signature to handle casts *)
+open Sig.Abstraction.Value
+module Value =
+struct
+
+  include SimplifiedValue
+
+  module V = MakeValue(SimplifiedValue)
+
+  include V
+
+  (** Cast a non-integer value to an integer *)
+  let cast man e =
+    match e.etyp with
+    | T_float p ->
+      let v = man.eval e in
+      let float_itv = man.avalue (Common.V_float_interval p) v in
+      of_bot (ItvUtils.FloatItvNan.to_int_itv float_itv)
+
+    | _ -> top
+
+  (* Evaluation of integer expressions *)
+  let eval man e =
+    match ekind e with
+    | E_unop(O_cast,ee) -> cast man ee
+    | _ ->
+      let r = V.eval man e in
+      (* Ensure that boolean values are in [0,1] *)
+      match e.etyp with
+      | T_bool -> meet r (top_of_typ T_bool)
+      | _ -> r
+
+  (* Extended backward refinement of casts to integers. The float operand
+     is refined with the hull of the integer result. *)
+  let backward_ext_cast man e ve r =
+    match e.etyp with
+    | T_float p ->
+      begin match hull r with
+        | BOT -> None
+        | Nb iitv ->
+          let v,_ = find_vexpr e ve in
+          let fitv = man.avalue (Common.V_float_interval p) v in
+          let fitv' = ItvUtils.FloatItvNan.bwd_to_int_itv fitv iitv in
+          let v' = man.eval (mk_avalue_expr (Common.V_float_interval p) fitv' e.erange) in
+          refine_vexpr e (man.meet v v') ve |>
+          OptionExt.return
+      end
+    | _ -> None
+
+  (* Extended backward evaluations *)
+  let backward_ext man e ve r =
+    match ekind e with
+    | E_unop(O_cast,ee) -> backward_ext_cast man ee ve (man.get r)
+    | _ -> V.backward_ext man e ve r
+
+end
+
+
+let () =
+  register_value_abstraction (module Value)
@@ -57,6 +57,15 @@ struct
   let () =
     import_shared_option rounding_option_name name
 
+  let () =
+    register_domain_option name {
+      key = "-float-itv-eft";
+      category = "Numeric";
+      doc = " use error-free transformations instead of FPU rounding mode switches in double-precision interval operations with rounding mode rnd or on reals";
+      spec = ArgExt.Set FI.use_eft;
+      default = "false";
+    }
+
   let accept_type = function
     | T_float _ -> true
     | _ -> false
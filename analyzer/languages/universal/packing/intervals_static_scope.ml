@@ -35,6 +35,8 @@ struct
   let name = "reductions." ^ S.name
   let debug fmt = Debug.debug ~channel:name fmt
 
+  let trigger = None
+
   module I = Numeric.Values.Intervals.Integer.Value
   module M = Framework.Lattices.Partial_map
 
@@ -28,6 +28,8 @@ module Reduction =
 
     let name = "universal.toy.string_reduction"
 
+    let trigger = None
+
     let reduce exp _ _ _ results flow =
       let rec aux acc flow = function
         | [] -> Eval.singleton acc flow
@@ -0,0 +1,42 @@
+/*
+  mopsa-c alloc_budget_tests.c -default-alloc-pol=range_callstack_budget -alloc-site-budget=2 -unittest
+*/
+
+#include <stdlib.h>
+
+int *alloc() { return malloc(sizeof(int)); }
+int *alloc1() { return alloc(); }
+int *alloc2() { return alloc(); }
+int *alloc3() { return alloc(); }
+
+
+void test_partitions_within_budget() {
+  int *p = alloc1();
+  int *q = alloc2();
+  if (!p || !q) return;
+  *p = 1;
+  *q = 2;
+  _mopsa_assert(*p == 1);
+  _mopsa_assert(*q == 2);
+}
+
+
+void test_truncated_partitions_stay_valid() {
+  int *p = alloc1();
+  int *q = alloc2();
+  int *r = alloc3();
+  if (!p || !q || !r) return;
+  *p = 1;
+  *q = 2;
+  *r = 3;
+  _mopsa_assert_exists(*r == 3);
+  _mopsa_assert_safe();
+}
+
+
+void test_free_after_truncation() {
+  int *p = alloc3();
+  if (!p) return;
+  free(p);
+  _mopsa_assert_safe();
+}
@@ -0,0 +1,49 @@
+/*
+ * Tests of writes overlapping existing cells
+ */
+
+struct s {
+  char c;
+  int i;
+  short t;
+};
+
+
+void test_byte_write_keeps_neighbour_cells() {
+  int a[4] = {1, 2, 3, 4};
+  char *p = (char *)a;
+  p[5] = 0;
+  _mopsa_assert(a[0] == 1);
+  _mopsa_assert(a[2] == 3);
+  _mopsa_assert(a[3] == 4);
+}
+
+
+void test_int_write_keeps_neighbour_bytes() {
+  char b[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  int *q = (int *)(b + 2);
+  *q = 0;
+  _mopsa_assert(b[0] == 1);
+  _mopsa_assert(b[1] == 2);
+  _mopsa_assert(b[6] == 7);
+  _mopsa_assert(b[7] == 8);
+}
+
+
+void test_write_inside_field_keeps_other_fields() {
+  struct s x = {1, 2, 3};
+  char *p = (char *)&x.i;
+  p[1] = 5;
+  _mopsa_assert(x.c == 1);
+  _mopsa_assert(x.t == 3);
+}
+
+
+void test_overlapping_write_at_last_offset() {
+  int a[4] = {1, 2, 3, 4};
+  char *p = (char *)a;
+  p[15] = 0;
+  _mopsa_assert(a[0] == 1);
+  _mopsa_assert(a[1] == 2);
+  _mopsa_assert(a[2] == 3);
+}
@@ -0,0 +1,89 @@
+/*
+  mopsa-c cell_smash_tests.c -cell-smash-threshold=4 -unittest
+*/
+
+#include <stdlib.h>
+
+void init4(int *a) {
+  a[0] = 1;
+  a[1] = 2;
+  a[2] = 3;
+  a[3] = 4;
+}
+
+void test_writes_below_threshold_are_precise() {
+  int a[4];
+  init4(a);
+  a[1] = 7;
+  _mopsa_assert(a[0] == 1);
+  _mopsa_assert(a[1] == 7);
+  _mopsa_assert(a[3] == 4);
+}
+
+void test_reads_do_not_smash() {
+  int a[4];
+  init4(a);
+  char *p = (char *)a;
+  char c0 = p[0];
+  char c1 = p[1];
+  _mopsa_assert(a[0] == 1);
+  _mopsa_assert(a[3] == 4);
+}
+
+void test_write_beyond_threshold_summarizes() {
+  int a[5];
+  init4(a);
+  a[4] = 5;
+  int j = _mopsa_range_int(0, 4);
+  _mopsa_assert(a[j] >= 1 && a[j] <= 5);
+  _mopsa_assert(a[0] >= 1 && a[0] <= 5);
+}
+
+void test_range_write_summarizes_grown_base() {
+  int a[4];
+  init4(a);
+  char c = ((char *)a)[0];
+  int i = _mopsa_range_int(0, 3);
+  a[i] = 5;
+  int j = _mopsa_range_int(0, 3);
+  _mopsa_assert(a[j] >= 1 && a[j] <= 5);
+}
+
+void test_misaligned_read_of_summary() {
+  int a[5];
+  init4(a);
+  a[4] = 5;
+  int *q = (int *)((char *)a + 2);
+  int x = *q;
+  _mopsa_assert_exists(x == 0);
+}
+
+void test_write_of_other_type_in_smashed_base() {
+  int a[5];
+  init4(a);
+  a[4] = 5;
+  ((char *)a)[1] = 1;
+  _mopsa_assert_exists(a[0] == 0);
+}
+
+void test_join_with_unsmashed_base() {
+  int a[4];
+  init4(a);
+  char c = ((char *)a)[0];
+  if (_mopsa_rand_s8()) {
+    int i = _mopsa_range_int(0, 3);
+    a[i] = 5;
+  }
+  _mopsa_assert(a[0] >= 1 && a[0] <= 5);
+  _mopsa_assert(a[3] >= 1 && a[3] <= 5);
+}
+
+void test_smashed_heap_block() {
+  int *a = malloc(5 * sizeof(int));
+  if (a) {
+    init4(a);
+    a[4] = 5;
+    _mopsa_assert(a[2] >= 1 && a[2] <= 5);
+    free(a);
+  }
+}
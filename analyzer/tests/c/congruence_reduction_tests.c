@@ -0,0 +1,26 @@
+/*
+  mopsa-c congruence_reduction_tests.c -config c/cell-itv-congr.json -unittest
+*/
+
+#include "mopsa.h"
+
+void test_congruence_refines_interval() {
+  int x = 4 * _mopsa_range_int(1, 3) + 1;
+  if (x > 5) {
+    _mopsa_assert(x >= 9);
+  }
+}
+
+void test_bounds_are_reduced_after_filter() {
+  int x = 2 * _mopsa_range_int(0, 10);
+  if (x >= 5 && x <= 7) {
+    _mopsa_assert(x == 6);
+  }
+}
+
+void test_reduction_to_singleton() {
+  int x = 3 * _mopsa_range_int(0, 5);
+  if (x > 0 && x < 6) {
+    _mopsa_assert(x == 3);
+  }
+}
@@ -34,3 +34,29 @@ void test_unsafe_memcpy_on_overlapping_malloc_arrays() {
     _mopsa_assert_unsafe();
   }
 }
+
+void test_memcpy_copies_cells_to_fresh_block() {
+  char a[2] = {1,2};
+  char *p = (char*)malloc(2);
+  if (p) {
+    memcpy(p,a,2);
+    _mopsa_assert(p[0] == 1 && p[1] == 2);
+  }
+}
+
+void test_memcpy_keeps_previous_contents_of_weak_block() {
+  char a[2] = {1,2};
+  char *p = NULL, *q = NULL;
+  for (int i = 0; i < 2; i++) {
+    q = p;
+    p = (char*)malloc(2);
+    if (p) { p[0] = 5; p[1] = 5; }
+  }
+  if (q) {
+    /* q points to the summary of the previous allocations: the copy
+       updates only one of the summarized blocks */
+    memcpy(q,a,2);
+    _mopsa_assert_exists(q[0] == 1);
+    _mopsa_assert_exists(q[0] == 5);
+  }
+}
@@ -0,0 +1,30 @@
+/*
+ * Tests of the memset function
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+void test_memset_fills_cells_of_fresh_block() {
+  char *p = (char*)malloc(2);
+  if (p) {
+    p[0] = 5; p[1] = 5;
+    memset(p,0,2);
+    _mopsa_assert(p[0] == 0 && p[1] == 0);
+  }
+}
+
+void test_memset_keeps_previous_contents_of_weak_block() {
+  char *p = NULL, *q = NULL;
+  for (int i = 0; i < 2; i++) {
+    q = p;
+    p = (char*)malloc(2);
+    if (p) { p[0] = 5; p[1] = 5; }
+  }
+  if (q) {
+    /* q points to the summary of the previous allocations: the fill
+       updates only one of the summarized blocks */
+    memset(q,0,2);
+    _mopsa_assert_exists(q[0] == 5);
+  }
+}
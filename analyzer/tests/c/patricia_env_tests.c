@@ -0,0 +1,66 @@
+/*
+  mopsa-c patricia_env_tests.c -config c/cell-itv-patricia.json -unittest
+*/
+
+#include <stdlib.h>
+
+int g1 = 1;
+int g2 = 2;
+
+int add(int a, int b) {
+  int r = a + b;
+  return r;
+}
+
+void test_globals_and_locals() {
+  int x = 10;
+  int y = x + g1;
+  _mopsa_assert(y == 11);
+  g2 = y;
+  _mopsa_assert(g2 == 11);
+}
+
+void test_calls_reuse_parameters() {
+  int a = add(1, 2);
+  int b = add(a, 3);
+  _mopsa_assert(a == 3);
+  _mopsa_assert(b == 6);
+}
+
+void set_first(int t[4]) {
+  t[0] = 5;
+  _mopsa_assert(t[0] == 5);
+}
+
+void test_array_parameter_call() {
+  int t[4];
+  set_first(t);
+  _mopsa_assert(t[0] == 5);
+}
+
+void test_shadowed_variables() {
+  int x = 1;
+  {
+    int x = 2;
+    _mopsa_assert(x == 2);
+  }
+  _mopsa_assert(x == 1);
+}
+
+void test_loop_temporaries() {
+  int s = 0;
+  for (int i = 0; i < 10; i++) {
+    int t = i;
+    s = t;
+  }
+  _mopsa_assert(s >= 0 && s <= 9);
+}
+
+void test_heap_cells() {
+  int *p = malloc(2 * sizeof(int));
+  if (p == NULL) return;
+  p[0] = 1;
+  p[1] = 2;
+  _mopsa_assert(p[0] + p[1] == 3);
+  free(p);
+}
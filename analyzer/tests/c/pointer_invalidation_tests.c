@@ -0,0 +1,44 @@
+#include <stdlib.h>
+
+/*
+ * Tests of the invalidation of pointers to freed and renamed bases
+ */
+
+
+void test_aliases_of_freed_base_are_invalid() {
+  int *p = malloc(sizeof(int));
+  if (p) {
+    int *q = p;
+    free(p);
+    *q = 1;
+    _mopsa_assert_unsafe();
+  }
+}
+
+
+void test_pointers_to_other_bases_are_kept() {
+  int x = 0;
+  int *r = &x;
+  int *p = malloc(sizeof(int));
+  if (p) {
+    free(p);
+    *r = 1;
+    _mopsa_assert(x == 1);
+    _mopsa_assert_safe();
+  }
+}
+
+
+void test_pointers_follow_renamed_bases() {
+  int *p = NULL;
+  int *q = NULL;
+  for (int i = 0; i < 3; i++) {
+    q = p;
+    p = malloc(sizeof(int));
+    if (!p) return;
+  }
+  *p = 1;
+  if (q) *q = 2;
+  _mopsa_assert(*p == 1);
+  _mopsa_assert_safe();
+}
@@ -0,0 +1,42 @@
+/*
+  mopsa-c pre_points_to_tests.c -c-pre-points-to -unittest
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+
+int called = 0;
+
+void mark() { called = 1; }
+
+void (*table[1024])() = { mark };
+
+void test_call_through_unknown_entry_of_table() {
+  int i = _mopsa_range_int(0, 1023);
+  void (*f)() = table[i];
+  called = 0;
+  if (f) {
+    f();
+    _mopsa_assert_exists(called == 1);
+  }
+}
+
+void test_call_through_null_pointer_is_not_resolved() {
+  void (*f)() = mark;
+  f = NULL;
+  called = 0;
+  f();
+  _mopsa_assert(called == 0);
+}
+
+void test_call_through_table_with_heap_entries_is_not_resolved() {
+  void *t[4] = { mark, NULL, NULL, NULL };
+  t[1] = malloc(4);
+  int i = _mopsa_range_int(0, 3);
+  void (*f)() = (void (*)()) t[i];
+  called = 0;
+  if (f) {
+    f();
+    _mopsa_assert_exists(called == 0);
+  }
+}
@@ -0,0 +1,118 @@
+/*
+  mopsa-c string_loops_tests.c -config c/cell-string-length-itv.json -c-summarize-string-loops -unittest
+*/
+
+#include <string.h>
+
+const char* s = "toto";
+
+
+/* Scan loops */
+/* ********** */
+
+void test_scan_pointer() {
+  char buf[100];
+  strcpy(buf, s);
+  char *p = buf;
+  while (*p) p++;
+  _mopsa_assert_safe();
+  _mopsa_assert(*p == 0);
+  _mopsa_assert(p - buf == 4);
+}
+
+void test_scan_index() {
+  char buf[100];
+  strcpy(buf, s);
+  int i = 0;
+  while (buf[i]) i++;
+  _mopsa_assert_safe();
+  _mopsa_assert(buf[i] == 0);
+  _mopsa_assert(i == 4);
+}
+
+void test_scan_without_terminator_is_unsafe() {
+  char buf[4] = {'a', 'b', 'c', 'd'};
+  char *p = buf;
+  while (*p) p++;
+  _mopsa_assert_unsafe();
+}
+
+
+/* Copy loops */
+/* ********** */
+
+void test_copy() {
+  char src[100];
+  char dst[100];
+  strcpy(src, s);
+  char *d = dst;
+  char *q = src;
+  while ((*d++ = *q++) != 0);
+  _mopsa_assert_safe();
+  _mopsa_assert(strlen(dst) == 4);
+  _mopsa_assert(d - dst == 5);
+}
+
+void test_copy_into_smaller_buffer_is_unsafe() {
+  char src[100];
+  char dst[2];
+  strcpy(src, s);
+  char *d = dst;
+  char *q = src;
+  while ((*d++ = *q++) != 0);
+  _mopsa_assert_unsafe();
+}
+
+void test_copy_within_same_buffer() {
+  char buf[100];
+  strcpy(buf, s);
+  char *d = buf;
+  char *q = buf + 1;
+  /* Overlapping buffers: the loop is not summarized */
+  while ((*d++ = *q++) != 0);
+  _mopsa_assert_exists(buf[0] == 'o');
+  _mopsa_assert_exists(strlen(buf) == 3);
+}
+
+
+/* Fill loops */
+/* ********** */
+
+void test_fill() {
+  char buf[100];
+  int n = _mopsa_range_int(1, 99);
+  for (int i = 0; i < n; i++) buf[i] = 'a';
+  buf[n] = 0;
+  _mopsa_assert_safe();
+  _mopsa_assert(strlen(buf) == n);
+}
+
+void test_fill_without_iteration() {
+  char buf[100];
+  strcpy(buf, s);
+  int i = 10;
+  while (i < 5) { buf[i] = 0; i++; }
+  _mopsa_assert(i == 10);
+  _mopsa_assert(strlen(buf) == 4);
+}
+
+void test_fill_out_of_bounds_is_unsafe() {
+  char buf[10];
+  int n = _mopsa_range_int(1, 20);
+  for (int i = 0; i < n; i++) buf[i] = 'a';
+  _mopsa_assert_unsafe();
+}
+
+
+/* Loops that are not idioms */
+/* ************************* */
+
+void test_scan_with_other_statement() {
+  char buf[100];
+  strcpy(buf, s);
+  char *p = buf;
+  int k = 0;
+  while (*p) { p++; k++; }
+  _mopsa_assert(*p == 0);
+  _mopsa_assert(strlen(buf) == 4);
+}
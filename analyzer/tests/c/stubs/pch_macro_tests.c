@@ -0,0 +1,44 @@
+/*
+  mopsa-c pch_macro_tests.c -c-pch -unittest
+*/
+
+#include <stddef.h>
+#include <limits.h>
+
+/* Test macros of a precompiled header */
+/* *********************************** */
+
+/*$
+ * requires: ptr != NULL;
+ * ensures : return == *ptr;
+ */
+int deref(int *ptr);
+
+/*$
+ * ensures: return == INT_MAX;
+ */
+int int_max();
+
+#define TEN 10
+
+/*$
+ * ensures: return == TEN;
+ */
+int ten();
+
+void test_null_macro_of_precompiled_header() {
+  int x = 100;
+  int y = deref(&x);
+  _mopsa_assert_safe();
+  _mopsa_assert(y == x);
+}
+
+void test_limit_macro_of_precompiled_header() {
+  int n = int_max();
+  _mopsa_assert(n == INT_MAX);
+}
+
+void test_macro_of_file() {
+  int n = ten();
+  _mopsa_assert(n == TEN);
+}
@@ -0,0 +1,31 @@
+# mopsa-python gc_tests.py -gc -gc-minor-threshold=4 -gc-major-growth=50 -unittest
+
+import mopsa
+
+class A:
+    def __init__(self, x):
+        self.x = x
+
+def make(x):
+    return A(x)
+
+def test_young_objects_survive_collections():
+    l = []
+    for i in range(10):
+        l.append(make(i))
+    a = make(1)
+    b = make(2)
+    mopsa.assert_equal(a.x, 1)
+    mopsa.assert_equal(b.x, 2)
+
+def test_overwritten_objects():
+    a = make(1)
+    a = make(2)
+    a = make(3)
+    mopsa.assert_equal(a.x, 3)
+
+def test_objects_kept_by_attributes():
+    a = make(make(5))
+    for i in range(5):
+        make(i)
+    mopsa.assert_equal(a.x.x, 5)
@@ -0,0 +1,17 @@
+#include <string.h>
+
+#ifndef N
+#define N 16
+#endif
+
+int main() {
+  char src[N];
+  char dst[N];
+  char str[N];
+  for (int i = 0; i < N; i++) src[i] = i % 64;
+  memset(dst, 0, N);
+  memcpy(dst, src, N);
+  strcpy(str, "block copy");
+  _mopsa_print();
+  return dst[N - 1];
+}
@@ -0,0 +1,24 @@
+#!/bin/sh
+# Compare the summarized transfer functions of memcpy, memset and strcpy
+# with the element-wise interpretation of their stubs, on buffers of
+# increasing sizes.
+#
+# Usage: ./run.sh [mopsa options...]
+#
+# The element-wise interpretation is obtained with
+# -stub-use-forall-loop-evaluation, which evaluates universally quantified
+# formulas with loops. The analysis time is reported for each size.
+
+prog=$(dirname "$0")/block_copy.c
+
+for n in 16 64 256 1024 4096; do
+    for mode in summarized elementwise; do
+        case $mode in
+            summarized) opt= ;;
+            elementwise) opt=-stub-use-forall-loop-evaluation ;;
+        esac
+        echo "== N=$n $mode"
+        mopsa-c -config=c/cell-string-length-itv.json -ccopt="-DN=$n" $opt -no-warning "$@" "$prog" 2>&1 |
+            grep -E 'Analysis time|alarm'
+    done
+done
@@ -0,0 +1,20 @@
+#!/bin/sh
+# Measure the cost of pointer dereferences with non-constant offsets in
+# the cells domain, on arrays with many cells.
+#
+# Usage: ./run.sh [program.c...]
+#
+# Each program is analyzed with increasing values of -cell-deref-expand,
+# so that dereferences are expanded into more and more cells. The analysis
+# time is reported for each run.
+
+dir=$(dirname "$0")
+progs=${*:-"$dir/../examples/memcpy.c $dir/../examples/struct_array.c $dir/../examples/memcpy_large.c $dir/../examples/struct_array_large.c"}
+
+for prog in $progs; do
+    for expand in 1 8 64 512; do
+        echo "== $prog -cell-deref-expand=$expand"
+        mopsa-c -config=c/cell-itv.json -cell-deref-expand="$expand" -no-warning "$prog" 2>&1 |
+            grep -E 'Analysis time|alarm'
+    done
+done
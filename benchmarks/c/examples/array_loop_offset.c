@@ -0,0 +1,11 @@
+int a[100];
+int b[110];
+
+void main() {
+  int n = _mopsa_range_int(0, 100);
+  int i, j = 10;
+  for(i = 0; i < n; i++) {
+    b[j] = a[i];
+    j++;
+  }
+}
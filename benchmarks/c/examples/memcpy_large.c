@@ -0,0 +1,13 @@
+#include <string.h>
+
+#define N 4096
+
+int main(int argc, char *argv[]) {
+  char a[N];
+  char b[N];
+  for (int i = 0; i < N; i++) a[i] = i % 128;
+  memcpy(b, a, N);
+  for (int i = 0; i < N; i += 64) b[i] = a[N - 1 - i];
+  _mopsa_print();
+  return 0;
+}
@@ -0,0 +1,32 @@
+#include <stdlib.h>
+
+#ifndef N
+#define N 64
+#endif
+
+/* N live pointers to distinct blocks, and a loop allocating and freeing
+   a short-lived block. Each free only invalidates the pointers to the
+   freed block. */
+
+struct node {
+  int value;
+  struct node *next;
+};
+
+int main() {
+  struct node *live[N];
+  for (int i = 0; i < N; i++) {
+    live[i] = malloc(sizeof(struct node));
+    if (!live[i]) return 1;
+    live[i]->value = i;
+    live[i]->next = NULL;
+  }
+  for (int k = 0; k < 100; k++) {
+    struct node *tmp = malloc(sizeof(struct node));
+    if (!tmp) return 1;
+    tmp->value = k;
+    tmp->next = live[0];
+    free(tmp);
+  }
+  return live[N - 1]->value;
+}
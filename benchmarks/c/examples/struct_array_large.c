@@ -0,0 +1,19 @@
+typedef struct {
+   int    x;
+   int    y;
+} point;
+
+#define N 1024
+
+int main () {
+  point e[N];
+  for (int i = 0; i < N; i++) {
+    (e[i]).x = i;
+    (e[i]).y = -i;
+  }
+  int* p = &(e[N/2].y);
+  for (int k = 0; k < 8; k++) {
+    *(p - k) = k;
+  }
+  return e[N/2].x;
+}
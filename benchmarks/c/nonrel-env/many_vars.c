@@ -0,0 +1,816 @@
+/*
+ * Stress test for the environments of non-relational domains.
+ *
+ * The program manipulates a large number of scalar variables in a loop
+ * with many branches. Each branch modifies only a few variables, so that
+ * the environments joined at the end of each conditional share most of
+ * their bindings. Generated with N = 400.
+ */
+
+int x0;
+int x1;
+int x2;
+int x3;
+int x4;
+int x5;
+int x6;
+int x7;
+int x8;
+int x9;
+int x10;
+int x11;
+int x12;
+int x13;
+int x14;
+int x15;
+int x16;
+int x17;
+int x18;
+int x19;
+int x20;
+int x21;
+int x22;
+int x23;
+int x24;
+int x25;
+int x26;
+int x27;
+int x28;
+int x29;
+int x30;
+int x31;
+int x32;
+int x33;
+int x34;
+int x35;
+int x36;
+int x37;
+int x38;
+int x39;
+int x40;
+int x41;
+int x42;
+int x43;
+int x44;
+int x45;
+int x46;
+int x47;
+int x48;
+int x49;
+int x50;
+int x51;
+int x52;
+int x53;
+int x54;
+int x55;
+int x56;
+int x57;
+int x58;
+int x59;
+int x60;
+int x61;
+int x62;
+int x63;
+int x64;
+int x65;
+int x66;
+int x67;
+int x68;
+int x69;
+int x70;
+int x71;
+int x72;
+int x73;
+int x74;
+int x75;
+int x76;
+int x77;
+int x78;
+int x79;
+int x80;
+int x81;
+int x82;
+int x83;
+int x84;
+int x85;
+int x86;
+int x87;
+int x88;
+int x89;
+int x90;
+int x91;
+int x92;
+int x93;
+int x94;
+int x95;
+int x96;
+int x97;
+int x98;
+int x99;
+int x100;
+int x101;
+int x102;
+int x103;
+int x104;
+int x105;
+int x106;
+int x107;
+int x108;
+int x109;
+int x110;
+int x111;
+int x112;
+int x113;
+int x114;
+int x115;
+int x116;
+int x117;
+int x118;
+int x119;
+int x120;
+int x121;
+int x122;
+int x123;
+int x124;
+int x125;
+int x126;
+int x127;
+int x128;
+int x129;
+int x130;
+int x131;
+int x132;
+int x133;
+int x134;
+int x135;
+int x136;
+int x137;
+int x138;
+int x139;
+int x140;
+int x141;
+int x142;
+int x143;
+int x144;
+int x145;
+int x146;
+int x147;
+int x148;
+int x149;
+int x150;
+int x151;
+int x152;
+int x153;
+int x154;
+int x155;
+int x156;
+int x157;
+int x158;
+int x159;
+int x160;
+int x161;
+int x162;
+int x163;
+int x164;
+int x165;
+int x166;
+int x167;
+int x168;
+int x169;
+int x170;
+int x171;
+int x172;
+int x173;
+int x174;
+int x175;
+int x176;
+int x177;
+int x178;
+int x179;
+int x180;
+int x181;
+int x182;
+int x183;
+int x184;
+int x185;
+int x186;
+int x187;
+int x188;
+int x189;
+int x190;
+int x191;
+int x192;
+int x193;
+int x194;
+int x195;
+int x196;
+int x197;
+int x198;
+int x199;
+int x200;
+int x201;
+int x202;
+int x203;
+int x204;
+int x205;
+int x206;
+int x207;
+int x208;
+int x209;
+int x210;
+int x211;
+int x212;
+int x213;
+int x214;
+int x215;
+int x216;
+int x217;
+int x218;
+int x219;
+int x220;
+int x221;
+int x222;
+int x223;
+int x224;
+int x225;
+int x226;
+int x227;
+int x228;
+int x229;
+int x230;
+int x231;
+int x232;
+int x233;
+int x234;
+int x235;
+int x236;
+int x237;
+int x238;
+int x239;
+int x240;
+int x241;
+int x242;
+int x243;
+int x244;
+int x245;
+int x246;
+int x247;
+int x248;
+int x249;
+int x250;
+int x251;
+int x252;
+int x253;
+int x254;
+int x255;
+int x256;
+int x257;
+int x258;
+int x259;
+int x260;
+int x261;
+int x262;
+int x263;
+int x264;
+int x265;
+int x266;
+int x267;
+int x268;
+int x269;
+int x270;
+int x271;
+int x272;
+int x273;
+int x274;
+int x275;
+int x276;
+int x277;
+int x278;
+int x279;
+int x280;
+int x281;
+int x282;
+int x283;
+int x284;
+int x285;
+int x286;
+int x287;
+int x288;
+int x289;
+int x290;
+int x291;
+int x292;
+int x293;
+int x294;
+int x295;
+int x296;
+int x297;
+int x298;
+int x299;
+int x300;
+int x301;
+int x302;
+int x303;
+int x304;
+int x305;
+int x306;
+int x307;
+int x308;
+int x309;
+int x310;
+int x311;
+int x312;
+int x313;
+int x314;
+int x315;
+int x316;
+int x317;
+int x318;
+int x319;
+int x320;
+int x321;
+int x322;
+int x323;
+int x324;
+int x325;
+int x326;
+int x327;
+int x328;
+int x329;
+int x330;
+int x331;
+int x332;
+int x333;
+int x334;
+int x335;
+int x336;
+int x337;
+int x338;
+int x339;
+int x340;
+int x341;
+int x342;
+int x343;
+int x344;
+int x345;
+int x346;
+int x347;
+int x348;
+int x349;
+int x350;
+int x351;
+int x352;
+int x353;
+int x354;
+int x355;
+int x356;
+int x357;
+int x358;
+int x359;
+int x360;
+int x361;
+int x362;
+int x363;
+int x364;
+int x365;
+int x366;
+int x367;
+int x368;
+int x369;
+int x370;
+int x371;
+int x372;
+int x373;
+int x374;
+int x375;
+int x376;
+int x377;
+int x378;
+int x379;
+int x380;
+int x381;
+int x382;
+int x383;
+int x384;
+int x385;
+int x386;
+int x387;
+int x388;
+int x389;
+int x390;
+int x391;
+int x392;
+int x393;
+int x394;
+int x395;
+int x396;
+int x397;
+int x398;
+int x399;
+
+int main(int argc, char *argv[]) {
+  int i;
+  for (i = 0; i < 100; i++) {
+    if (argc > 0) x0 = x7 + 0; else x0 = x0 - 1;
+    if (argc > 1) x1 = x38 + 1; else x1 = x1 - 1;
+    if (argc > 2) x2 = x69 + 2; else x2 = x2 - 1;
+    if (argc > 3) x3 = x100 + 3; else x3 = x3 - 1;
+    if (argc > 4) x4 = x131 + 4; else x4 = x4 - 1;
+    if (argc > 5) x5 = x162 + 5; else x5 = x5 - 1;
+    if (argc > 6) x6 = x193 + 6; else x6 = x6 - 1;
+    if (argc > 0) x7 = x224 + 7; else x7 = x7 - 1;
+    if (argc > 1) x8 = x255 + 8; else x8 = x8 - 1;
+    if (argc > 2) x9 = x286 + 9; else x9 = x9 - 1;
+    if (argc > 3) x10 = x317 + 10; else x10 = x10 - 1;
+    if (argc > 4) x11 = x348 + 11; else x11 = x11 - 1;
+    if (argc > 5) x12 = x379 + 12; else x12 = x12 - 1;
+    if (argc > 6) x13 = x10 + 0; else x13 = x13 - 1;
+    if (argc > 0) x14 = x41 + 1; else x14 = x14 - 1;
+    if (argc > 1) x15 = x72 + 2; else x15 = x15 - 1;
+    if (argc > 2) x16 = x103 + 3; else x16 = x16 - 1;
+    if (argc > 3) x17 = x134 + 4; else x17 = x17 - 1;
+    if (argc > 4) x18 = x165 + 5; else x18 = x18 - 1;
+    if (argc > 5) x19 = x196 + 6; else x19 = x19 - 1;
+    if (argc > 6) x20 = x227 + 7; else x20 = x20 - 1;
+    if (argc > 0) x21 = x258 + 8; else x21 = x21 - 1;
+    if (argc > 1) x22 = x289 + 9; else x22 = x22 - 1;
+    if (argc > 2) x23 = x320 + 10; else x23 = x23 - 1;
+    if (argc > 3) x24 = x351 + 11; else x24 = x24 - 1;
+    if (argc > 4) x25 = x382 + 12; else x25 = x25 - 1;
+    if (argc > 5) x26 = x13 + 0; else x26 = x26 - 1;
+    if (argc > 6) x27 = x44 + 1; else x27 = x27 - 1;
+    if (argc > 0) x28 = x75 + 2; else x28 = x28 - 1;
+    if (argc > 1) x29 = x106 + 3; else x29 = x29 - 1;
+    if (argc > 2) x30 = x137 + 4; else x30 = x30 - 1;
+    if (argc > 3) x31 = x168 + 5; else x31 = x31 - 1;
+    if (argc > 4) x32 = x199 + 6; else x32 = x32 - 1;
+    if (argc > 5) x33 = x230 + 7; else x33 = x33 - 1;
+    if (argc > 6) x34 = x261 + 8; else x34 = x34 - 1;
+    if (argc > 0) x35 = x292 + 9; else x35 = x35 - 1;
+    if (argc > 1) x36 = x323 + 10; else x36 = x36 - 1;
+    if (argc > 2) x37 = x354 + 11; else x37 = x37 - 1;
+    if (argc > 3) x38 = x385 + 12; else x38 = x38 - 1;
+    if (argc > 4) x39 = x16 + 0; else x39 = x39 - 1;
+    if (argc > 5) x40 = x47 + 1; else x40 = x40 - 1;
+    if (argc > 6) x41 = x78 + 2; else x41 = x41 - 1;
+    if (argc > 0) x42 = x109 + 3; else x42 = x42 - 1;
+    if (argc > 1) x43 = x140 + 4; else x43 = x43 - 1;
+    if (argc > 2) x44 = x171 + 5; else x44 = x44 - 1;
+    if (argc > 3) x45 = x202 + 6; else x45 = x45 - 1;
+    if (argc > 4) x46 = x233 + 7; else x46 = x46 - 1;
+    if (argc > 5) x47 = x264 + 8; else x47 = x47 - 1;
+    if (argc > 6) x48 = x295 + 9; else x48 = x48 - 1;
+    if (argc > 0) x49 = x326 + 10; else x49 = x49 - 1;
+    if (argc > 1) x50 = x357 + 11; else x50 = x50 - 1;
+    if (argc > 2) x51 = x388 + 12; else x51 = x51 - 1;
+    if (argc > 3) x52 = x19 + 0; else x52 = x52 - 1;
+    if (argc > 4) x53 = x50 + 1; else x53 = x53 - 1;
+    if (argc > 5) x54 = x81 + 2; else x54 = x54 - 1;
+    if (argc > 6) x55 = x112 + 3; else x55 = x55 - 1;
+    if (argc > 0) x56 = x143 + 4; else x56 = x56 - 1;
+    if (argc > 1) x57 = x174 + 5; else x57 = x57 - 1;
+    if (argc > 2) x58 = x205 + 6; else x58 = x58 - 1;
+    if (argc > 3) x59 = x236 + 7; else x59 = x59 - 1;
+    if (argc > 4) x60 = x267 + 8; else x60 = x60 - 1;
+    if (argc > 5) x61 = x298 + 9; else x61 = x61 - 1;
+    if (argc > 6) x62 = x329 + 10; else x62 = x62 - 1;
+    if (argc > 0) x63 = x360 + 11; else x63 = x63 - 1;
+    if (argc > 1) x64 = x391 + 12; else x64 = x64 - 1;
+    if (argc > 2) x65 = x22 + 0; else x65 = x65 - 1;
+    if (argc > 3) x66 = x53 + 1; else x66 = x66 - 1;
+    if (argc > 4) x67 = x84 + 2; else x67 = x67 - 1;
+    if (argc > 5) x68 = x115 + 3; else x68 = x68 - 1;
+    if (argc > 6) x69 = x146 + 4; else x69 = x69 - 1;
+    if (argc > 0) x70 = x177 + 5; else x70 = x70 - 1;
+    if (argc > 1) x71 = x208 + 6; else x71 = x71 - 1;
+    if (argc > 2) x72 = x239 + 7; else x72 = x72 - 1;
+    if (argc > 3) x73 = x270 + 8; else x73 = x73 - 1;
+    if (argc > 4) x74 = x301 + 9; else x74 = x74 - 1;
+    if (argc > 5) x75 = x332 + 10; else x75 = x75 - 1;
+    if (argc > 6) x76 = x363 + 11; else x76 = x76 - 1;
+    if (argc > 0) x77 = x394 + 12; else x77 = x77 - 1;
+    if (argc > 1) x78 = x25 + 0; else x78 = x78 - 1;
+    if (argc > 2) x79 = x56 + 1; else x79 = x79 - 1;
+    if (argc > 3) x80 = x87 + 2; else x80 = x80 - 1;
+    if (argc > 4) x81 = x118 + 3; else x81 = x81 - 1;
+    if (argc > 5) x82 = x149 + 4; else x82 = x82 - 1;
+    if (argc > 6) x83 = x180 + 5; else x83 = x83 - 1;
+    if (argc > 0) x84 = x211 + 6; else x84 = x84 - 1;
+    if (argc > 1) x85 = x242 + 7; else x85 = x85 - 1;
+    if (argc > 2) x86 = x273 + 8; else x86 = x86 - 1;
+    if (argc > 3) x87 = x304 + 9; else x87 = x87 - 1;
+    if (argc > 4) x88 = x335 + 10; else x88 = x88 - 1;
+    if (argc > 5) x89 = x366 + 11; else x89 = x89 - 1;
+    if (argc > 6) x90 = x397 + 12; else x90 = x90 - 1;
+    if (argc > 0) x91 = x28 + 0; else x91 = x91 - 1;
+    if (argc > 1) x92 = x59 + 1; else x92 = x92 - 1;
+    if (argc > 2) x93 = x90 + 2; else x93 = x93 - 1;
+    if (argc > 3) x94 = x121 + 3; else x94 = x94 - 1;
+    if (argc > 4) x95 = x152 + 4; else x95 = x95 - 1;
+    if (argc > 5) x96 = x183 + 5; else x96 = x96 - 1;
+    if (argc > 6) x97 = x214 + 6; else x97 = x97 - 1;
+    if (argc > 0) x98 = x245 + 7; else x98 = x98 - 1;
+    if (argc > 1) x99 = x276 + 8; else x99 = x99 - 1;
+    if (argc > 2) x100 = x307 + 9; else x100 = x100 - 1;
+    if (argc > 3) x101 = x338 + 10; else x101 = x101 - 1;
+    if (argc > 4) x102 = x369 + 11; else x102 = x102 - 1;
+    if (argc > 5) x103 = x0 + 12; else x103 = x103 - 1;
+    if (argc > 6) x104 = x31 + 0; else x104 = x104 - 1;
+    if (argc > 0) x105 = x62 + 1; else x105 = x105 - 1;
+    if (argc > 1) x106 = x93 + 2; else x106 = x106 - 1;
+    if (argc > 2) x107 = x124 + 3; else x107 = x107 - 1;
+    if (argc > 3) x108 = x155 + 4; else x108 = x108 - 1;
+    if (argc > 4) x109 = x186 + 5; else x109 = x109 - 1;
+    if (argc > 5) x110 = x217 + 6; else x110 = x110 - 1;
+    if (argc > 6) x111 = x248 + 7; else x111 = x111 - 1;
+    if (argc > 0) x112 = x279 + 8; else x112 = x112 - 1;
+    if (argc > 1) x113 = x310 + 9; else x113 = x113 - 1;
+    if (argc > 2) x114 = x341 + 10; else x114 = x114 - 1;
+    if (argc > 3) x115 = x372 + 11; else x115 = x115 - 1;
+    if (argc > 4) x116 = x3 + 12; else x116 = x116 - 1;
+    if (argc > 5) x117 = x34 + 0; else x117 = x117 - 1;
+    if (argc > 6) x118 = x65 + 1; else x118 = x118 - 1;
+    if (argc > 0) x119 = x96 + 2; else x119 = x119 - 1;
+    if (argc > 1) x120 = x127 + 3; else x120 = x120 - 1;
+    if (argc > 2) x121 = x158 + 4; else x121 = x121 - 1;
+    if (argc > 3) x122 = x189 + 5; else x122 = x122 - 1;
+    if (argc > 4) x123 = x220 + 6; else x123 = x123 - 1;
+    if (argc > 5) x124 = x251 + 7; else x124 = x124 - 1;
+    if (argc > 6) x125 = x282 + 8; else x125 = x125 - 1;
+    if (argc > 0) x126 = x313 + 9; else x126 = x126 - 1;
+    if (argc > 1) x127 = x344 + 10; else x127 = x127 - 1;
+    if (argc > 2) x128 = x375 + 11; else x128 = x128 - 1;
+    if (argc > 3) x129 = x6 + 12; else x129 = x129 - 1;
+    if (argc > 4) x130 = x37 + 0; else x130 = x130 - 1;
+    if (argc > 5) x131 = x68 + 1; else x131 = x131 - 1;
+    if (argc > 6) x132 = x99 + 2; else x132 = x132 - 1;
+    if (argc > 0) x133 = x130 + 3; else x133 = x133 - 1;
+    if (argc > 1) x134 = x161 + 4; else x134 = x134 - 1;
+    if (argc > 2) x135 = x192 + 5; else x135 = x135 - 1;
+    if (argc > 3) x136 = x223 + 6; else x136 = x136 - 1;
+    if (argc > 4) x137 = x254 + 7; else x137 = x137 - 1;
+    if (argc > 5) x138 = x285 + 8; else x138 = x138 - 1;
+    if (argc > 6) x139 = x316 + 9; else x139 = x139 - 1;
+    if (argc > 0) x140 = x347 + 10; else x140 = x140 - 1;
+    if (argc > 1) x141 = x378 + 11; else x141 = x141 - 1;
+    if (argc > 2) x142 = x9 + 12; else x142 = x142 - 1;
+    if (argc > 3) x143 = x40 + 0; else x143 = x143 - 1;
+    if (argc > 4) x144 = x71 + 1; else x144 = x144 - 1;
+    if (argc > 5) x145 = x102 + 2; else x145 = x145 - 1;
+    if (argc > 6) x146 = x133 + 3; else x146 = x146 - 1;
+    if (argc > 0) x147 = x164 + 4; else x147 = x147 - 1;
+    if (argc > 1) x148 = x195 + 5; else x148 = x148 - 1;
+    if (argc > 2) x149 = x226 + 6; else x149 = x149 - 1;
+    if (argc > 3) x150 = x257 + 7; else x150 = x150 - 1;
+    if (argc > 4) x151 = x288 + 8; else x151 = x151 - 1;
+    if (argc > 5) x152 = x319 + 9; else x152 = x152 - 1;
+    if (argc > 6) x153 = x350 + 10; else x153 = x153 - 1;
+    if (argc > 0) x154 = x381 + 11; else x154 = x154 - 1;
+    if (argc > 1) x155 = x12 + 12; else x155 = x155 - 1;
+    if (argc > 2) x156 = x43 + 0; else x156 = x156 - 1;
+    if (argc > 3) x157 = x74 + 1; else x157 = x157 - 1;
+    if (argc > 4) x158 = x105 + 2; else x158 = x158 - 1;
+    if (argc > 5) x159 = x136 + 3; else x159 = x159 - 1;
+    if (argc > 6) x160 = x167 + 4; else x160 = x160 - 1;
+    if (argc > 0) x161 = x198 + 5; else x161 = x161 - 1;
+    if (argc > 1) x162 = x229 + 6; else x162 = x162 - 1;
+    if (argc > 2) x163 = x260 + 7; else x163 = x163 - 1;
+    if (argc > 3) x164 = x291 + 8; else x164 = x164 - 1;
+    if (argc > 4) x165 = x322 + 9; else x165 = x165 - 1;
+    if (argc > 5) x166 = x353 + 10; else x166 = x166 - 1;
+    if (argc > 6) x167 = x384 + 11; else x167 = x167 - 1;
+    if (argc > 0) x168 = x15 + 12; else x168 = x168 - 1;
+    if (argc > 1) x169 = x46 + 0; else x169 = x169 - 1;
+    if (argc > 2) x170 = x77 + 1; else x170 = x170 - 1;
+    if (argc > 3) x171 = x108 + 2; else x171 = x171 - 1;
+    if (argc > 4) x172 = x139 + 3; else x172 = x172 - 1;
+    if (argc > 5) x173 = x170 + 4; else x173 = x173 - 1;
+    if (argc > 6) x174 = x201 + 5; else x174 = x174 - 1;
+    if (argc > 0) x175 = x232 + 6; else x175 = x175 - 1;
+    if (argc > 1) x176 = x263 + 7; else x176 = x176 - 1;
+    if (argc > 2) x177 = x294 + 8; else x177 = x177 - 1;
+    if (argc > 3) x178 = x325 + 9; else x178 = x178 - 1;
+    if (argc > 4) x179 = x356 + 10; else x179 = x179 - 1;
+    if (argc > 5) x180 = x387 + 11; else x180 = x180 - 1;
+    if (argc > 6) x181 = x18 + 12; else x181 = x181 - 1;
+    if (argc > 0) x182 = x49 + 0; else x182 = x182 - 1;
+    if (argc > 1) x183 = x80 + 1; else x183 = x183 - 1;
+    if (argc > 2) x184 = x111 + 2; else x184 = x184 - 1;
+    if (argc > 3) x185 = x142 + 3; else x185 = x185 - 1;
+    if (argc > 4) x186 = x173 + 4; else x186 = x186 - 1;
+    if (argc > 5) x187 = x204 + 5; else x187 = x187 - 1;
+    if (argc > 6) x188 = x235 + 6; else x188 = x188 - 1;
+    if (argc > 0) x189 = x266 + 7; else x189 = x189 - 1;
+    if (argc > 1) x190 = x297 + 8; else x190 = x190 - 1;
+    if (argc > 2) x191 = x328 + 9; else x191 = x191 - 1;
+    if (argc > 3) x192 = x359 + 10; else x192 = x192 - 1;
+    if (argc > 4) x193 = x390 + 11; else x193 = x193 - 1;
+    if (argc > 5) x194 = x21 + 12; else x194 = x194 - 1;
+    if (argc > 6) x195 = x52 + 0; else x195 = x195 - 1;
+    if (argc > 0) x196 = x83 + 1; else x196 = x196 - 1;
+    if (argc > 1) x197 = x114 + 2; else x197 = x197 - 1;
+    if (argc > 2) x198 = x145 + 3; else x198 = x198 - 1;
+    if (argc > 3) x199 = x176 + 4; else x199 = x199 - 1;
+    if (argc > 4) x200 = x207 + 5; else x200 = x200 - 1;
+    if (argc > 5) x201 = x238 + 6; else x201 = x201 - 1;
+    if (argc > 6) x202 = x269 + 7; else x202 = x202 - 1;
+    if (argc > 0) x203 = x300 + 8; else x203 = x203 - 1;
+    if (argc > 1) x204 = x331 + 9; else x204 = x204 - 1;
+    if (argc > 2) x205 = x362 + 10; else x205 = x205 - 1;
+    if (argc > 3) x206 = x393 + 11; else x206 = x206 - 1;
+    if (argc > 4) x207 = x24 + 12; else x207 = x207 - 1;
+    if (argc > 5) x208 = x55 + 0; else x208 = x208 - 1;
+    if (argc > 6) x209 = x86 + 1; else x209 = x209 - 1;
+    if (argc > 0) x210 = x117 + 2; else x210 = x210 - 1;
+    if (argc > 1) x211 = x148 + 3; else x211 = x211 - 1;
+    if (argc > 2) x212 = x179 + 4; else x212 = x212 - 1;
+    if (argc > 3) x213 = x210 + 5; else x213 = x213 - 1;
+    if (argc > 4) x214 = x241 + 6; else x214 = x214 - 1;
+    if (argc > 5) x215 = x272 + 7; else x215 = x215 - 1;
+    if (argc > 6) x216 = x303 + 8; else x216 = x216 - 1;
+    if (argc > 0) x217 = x334 + 9; else x217 = x217 - 1;
+    if (argc > 1) x218 = x365 + 10; else x218 = x218 - 1;
+    if (argc > 2) x219 = x396 + 11; else x219 = x219 - 1;
+    if (argc > 3) x220 = x27 + 12; else x220 = x220 - 1;
+    if (argc > 4) x221 = x58 + 0; else x221 = x221 - 1;
+    if (argc > 5) x222 = x89 + 1; else x222 = x222 - 1;
+    if (argc > 6) x223 = x120 + 2; else x223 = x223 - 1;
+    if (argc > 0) x224 = x151 + 3; else x224 = x224 - 1;
+    if (argc > 1) x225 = x182 + 4; else x225 = x225 - 1;
+    if (argc > 2) x226 = x213 + 5; else x226 = x226 - 1;
+    if (argc > 3) x227 = x244 + 6; else x227 = x227 - 1;
+    if (argc > 4) x228 = x275 + 7; else x228 = x228 - 1;
+    if (argc > 5) x229 = x306 + 8; else x229 = x229 - 1;
+    if (argc > 6) x230 = x337 + 9; else x230 = x230 - 1;
+    if (argc > 0) x231 = x368 + 10; else x231 = x231 - 1;
+    if (argc > 1) x232 = x399 + 11; else x232 = x232 - 1;
+    if (argc > 2) x233 = x30 + 12; else x233 = x233 - 1;
+    if (argc > 3) x234 = x61 + 0; else x234 = x234 - 1;
+    if (argc > 4) x235 = x92 + 1; else x235 = x235 - 1;
+    if (argc > 5) x236 = x123 + 2; else x236 = x236 - 1;
+    if (argc > 6) x237 = x154 + 3; else x237 = x237 - 1;
+    if (argc > 0) x238 = x185 + 4; else x238 = x238 - 1;
+    if (argc > 1) x239 = x216 + 5; else x239 = x239 - 1;
+    if (argc > 2) x240 = x247 + 6; else x240 = x240 - 1;
+    if (argc > 3) x241 = x278 + 7; else x241 = x241 - 1;
+    if (argc > 4) x242 = x309 + 8; else x242 = x242 - 1;
+    if (argc > 5) x243 = x340 + 9; else x243 = x243 - 1;
+    if (argc > 6) x244 = x371 + 10; else x244 = x244 - 1;
+    if (argc > 0) x245 = x2 + 11; else x245 = x245 - 1;
+    if (argc > 1) x246 = x33 + 12; else x246 = x246 - 1;
+    if (argc > 2) x247 = x64 + 0; else x247 = x247 - 1;
+    if (argc > 3) x248 = x95 + 1; else x248 = x248 - 1;
+    if (argc > 4) x249 = x126 + 2; else x249 = x249 - 1;
+    if (argc > 5) x250 = x157 + 3; else x250 = x250 - 1;
+    if (argc > 6) x251 = x188 + 4; else x251 = x251 - 1;
+    if (argc > 0) x252 = x219 + 5; else x252 = x252 - 1;
+    if (argc > 1) x253 = x250 + 6; else x253 = x253 - 1;
+    if (argc > 2) x254 = x281 + 7; else x254 = x254 - 1;
+    if (argc > 3) x255 = x312 + 8; else x255 = x255 - 1;
+    if (argc > 4) x256 = x343 + 9; else x256 = x256 - 1;
+    if (argc > 5) x257 = x374 + 10; else x257 = x257 - 1;
+    if (argc > 6) x258 = x5 + 11; else x258 = x258 - 1;
+    if (argc > 0) x259 = x36 + 12; else x259 = x259 - 1;
+    if (argc > 1) x260 = x67 + 0; else x260 = x260 - 1;
+    if (argc > 2) x261 = x98 + 1; else x261 = x261 - 1;
+    if (argc > 3) x262 = x129 + 2; else x262 = x262 - 1;
+    if (argc > 4) x263 = x160 + 3; else x263 = x263 - 1;
+    if (argc > 5) x264 = x191 + 4; else x264 = x264 - 1;
+    if (argc > 6) x265 = x222 + 5; else x265 = x265 - 1;
+    if (argc > 0) x266 = x253 + 6; else x266 = x266 - 1;
+    if (argc > 1) x267 = x284 + 7; else x267 = x267 - 1;
+    if (argc > 2) x268 = x315 + 8; else x268 = x268 - 1;
+    if (argc > 3) x269 = x346 + 9; else x269 = x269 - 1;
+    if (argc > 4) x270 = x377 + 10; else x270 = x270 - 1;
+    if (argc > 5) x271 = x8 + 11; else x271 = x271 - 1;
+    if (argc > 6) x272 = x39 + 12; else x272 = x272 - 1;
+    if (argc > 0) x273 = x70 + 0; else x273 = x273 - 1;
+    if (argc > 1) x274 = x101 + 1; else x274 = x274 - 1;
+    if (argc > 2) x275 = x132 + 2; else x275 = x275 - 1;
+    if (argc > 3) x276 = x163 + 3; else x276 = x276 - 1;
+    if (argc > 4) x277 = x194 + 4; else x277 = x277 - 1;
+    if (argc > 5) x278 = x225 + 5; else x278 = x278 - 1;
+    if (argc > 6) x279 = x256 + 6; else x279 = x279 - 1;
+    if (argc > 0) x280 = x287 + 7; else x280 = x280 - 1;
+    if (argc > 1) x281 = x318 + 8; else x281 = x281 - 1;
+    if (argc > 2) x282 = x349 + 9; else x282 = x282 - 1;
+    if (argc > 3) x283 = x380 + 10; else x283 = x283 - 1;
+    if (argc > 4) x284 = x11 + 11; else x284 = x284 - 1;
+    if (argc > 5) x285 = x42 + 12; else x285 = x285 - 1;
+    if (argc > 6) x286 = x73 + 0; else x286 = x286 - 1;
+    if (argc > 0) x287 = x104 + 1; else x287 = x287 - 1;
+    if (argc > 1) x288 = x135 + 2; else x288 = x288 - 1;
+    if (argc > 2) x289 = x166 + 3; else x289 = x289 - 1;
+    if (argc > 3) x290 = x197 + 4; else x290 = x290 - 1;
+    if (argc > 4) x291 = x228 + 5; else x291 = x291 - 1;
+    if (argc > 5) x292 = x259 + 6; else x292 = x292 - 1;
+    if (argc > 6) x293 = x290 + 7; else x293 = x293 - 1;
+    if (argc > 0) x294 = x321 + 8; else x294 = x294 - 1;
+    if (argc > 1) x295 = x352 + 9; else x295 = x295 - 1;
+    if (argc > 2) x296 = x383 + 10; else x296 = x296 - 1;
+    if (argc > 3) x297 = x14 + 11; else x297 = x297 - 1;
+    if (argc > 4) x298 = x45 + 12; else x298 = x298 - 1;
+    if (argc > 5) x299 = x76 + 0; else x299 = x299 - 1;
+    if (argc > 6) x300 = x107 + 1; else x300 = x300 - 1;
+    if (argc > 0) x301 = x138 + 2; else x301 = x301 - 1;
+    if (argc > 1) x302 = x169 + 3; else x302 = x302 - 1;
+    if (argc > 2) x303 = x200 + 4; else x303 = x303 - 1;
+    if (argc > 3) x304 = x231 + 5; else x304 = x304 - 1;
+    if (argc > 4) x305 = x262 + 6; else x305 = x305 - 1;
+    if (argc > 5) x306 = x293 + 7; else x306 = x306 - 1;
+    if (argc > 6) x307 = x324 + 8; else x307 = x307 - 1;
+    if (argc > 0) x308 = x355 + 9; else x308 = x308 - 1;
+    if (argc > 1) x309 = x386 + 10; else x309 = x309 - 1;
+    if (argc > 2) x310 = x17 + 11; else x310 = x310 - 1;
+    if (argc > 3) x311 = x48 + 12; else x311 = x311 - 1;
+    if (argc > 4) x312 = x79 + 0; else x312 = x312 - 1;
+    if (argc > 5) x313 = x110 + 1; else x313 = x313 - 1;
+    if (argc > 6) x314 = x141 + 2; else x314 = x314 - 1;
+    if (argc > 0) x315 = x172 + 3; else x315 = x315 - 1;
+    if (argc > 1) x316 = x203 + 4; else x316 = x316 - 1;
+    if (argc > 2) x317 = x234 + 5; else x317 = x317 - 1;
+    if (argc > 3) x318 = x265 + 6; else x318 = x318 - 1;
+    if (argc > 4) x319 = x296 + 7; else x319 = x319 - 1;
+    if (argc > 5) x320 = x327 + 8; else x320 = x320 - 1;
+    if (argc > 6) x321 = x358 + 9; else x321 = x321 - 1;
+    if (argc > 0) x322 = x389 + 10; else x322 = x322 - 1;
+    if (argc > 1) x323 = x20 + 11; else x323 = x323 - 1;
+    if (argc > 2) x324 = x51 + 12; else x324 = x324 - 1;
+    if (argc > 3) x325 = x82 + 0; else x325 = x325 - 1;
+    if (argc > 4) x326 = x113 + 1; else x326 = x326 - 1;
+    if (argc > 5) x327 = x144 + 2; else x327 = x327 - 1;
+    if (argc > 6) x328 = x175 + 3; else x328 = x328 - 1;
+    if (argc > 0) x329 = x206 + 4; else x329 = x329 - 1;
+    if (argc > 1) x330 = x237 + 5; else x330 = x330 - 1;
+    if (argc > 2) x331 = x268 + 6; else x331 = x331 - 1;
+    if (argc > 3) x332 = x299 + 7; else x332 = x332 - 1;
+    if (argc > 4) x333 = x330 + 8; else x333 = x333 - 1;
+    if (argc > 5) x334 = x361 + 9; else x334 = x334 - 1;
+    if (argc > 6) x335 = x392 + 10; else x335 = x335 - 1;
+    if (argc > 0) x336 = x23 + 11; else x336 = x336 - 1;
+    if (argc > 1) x337 = x54 + 12; else x337 = x337 - 1;
+    if (argc > 2) x338 = x85 + 0; else x338 = x338 - 1;
+    if (argc > 3) x339 = x116 + 1; else x339 = x339 - 1;
+    if (argc > 4) x340 = x147 + 2; else x340 = x340 - 1;
+    if (argc > 5) x341 = x178 + 3; else x341 = x341 - 1;
+    if (argc > 6) x342 = x209 + 4; else x342 = x342 - 1;
+    if (argc > 0) x343 = x240 + 5; else x343 = x343 - 1;
+    if (argc > 1) x344 = x271 + 6; else x344 = x344 - 1;
+    if (argc > 2) x345 = x302 + 7; else x345 = x345 - 1;
+    if (argc > 3) x346 = x333 + 8; else x346 = x346 - 1;
+    if (argc > 4) x347 = x364 + 9; else x347 = x347 - 1;
+    if (argc > 5) x348 = x395 + 10; else x348 = x348 - 1;
+    if (argc > 6) x349 = x26 + 11; else x349 = x349 - 1;
+    if (argc > 0) x350 = x57 + 12; else x350 = x350 - 1;
+    if (argc > 1) x351 = x88 + 0; else x351 = x351 - 1;
+    if (argc > 2) x352 = x119 + 1; else x352 = x352 - 1;
+    if (argc > 3) x353 = x150 + 2; else x353 = x353 - 1;
+    if (argc > 4) x354 = x181 + 3; else x354 = x354 - 1;
+    if (argc > 5) x355 = x212 + 4; else x355 = x355 - 1;
+    if (argc > 6) x356 = x243 + 5; else x356 = x356 - 1;
+    if (argc > 0) x357 = x274 + 6; else x357 = x357 - 1;
+    if (argc > 1) x358 = x305 + 7; else x358 = x358 - 1;
+    if (argc > 2) x359 = x336 + 8; else x359 = x359 - 1;
+    if (argc > 3) x360 = x367 + 9; else x360 = x360 - 1;
+    if (argc > 4) x361 = x398 + 10; else x361 = x361 - 1;
+    if (argc > 5) x362 = x29 + 11; else x362 = x362 - 1;
+    if (argc > 6) x363 = x60 + 12; else x363 = x363 - 1;
+    if (argc > 0) x364 = x91 + 0; else x364 = x364 - 1;
+    if (argc > 1) x365 = x122 + 1; else x365 = x365 - 1;
+    if (argc > 2) x366 = x153 + 2; else x366 = x366 - 1;
+    if (argc > 3) x367 = x184 + 3; else x367 = x367 - 1;
+    if (argc > 4) x368 = x215 + 4; else x368 = x368 - 1;
+    if (argc > 5) x369 = x246 + 5; else x369 = x369 - 1;
+    if (argc > 6) x370 = x277 + 6; else x370 = x370 - 1;
+    if (argc > 0) x371 = x308 + 7; else x371 = x371 - 1;
+    if (argc > 1) x372 = x339 + 8; else x372 = x372 - 1;
+    if (argc > 2) x373 = x370 + 9; else x373 = x373 - 1;
+    if (argc > 3) x374 = x1 + 10; else x374 = x374 - 1;
+    if (argc > 4) x375 = x32 + 11; else x375 = x375 - 1;
+    if (argc > 5) x376 = x63 + 12; else x376 = x376 - 1;
+    if (argc > 6) x377 = x94 + 0; else x377 = x377 - 1;
+    if (argc > 0) x378 = x125 + 1; else x378 = x378 - 1;
+    if (argc > 1) x379 = x156 + 2; else x379 = x379 - 1;
+    if (argc > 2) x380 = x187 + 3; else x380 = x380 - 1;
+    if (argc > 3) x381 = x218 + 4; else x381 = x381 - 1;
+    if (argc > 4) x382 = x249 + 5; else x382 = x382 - 1;
+    if (argc > 5) x383 = x280 + 6; else x383 = x383 - 1;
+    if (argc > 6) x384 = x311 + 7; else x384 = x384 - 1;
+    if (argc > 0) x385 = x342 + 8; else x385 = x385 - 1;
+    if (argc > 1) x386 = x373 + 9; else x386 = x386 - 1;
+    if (argc > 2) x387 = x4 + 10; else x387 = x387 - 1;
+    if (argc > 3) x388 = x35 + 11; else x388 = x388 - 1;
+    if (argc > 4) x389 = x66 + 12; else x389 = x389 - 1;
+    if (argc > 5) x390 = x97 + 0; else x390 = x390 - 1;
+    if (argc > 6) x391 = x128 + 1; else x391 = x391 - 1;
+    if (argc > 0) x392 = x159 + 2; else x392 = x392 - 1;
+    if (argc > 1) x393 = x190 + 3; else x393 = x393 - 1;
+    if (argc > 2) x394 = x221 + 4; else x394 = x394 - 1;
+    if (argc > 3) x395 = x252 + 5; else x395 = x395 - 1;
+    if (argc > 4) x396 = x283 + 6; else x396 = x396 - 1;
+    if (argc > 5) x397 = x314 + 7; else x397 = x397 - 1;
+    if (argc > 6) x398 = x345 + 8; else x398 = x398 - 1;
+    if (argc > 0) x399 = x376 + 9; else x399 = x399 - 1;
+  }
+  return x0 + x399;
+}
@@ -0,0 +1,17 @@
+#!/bin/sh
+# Compare the environments of non-relational domains (balanced maps vs
+# Patricia trees) on a C program.
+#
+# Usage: ./run.sh [program.c] [mopsa options...]
+#
+# For each configuration, reports the analysis time and the peak size of
+# the major heap (from the OCaml runtime statistics printed at exit).
+
+prog=${1:-$(dirname "$0")/many_vars.c}
+[ $# -gt 0 ] && shift
+
+for config in c/cell-itv.json c/cell-itv-patricia.json; do
+    echo "== $config"
+    OCAMLRUNPARAM='v=0x400' mopsa-c -config="$config" -no-warning "$@" "$prog" 2>&1 |
+        grep -E 'Analysis time|top_heap_words|heap_words'
+done
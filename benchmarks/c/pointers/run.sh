@@ -0,0 +1,18 @@
+#!/bin/sh
+# Measure the cost of invalidating pointers when heap blocks are freed,
+# for increasing numbers of live pointers.
+#
+# Usage: ./run.sh [mopsa options...]
+#
+# The program keeps N live pointers to distinct blocks while a loop
+# allocates and frees a short-lived block. The analysis time should grow
+# with N only because of the initialization loop, not because of the
+# invalidations performed by free.
+
+prog=$(dirname "$0")/../examples/pointer_heap.c
+
+for n in 16 64 256 1024; do
+    echo "== N=$n"
+    mopsa-c -config=c/cell-itv.json -ccopt="-DN=$n" -no-warning "$@" "$prog" 2>&1 |
+        grep -E 'Analysis time|alarm'
+done
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Compare the summarized transfer functions of string loops (fill, copy
+# until NUL and strlen-like scans) with their iteration by the loop
+# iterator, on buffers of increasing sizes.
+#
+# Usage: ./run.sh [mopsa options...]
+#
+# Summaries are enabled with -c-summarize-string-loops. The analysis time
+# is reported for each size.
+
+prog=$(dirname "$0")/string_loops.c
+
+for n in 16 64 256 1024 4096; do
+    for mode in summarized iterated; do
+        case $mode in
+            summarized) opt=-c-summarize-string-loops ;;
+            iterated) opt= ;;
+        esac
+        echo "== N=$n $mode"
+        mopsa-c -config=c/cell-string-length-itv.json -ccopt="-DN=$n" $opt -no-warning "$@" "$prog" 2>&1 |
+            grep -E 'Analysis time|alarm'
+    done
+done
@@ -0,0 +1,30 @@
+/* Scaled versions of examples/strlen.c and examples/strcpy_custom.c */
+
+#ifndef N
+#define N 16
+#endif
+
+char * _strcpy(char *dst, const char *src)
+{
+  while ((*dst++ = *src++) != 0)
+    ;
+  return dst;
+}
+
+unsigned int _strlen(const char *s)
+{
+  const char *p = s;
+  while (*p) p++;
+  return p - s;
+}
+
+int main() {
+  char s[N + 1];
+  char d[N + 1];
+  unsigned int n = _mopsa_range_u32(1, N);
+  for (unsigned int i = 0; i < n; i++) s[i] = 'a';
+  s[n] = '\0';
+  _strcpy(d, s);
+  _mopsa_print();
+  return _strlen(d);
+}
@@ -0,0 +1,22 @@
+#!/bin/sh
+# Compare the relational numeric domains on the array loops of
+# benchmarks/c/examples.
+#
+# Usage: ./run.sh [program.c...]
+#
+# Each program is analyzed with the relational configuration, with and
+# without packing, for every value of -numeric. The analysis time and the
+# number of alarms are reported.
+
+dir=$(dirname "$0")
+progs=${*:-"$dir/../examples/array_loop.c $dir/../examples/array_loop_offset.c $dir/../examples/loop_with_two_vars.c"}
+
+for prog in $progs; do
+    for config in c/cell-rel-itv.json c/cell-pack-rel-itv.json; do
+        for numeric in zone octagon polyhedra; do
+            echo "== $prog $config -numeric=$numeric"
+            mopsa-c -config="$config" -numeric="$numeric" -no-warning "$prog" 2>&1 |
+                grep -E 'Analysis time|alarm'
+        done
+    done
+done
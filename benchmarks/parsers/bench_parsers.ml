@@ -0,0 +1,250 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Throughput of the Menhir parsers of Mopsa.
+
+    Every grammar is measured on a corpus of the tree:
+    - Python: the Python stubs and typeshed files, and the Python
+      benchmarks;
+    - C stubs: the stub comments of the C library stubs;
+    - Universal: the universal benchmarks.
+
+    For each grammar, the lexer alone is measured, then the lexer with the
+    parser generated by the code backend of Menhir, used by Mopsa, and
+    with the parser generated by the table backend. Inputs are read in
+    memory beforehand, and the best time of several runs is reported.
+*)
+
+
+(** {2 Corpus} *)
+
+let read_file file =
+  let ch = open_in_bin file in
+  let s = really_input_string ch (in_channel_length ch) in
+  close_in ch;
+  s
+
+(* Files of a directory with one of the given extensions, recursively *)
+let rec find_files exts dir =
+  if not (Sys.file_exists dir && Sys.is_directory dir) then []
+  else
+    Sys.readdir dir |>
+    Array.to_list |>
+    List.sort compare |>
+    List.concat_map (fun f ->
+        let ff = Filename.concat dir f in
+        if Sys.is_directory ff then find_files exts ff
+        else if List.mem (Filename.extension f) exts then [ff]
+        else []
+      )
+
+(* Stub comments of a C file, except predicate declarations, which are not
+   parsed by the stub grammar *)
+let stub_comments file =
+  let s = read_file file in
+  let n = String.length s in
+  let rec find i acc =
+    match String.index_from_opt s i '/' with
+    | None -> List.rev acc
+    | Some j ->
+      if j + 2 < n && s.[j+1] = '*' && s.[j+2] = '$' then
+        let rec close k =
+          if k + 1 >= n then n
+          else if s.[k] = '*' && s.[k+1] = '/' then k + 2
+          else close (k + 1)
+        in
+        let k = close (j + 3) in
+        let com = String.sub s j (k - j) in
+        let acc = if j + 3 < n && s.[j+3] = '=' then acc else (Printf.sprintf "%s:%d" file j, com) :: acc in
+        find k acc
+      else find (j + 1) acc
+  in
+  find 0 []
+
+
+
+(** {2 Grammars} *)
+
+type grammar = {
+  name: string;
+  inputs: (string * string) list;
+  (** Name and contents of the inputs *)
+
+  reset: unit -> unit;
+  (** Reset the state of the lexer before each input *)
+
+  lex: Lexing.lexbuf -> int;
+  (** Lex an input until the end, and return its number of tokens *)
+
+  backends: (string * (Lexing.lexbuf -> unit)) list;
+  (** Parse an input with each backend *)
+}
+
+
+let python share bench =
+  let files =
+    find_files [".py"] (Filename.concat share "stubs/python") @
+    find_files [".pyi"] (Filename.concat share "stubs/python/typeshed") @
+    find_files [".py"] (Filename.concat bench "python")
+  in
+  let open Mopsa_py_parser in
+  let rec lex lb n =
+    match Lexer.next_token lb with
+    | Parser.EOF -> n + 1
+    | _ -> lex lb (n + 1)
+  in
+  {
+    name = "python";
+    inputs = List.sort_uniq compare files |> List.map (fun f -> f, read_file f);
+    reset = Lexer.reset;
+    lex = (fun lb -> lex lb 0);
+    backends = [
+      "code", (fun lb -> ignore (Parser.file_input Lexer.next_token lb));
+      "table", (fun lb -> ignore (Py_table.file_input Lexer.next_token lb));
+    ];
+  }
+
+
+let c_stubs share =
+  let files = find_files [".c"; ".h"] (Filename.concat share "stubs/c") in
+  let rec lex lb n =
+    match Parsing.Lexer.read lb with
+    | Parsing.Parser.EOF -> n + 1
+    | _ -> lex lb (n + 1)
+  in
+  {
+    name = "c_stubs";
+    inputs = List.concat_map stub_comments files;
+    reset = ignore;
+    lex = (fun lb -> lex lb 0);
+    backends = [
+      "code", (fun lb -> ignore (Parsing.Parser.parse_stub Parsing.Lexer.read lb));
+      "table", (fun lb -> ignore (Stubs_table.parse_stub Parsing.Lexer.read lb));
+    ];
+  }
+
+
+let universal bench =
+  let files = find_files [".u"] (Filename.concat bench "universal") in
+  let open Mopsa_universal_parser in
+  let rec lex lb n =
+    match U_lexer.token lb with
+    | U_parser.TOK_EOF -> n + 1
+    | _ -> lex lb (n + 1)
+  in
+  {
+    name = "universal";
+    inputs = List.map (fun f -> f, read_file f) files;
+    reset = ignore;
+    lex = (fun lb -> lex lb 0);
+    backends = [
+      "code", (fun lb -> ignore (U_parser.file U_lexer.token lb));
+      "table", (fun lb -> ignore (U_table.file U_lexer.token lb));
+    ];
+  }
+
+
+
+(** {2 Measures} *)
+
+let lexbuf (name,contents) =
+  let lb = Lexing.from_string contents in
+  lb.lex_curr_p <- { lb.lex_curr_p with pos_fname = name };
+  lb
+
+(* Best time of [runs] applications of [f] to every input, after a [reset]
+   of the lexer, and the inputs on which [f] fails *)
+let measure runs inputs reset f =
+  let failed = ref [] in
+  let run () =
+    failed := [];
+    let t0 = Sys.time () in
+    List.iter (fun i ->
+        reset ();
+        try f (lexbuf i)
+        with _ -> failed := fst i :: !failed
+      ) inputs;
+    Sys.time () -. t0
+  in
+  let best = ref infinity in
+  for _ = 1 to runs do best := min !best (run ()) done;
+  !best, List.rev !failed
+
+
+let csv = ref false
+let runs = ref 5
+let verbose = ref false
+
+let report g phase files tokens time failed =
+  let rate = if time > 0. then float_of_int tokens /. time else 0. in
+  if !csv then
+    Printf.printf "%s,%s,%d,%d,%.4f,%.0f\n" g.name phase files tokens time rate
+  else (
+    Printf.printf "%-10s %-6s %6d files %9d tokens %8.3fs %12.0f tokens/s" g.name phase files tokens time rate;
+    if failed <> [] then Printf.printf " (%d failed)" (List.length failed);
+    print_newline ()
+  );
+  if !verbose then List.iter (Printf.eprintf "  %s: %s failed\n" phase) failed
+
+
+let bench g =
+  (* Inputs that the lexer rejects are excluded from all measures *)
+  let inputs, tokens =
+    List.fold_left (fun (acc,n) i ->
+        g.reset ();
+        match g.lex (lexbuf i) with
+        | k -> (i :: acc, n + k)
+        | exception _ -> (acc, n)
+      ) ([],0) g.inputs
+  in
+  let inputs = List.rev inputs in
+  let files = List.length inputs in
+  let time, failed = measure !runs inputs g.reset (fun lb -> ignore (g.lex lb)) in
+  report g "lexer" files tokens time failed;
+  List.iter (fun (backend,parse) ->
+      let time, failed = measure !runs inputs g.reset parse in
+      report g backend files tokens time failed
+    ) g.backends
+
+
+let () =
+  let share = ref "share/mopsa" in
+  let bench_dir = ref "benchmarks" in
+  let grammars = ref [] in
+  Arg.parse [
+    "-share", Arg.Set_string share, " directory of the Mopsa stubs (default: share/mopsa)";
+    "-benchmarks", Arg.Set_string bench_dir, " directory of the benchmarks (default: benchmarks)";
+    "-runs", Arg.Set_int runs, " number of runs of each measure (default: 5)";
+    "-csv", Arg.Set csv, " print the results as CSV lines: grammar,phase,files,tokens,seconds,tokens/s";
+    "-v", Arg.Set verbose, " print the inputs that fail to parse";
+  ] (fun g -> grammars := g :: !grammars) "Usage: bench_parsers [options] [python|c_stubs|universal...]";
+  let all = [
+    "python", (fun () -> python !share !bench_dir);
+    "c_stubs", (fun () -> c_stubs !share);
+    "universal", (fun () -> universal !bench_dir);
+  ]
+  in
+  let selected = if !grammars = [] then List.map fst all else List.rev !grammars in
+  List.iter (fun name ->
+      match List.assoc_opt name all with
+      | Some g -> bench (g ())
+      | None -> Printf.eprintf "unknown grammar %s\n" name; exit 1
+    ) selected
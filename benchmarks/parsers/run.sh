@@ -0,0 +1,16 @@
+#!/bin/sh
+# Measure the throughput of the Python, C stubs and universal parsers,
+# generated by the code backend of Menhir used by Mopsa, and by its table
+# backend for comparison.
+#
+# Usage: ./run.sh [bench_parsers options...] [python|c_stubs|universal...]
+#
+# Run from any directory of the source tree. Results are printed on the
+# standard output, as CSV with -csv; they depend on the machine and are not
+# kept in the tree.
+
+root=$(cd "$(dirname "$0")/../.." && pwd)
+
+cd "$root" || exit 1
+dune build ./benchmarks/parsers/bench_parsers.exe || exit 1
+exec "$root/_build/default/benchmarks/parsers/bench_parsers.exe" "$@"
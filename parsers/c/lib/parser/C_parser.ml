@@ -30,8 +30,54 @@ let debug fmt = Debug.debug ~channel:"c.parser" fmt
 (* if only_parse is true, only parses the file without translating it to
    C AST nor adding the result to the context
  *)
+let get_target_options triple =
+  if triple = "" then Clang_parser.get_default_target_options ()
+  else { Clang_AST.empty_target_options with target_triple = triple }
+
+let get_clang_options opts =
+  (* remove some options that are in the way *)
+  let filtered_opts =
+    List.filter (fun o -> not (List.mem o ["-MF"])) opts
+  in
+  "-fparse-all-comments":: (* needed to get stub comments, which are not doc comments *)
+  filtered_opts
+
+
+(* Words allocated in the OCaml heap by [f ()], mostly by the translation
+   of the Clang AST, comments and macros. *)
+let with_alloc_stats what f =
+  let before = Gc.allocated_bytes () in
+  let r = f () in
+  debug "%s: %.0f words allocated%s" what
+    ((Gc.allocated_bytes () -. before) /. float_of_int (Sys.word_size / 8))
+    (if Clang_parser.get_stub_comments_only () then ", stub comments only" else "");
+  r
+
+
+(* Parse a list of files, given with their options, in [threads] parallel
+   Clang instances. The results are given to [parse_file] with [?result]. *)
+let parse_batch
+    (command:string)
+    (files:(string * string list) list)
+    (triple:string)
+    (enable_cache:bool)
+    (threads:int)
+  : Clang_parser.parse_result list
+  =
+  let target_options = get_target_options triple in
+  debug "Parsing %d files in batch, command '%s', target '%s', %d threads" (List.length files) command
+    target_options.target_triple threads;
+  C_profile.phase "<batch>" "parse-batch" (fun () ->
+      with_alloc_stats "batch" (fun () ->
+          Clang_parser_cache.parse_batch command target_options enable_cache threads
+            (List.map (fun (file,opts) -> file, Array.of_list (get_clang_options opts)) files)
+        )
+    )
+
+
 let parse_file
     (command:string)
+    ?(result:Clang_parser.parse_result option)
     (file:string)
     (opts:string list)
     (triple:string)
@@ -41,23 +87,24 @@ let parse_file
     (only_parse:bool)
     (ctx:Clang_to_C.context)
   =
-  let target_options =
-    if triple = "" then Clang_parser.get_default_target_options ()
-    else { Clang_AST.empty_target_options with target_triple = triple }
-  in
-  (* remove some options that are in the way *)
-  let filtered_opts =
-    List.filter (fun o -> not (List.mem o ["-MF"])) opts
-  in
-  let opts = "-fparse-all-comments":: (* needed to get all comments *)
-               filtered_opts
-  in
-
-  debug "Parsing %s, command '%s', target '%s', argument list %a" file command
-target_options.target_triple (ListExt.fprint ListExt.printer_list (fun ch s -> Format.fprintf ch "'%s'" s)) opts;
+  let target_options = get_target_options triple in
+  let opts = get_clang_options opts in
 
-  let r = Clang_parser_cache.parse command target_options enable_cache file (Array.of_list opts)
+  let r =
+    match result with
+    | Some r -> r
+    | None ->
+      debug "Parsing %s, command '%s', target '%s', argument list %a" file command
+        target_options.target_triple (ListExt.fprint ListExt.printer_list (fun ch s -> Format.fprintf ch "'%s'" s)) opts;
+      C_profile.phase file "parse" (fun () ->
+          with_alloc_stats file (fun () ->
+              Clang_parser_cache.parse command target_options enable_cache file (Array.of_list opts)
+            )
+        )
   in
+  C_profile.add_clang_phases file r;
+
+  debug "%s: %d comments, %d macros" file (List.length r.parse_comments) (List.length r.parse_macros);
 
   List.iter
     (fun d -> debug "Diagnostic returned: %s" (Clang_dump.string_of_diagnostic d))
@@ -75,9 +122,9 @@ target_options.target_triple (ListExt.fprint ListExt.printer_list (fun ch s -> F
           match d.Clang_AST.diag_level with
           | Level_Warning ->
             let pos = Location.mk_pos
-                d.diag_loc.loc_file
-                d.diag_loc.loc_line
-                d.diag_loc.loc_column
+                (Clang_utils.loc_file d.diag_loc)
+                (Clang_utils.loc_line d.diag_loc)
+                (Clang_utils.loc_column d.diag_loc)
             in
             let range = Location.mk_orig_range pos pos in
             Exceptions.warn_at range "%s" d.diag_message
@@ -85,10 +132,12 @@ target_options.target_triple (ListExt.fprint ListExt.printer_list (fun ch s -> F
         ) r.parse_diag;
     if only_parse then ()
     else
-      Clang_to_C.add_translation_unit
-        ctx (Filename.basename file)
-        r.parse_decl r.parse_files r.parse_comments r.parse_macros
-        keep_static
+      C_profile.phase file "link" (fun () ->
+          Clang_to_C.add_translation_unit
+            ctx (Filename.basename file)
+            r.parse_decl r.parse_files r.parse_comments r.parse_macros
+            keep_static
+        )
   )
   else
     let errors =
@@ -96,9 +145,9 @@ target_options.target_triple (ListExt.fprint ListExt.printer_list (fun ch s -> F
         (fun diag ->
            let open Clang_AST in
            let pos = Location.mk_pos
-               diag.diag_loc.loc_file
-               diag.diag_loc.loc_line
-               diag.diag_loc.loc_column
+               (Clang_utils.loc_file diag.diag_loc)
+               (Clang_utils.loc_line diag.diag_loc)
+               (Clang_utils.loc_column diag.diag_loc)
            in
            let range = Location.mk_orig_range pos pos in
            (range, diag.diag_message)
@@ -0,0 +1,126 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+
+
+(**
+  C_profile - Profiling of the parsing of C projects.
+
+  Records the time and the OCaml allocations of the phases of the parsing
+  of each translation unit: the phases executed in Clang, returned by
+  [Clang_parser], and the phases of the OCaml front-end, such as the
+  parser cache and the linking.
+ *)
+
+
+type event = {
+  ev_tu: string;        (** translation unit, or pseudo unit such as [<project>] *)
+  ev_phase: string;     (** name of the phase *)
+  ev_thread: int;       (** 0 for the main thread, k for the k-th parsing thread *)
+  ev_start: float;      (** start, in seconds since the epoch *)
+  ev_wall: float;       (** elapsed time, in seconds *)
+  ev_words: float;      (** words allocated in the OCaml heap *)
+  ev_minor_gcs: int;    (** minor collections *)
+  ev_major_gcs: int;    (** major collections *)
+  ev_clang_mem: float;  (** bytes allocated by Clang *)
+}
+
+
+let enabled = ref false
+(** Record profiling events. *)
+
+let events : event Queue.t = Queue.create ()
+(** Events, in the order of their end. *)
+
+
+let word_bytes = float_of_int (Sys.word_size / 8)
+
+(** Execute [f ()] as the phase [phase] of the translation unit [tu]. *)
+let phase (tu:string) (phase:string) (f:unit -> 'a) : 'a =
+  if not !enabled then f ()
+  else
+    let gc = Gc.quick_stat () in
+    let bytes = Gc.allocated_bytes () in
+    let start = Unix.gettimeofday () in
+    let finally () =
+      let gc' = Gc.quick_stat () in
+      Queue.push {
+        ev_tu = tu;
+        ev_phase = phase;
+        ev_thread = 0;
+        ev_start = start;
+        ev_wall = Unix.gettimeofday () -. start;
+        ev_words = (Gc.allocated_bytes () -. bytes) /. word_bytes;
+        ev_minor_gcs = gc'.Gc.minor_collections - gc.Gc.minor_collections;
+        ev_major_gcs = gc'.Gc.major_collections - gc.Gc.major_collections;
+        ev_clang_mem = 0.;
+      } events
+    in
+    Fun.protect ~finally f
+
+
+(** Record the phases executed in Clang to parse [tu]. Their OCaml
+    allocations are counted in the enclosing OCaml phase. *)
+let add_clang_phases (tu:string) (r:Clang_parser.parse_result) =
+  let open Clang_parser in
+  if !enabled then
+    List.iter (fun p ->
+        Queue.push {
+          ev_tu = tu;
+          ev_phase = p.phase_name;
+          ev_thread = p.phase_thread;
+          ev_start = p.phase_start;
+          ev_wall = p.phase_wall;
+          ev_words = 0.;
+          ev_minor_gcs = 0;
+          ev_major_gcs = 0;
+          ev_clang_mem = p.phase_mem;
+        } events
+      ) r.parse_phases
+
+
+(** Events aggregated by translation unit and phase, in the order of
+    their first occurrence. *)
+let summary () : (string * event list) list =
+  let tus = Hashtbl.create 16 in
+  let order = ref [] in
+  Queue.iter (fun e ->
+      let phases =
+        match Hashtbl.find_opt tus e.ev_tu with
+        | Some l -> l
+        | None -> order := e.ev_tu :: !order; []
+      in
+      let phases =
+        if List.exists (fun e' -> e'.ev_phase = e.ev_phase) phases then
+          List.map (fun e' ->
+              if e'.ev_phase <> e.ev_phase then e'
+              else { e' with
+                     ev_wall = e'.ev_wall +. e.ev_wall;
+                     ev_words = e'.ev_words +. e.ev_words;
+                     ev_minor_gcs = e'.ev_minor_gcs + e.ev_minor_gcs;
+                     ev_major_gcs = e'.ev_major_gcs + e.ev_major_gcs;
+                     ev_clang_mem = e'.ev_clang_mem +. e.ev_clang_mem; }
+            ) phases
+        else phases @ [e]
+      in
+      Hashtbl.replace tus e.ev_tu phases
+    ) events;
+  List.rev_map (fun tu -> tu, Hashtbl.find tus tu) !order
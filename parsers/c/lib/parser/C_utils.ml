@@ -869,6 +869,98 @@ let resolve_scope (b:block) : block =
  *)
 
 
+(** {2 Reachability} *)
+
+
+let rec iter_funcs_type (f:func -> unit) (t:typ) =
+  match t with
+  | T_array ((t,_), Length_expr e) -> iter_funcs_type f t; iter_funcs_expr f e
+  | T_array ((t,_), _) | T_pointer (t,_) -> iter_funcs_type f t
+  | T_typedef td -> iter_funcs_type f (fst td.typedef_def)
+  | _ -> ()
+(** Functions referenced in the length of variable-length arrays.
+    Records and function types are not visited. *)
+
+and iter_funcs_expr (f:func -> unit) ((e,(t,_),_):expr) =
+  let expr = iter_funcs_expr f in
+  match e with
+  | E_function fn -> f fn
+  | E_conditional (e1,e2,e3) -> expr e1; expr e2; expr e3
+  | E_binary_conditional (e1,e2) | E_array_subscript (e1,e2)
+  | E_compound_assign (e1,_,_,e2,_) | E_binary (_,e1,e2)
+  | E_assign (e1,e2) | E_comma (e1,e2) | E_atomic (_,e1,e2) -> expr e1; expr e2
+  | E_member_access (e1,_,_) | E_arrow_access (e1,_,_) | E_unary (_,e1)
+  | E_increment (_,_,e1) | E_address_of e1 | E_deref e1 | E_var_args e1
+  | E_convert_vector e1 | E_vector_element (e1,_) -> expr e1
+  | E_cast (e1,_) -> iter_funcs_type f t; expr e1
+  | E_call (e1,args) -> expr e1; Array.iter expr args
+  | E_shuffle_vector args -> Array.iter expr args
+  | E_compound_literal i -> iter_funcs_init f i
+  | E_statement b -> iter_funcs_block f b
+  | E_character_literal _ | E_integer_literal _ | E_float_literal _
+  | E_string_literal _ | E_variable _ | E_predefined _ -> ()
+(** Functions referenced in an expression, either called or with their
+    address taken. *)
+
+and iter_funcs_init (f:func -> unit) (i:init) =
+  match i with
+  | I_init_expr e -> iter_funcs_expr f e
+  | I_init_list (l,filler) ->
+    List.iter (iter_funcs_init f) l;
+    (match filler with Some i -> iter_funcs_init f i | None -> ())
+  | I_init_implicit _ -> ()
+
+and iter_funcs_var (f:func -> unit) (v:variable) =
+  iter_funcs_type f (fst v.var_type);
+  match v.var_init with
+  | Some i -> iter_funcs_init f i
+  | None -> ()
+
+and iter_funcs_block (f:func -> unit) (b:block) =
+  List.iter (iter_funcs_stmt f) b.blk_stmts
+
+and iter_funcs_stmt (f:func -> unit) ((s,_):statement) =
+  let expr = iter_funcs_expr f and block = iter_funcs_block f in
+  match s with
+  | S_local_declaration v -> iter_funcs_var f v
+  | S_expression e -> expr e
+  | S_block b -> block b
+  | S_if (e,b1,b2) -> expr e; block b1; block b2
+  | S_while (e,b) | S_do_while (b,e) -> expr e; block b
+  | S_for (b1,e1,e2,b2) ->
+    block b1;
+    Option.iter expr e1;
+    Option.iter expr e2;
+    block b2
+  | S_jump (S_return (Some e,_)) -> expr e
+  | S_jump (S_switch (e,b)) -> expr e; block b
+  | S_jump _ -> ()
+  | S_target (S_case (e,_)) -> expr e
+  | S_target _ -> ()
+
+
+let reachable_functions (roots:func list) (extra:func -> func list) : func StringMap.t =
+  let rec visit acc = function
+    | [] -> acc
+    | fn :: todo when StringMap.mem fn.func_unique_name acc -> visit acc todo
+    | fn :: todo ->
+      let acc = StringMap.add fn.func_unique_name fn acc in
+      let next = ref (extra fn @ todo) in
+      let add g = next := g :: !next in
+      List.iter (iter_funcs_var add) fn.func_static_vars;
+      Option.iter (iter_funcs_block add) fn.func_body;
+      visit acc !next
+  in
+  visit StringMap.empty roots
+(** [reachable_functions roots extra] returns, by unique name, the
+    functions transitively referenced from [roots], through calls and
+    address-taken functions in their bodies and static initializers.
+    [extra fn] gives additional functions referenced by [fn], e.g. by
+    its stub.
+ *)
+
+
+
 (** {2 Errors} *)
 
 let error range msg arg =
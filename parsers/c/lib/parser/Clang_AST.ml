@@ -62,12 +62,10 @@
 (** {2 Locations} *)
 
 
-type loc = {
-    loc_line: int;
-    loc_column: int;
-    loc_file: string; (** empty for invalid locations *)
-  }
-(** Location in a source file *)
+type loc = int
+(** Location in a source file, packing a file identifier, a line and a
+    column, or -1 for invalid locations. See {!Clang_utils.loc_file},
+    {!Clang_utils.loc_line} and {!Clang_utils.loc_column}. *)
 
 type range = {
     range_begin: loc;
@@ -139,6 +137,7 @@ type name = {
      enum_typedef: typedef_decl option; (** for anonymous enum, gets the typedef it is declared in, if any  *)
      enum_range: range;
      enum_com: comment list;
+     enum_hash: int; (** structural hash, equal for identical declarations in different translation units *)
    }
  (** enum declaration. *)
 
@@ -188,6 +187,8 @@ type name = {
      record_base_class: cxx_base_specifier list; (** (C++) direct (virtual and non virtual) base classes *)
      record_methods: function_decl list; (** (C++) all methods, including ctor, dtor, operators *)
      record_friends: friend_decl list; (** (C++) friends *)
+
+     record_hash: int; (** structural hash, equal for identical declarations in different translation units *)
    }
  (** struct or union declaration.  *)
 
@@ -211,6 +212,7 @@ type name = {
      typedef_underlying_type: type_qual;
      typedef_range: range;
      typedef_com: comment list;
+     typedef_hash: int; (** structural hash, equal for identical declarations in different translation units *)
    }
  (** typedef declaration *)
 
@@ -571,25 +571,28 @@ let stmt_kind_name s =
 
 
 let string_of_loc l =
-  Printf.sprintf "%s:%i:%i" l.loc_file l.loc_line l.loc_column
+  let open Clang_utils in
+  Printf.sprintf "%s:%i:%i" (loc_file l) (loc_line l) (loc_column l)
 
 let string_of_range r =
-  if r.range_begin.loc_file = r.range_end.loc_file then
-    if r.range_begin.loc_line = r.range_end.loc_line then
+  let open Clang_utils in
+  let b = r.range_begin and e = r.range_end in
+  if loc_file b = loc_file e then
+    if loc_line b = loc_line e then
       Printf.sprintf
         "%s:%i:%i-%i"
-        r.range_begin.loc_file r.range_begin.loc_line r.range_begin.loc_column
-        r.range_end.loc_column
+        (loc_file b) (loc_line b) (loc_column b)
+        (loc_column e)
     else
       Printf.sprintf
         "%s:%i:%i-%i:%i"
-        r.range_begin.loc_file r.range_begin.loc_line r.range_begin.loc_column
-        r.range_end.loc_line r.range_end.loc_column
+        (loc_file b) (loc_line b) (loc_column b)
+        (loc_line e) (loc_column e)
   else
     Printf.sprintf
       "%s:%i:%i-%s:%i:%i"
-      r.range_begin.loc_file r.range_begin.loc_line r.range_begin.loc_column
-      r.range_end.loc_file r.range_end.loc_line r.range_end.loc_column
+      (loc_file b) (loc_line b) (loc_column b)
+      (loc_file e) (loc_line e) (loc_column e)
 
         
 let string_of_diagnostic d =
@@ -54,13 +54,36 @@ external get_target_info: target_options -> target_info = "mlclang_get_target_in
 
 (** {1 Parsing} *)
 
+type parse_phase = {
+  phase_name: string; (** Name of the phase. *)
+  phase_thread: int; (** Thread of the phase: 0 for the calling thread, k for the k-th thread of [parse_batch]. *)
+  phase_start: float; (** Start, in seconds since the epoch. *)
+  phase_wall: float; (** Elapsed time, in seconds. *)
+  phase_user: float; (** User time, in seconds. *)
+  phase_mem: float; (** Memory allocated by Clang, in bytes. *)
+}
+(** Timing of a phase of the parsing in Clang, for profiling. *)
+
 type parse_result = {
   parse_decl: decl; (** AST. *)
   parse_diag : diagnostic list; (** Warnings and errors. *)
   parse_comments: comment list; (** C/C++ comments. *)
   parse_macros: macro list; (** Macros. *)
   parse_files: string list; (** Files read during parsing. *)
+  parse_phases: parse_phase list; (** Timing of the parsing phases. *)
+  parse_loc_files: (int * string) list; (** Identifiers of the files of the locations. *)
 }
       
+external set_stub_comments_only: bool -> unit = "mlclang_set_stub_comments_only"
+(** When set, only stub comments, starting with [/*$], are returned, and only the macros they use, directly or through other macros. Disabled by default. *)
+
+external get_stub_comments_only: unit -> bool = "mlclang_get_stub_comments_only"
+
 external parse: command:string -> target:target_options -> filename:string -> args:string array -> parse_result = "mlclang_parse"
 (** Parse the source file with the specified command (e.g., "clang" or "clang++") for the specified target, given the the specified compile-time options. *)
+
+external parse_batch: command:string -> target:target_options -> files:(string * string array) array -> threads:int -> parse_result array = "mlclang_parse_batch"
+(** Parse a list of source files, given with their compile-time options, with the specified command for the specified target. Files parsed in the same thread share the Clang file manager and target information. With [threads] > 1, files are parsed in parallel with one Clang instance per thread. Results are returned in the order of [files]. *)
+
+external build_pch: command:string -> target:target_options -> header:string -> output:string -> args:string array -> bool = "mlclang_build_pch"
+(** Compile the header into a precompiled header stored in [output], with the same options as [parse]. Returns false if the header has errors. Files parsed with [-include-pch output] in [args] load the precompiled header instead of parsing the header again; [parse] fails if the precompiled header is out of date. *)
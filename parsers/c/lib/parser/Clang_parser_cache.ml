@@ -40,7 +40,7 @@ let debug fmt = Mopsa_utils.Debug.debug ~channel:"c.parser_cache" fmt
     This is checked when using the cache, and should be changed when
     the signature or the AST type change to invalidate the cache.
 *)
-let version = "Mopsa.C.AST/1"
+let version = "Mopsa.C.AST/5"
 
        
 (** Source file identification. *)
@@ -55,6 +55,7 @@ type signature =
     string                  (* parser command *)
     * target_options        (* target *)
     * string array          (* parser arguments *)
+    * bool                  (* only stub comments *)
     * file_signature list   (* file names and timestamp *)
 
 
@@ -72,13 +73,13 @@ let get_file_signature (f:string) : file_signature =
 
                         
 let get_signature cmd tgt opts files : signature =
-  cmd, tgt, opts, List.map get_file_signature files
+  cmd, tgt, opts, Clang_parser.get_stub_comments_only (), List.map get_file_signature files
 
                            
 (** Checks that the signature is valid. *)    
 let check_signature cmd tgt opts signature : bool =
-  let cmd', tgt', opts', files' = signature in
-  cmd = cmd' && tgt = tgt' && opts = opts' &&
+  let cmd', tgt', opts', stubs', files' = signature in
+  cmd = cmd' && tgt = tgt' && opts = opts' && Clang_parser.get_stub_comments_only () = stubs' &&
   (List.for_all (fun s -> let f,_,_ = s in get_file_signature f = s) files')
 
     
@@ -87,76 +88,127 @@ let file_cache_name file =
    file ^ ".mopsa_ast" 
 
     
-(** Drop-in replacement to [Clang_parser.cache], but uses a cache on disk. *)
-let parse cmd tgt file opts : parse_result =
+(** Read the parse result of a source file from its cache, if valid. *)
+let read_cache cmd tgt file opts : parse_result option =
+  C_profile.phase file "cache-read" @@ fun () ->
 
   debug "Clang_parser_cache: parsing %s" file;
-      
+    
   (* try to read cache *)
   let file_cache = file_cache_name file in
   debug "Clang_parser_cache: looking for cache file %s" file_cache;
-  let from_cache : parse_result option =
-    try
-      (* try cache file *)
-      let f = Unix.openfile file_cache [Unix.O_RDWR] 0o666 in
-      Unix.lockf f F_LOCK 0;
-      let cache = Unix.in_channel_of_descr f in
-      let v = Marshal.from_channel cache in
-      let r = 
-        if v <> version then (
-          debug "Clang_parser_cache: %s incompatible version" file_cache;
-          None
-        )
-        else
-          let signature : signature = Marshal.from_channel cache in
-          let check =
-            try check_signature cmd tgt opts signature with _ -> false
-          in
-          if check then  (
-            (* correct signature -> use cache *)
-            debug "Clang_parser_cache: %s found" file_cache;
-            Some (Marshal.from_channel cache)
-          )
+  try
+    (* try cache file *)
+    let f = Unix.openfile file_cache [Unix.O_RDWR] 0o666 in
+    Unix.lockf f F_LOCK 0;
+    let cache = Unix.in_channel_of_descr f in
+    let v = Marshal.from_channel cache in
+    let r = 
+      if v <> version then (
+        debug "Clang_parser_cache: %s incompatible version" file_cache;
+        None
+      )
+      else
+        let signature : signature = Marshal.from_channel cache in
+        let check =
+          try check_signature cmd tgt opts signature with _ -> false
+        in
+        if check then  (
+          (* correct signature -> use cache *)
+          debug "Clang_parser_cache: %s found" file_cache;
+          (* the phases of the original parse are not profiled again *)
+          let r : parse_result = Marshal.from_channel cache in
+          (* locations refer to the file identifiers of the original parse,
+             which must be free or identical in this process *)
+          if List.for_all (fun (id,f) -> Clang_utils.register_loc_file id f) r.parse_loc_files
+          then Some { r with parse_phases = [] }
           else (
-            (* incorrect signature *)
-            debug "Clang_parser_cache: %s incompatible signature" file_cache;
+            debug "Clang_parser_cache: %s incompatible file identifiers" file_cache;
             None
           )
-      in
-      ignore (Unix.lseek f 0 SEEK_SET);
-      Unix.lockf f F_ULOCK 0;
-      close_in cache;
-      r
-    with _ ->
-      (* cache file not available *)
-      debug "Clang_parser_cache: %s cache file not found" file_cache;
-      None 
-  in
-  
-  match from_cache with
+        )
+        else (
+          (* incorrect signature *)
+          debug "Clang_parser_cache: %s incompatible signature" file_cache;
+          None
+        )
+    in
+    ignore (Unix.lseek f 0 SEEK_SET);
+    Unix.lockf f F_ULOCK 0;
+    close_in cache;
+    r
+  with _ ->
+    (* cache file not available *)
+    debug "Clang_parser_cache: %s cache file not found" file_cache;
+    None 
+
+
+(** Store the parse result of a source file in its cache. *)
+let write_cache cmd tgt file opts (r:parse_result) =
+  C_profile.phase file "cache-write" @@ fun () ->
+  let file_cache = file_cache_name file in
+  let files = List.sort compare r.parse_files in
+  let files = List.filter (fun x -> x <> "<built-in>") files in
+  let c = get_signature cmd tgt opts files in
+  (* store signature & parse result *)
+  debug "Clang_parser_cache: storing cache to %s" file_cache;
+
+  let f = Unix.openfile file_cache [Unix.O_WRONLY;Unix.O_CREAT;Unix.O_TRUNC] 0o666 in
+  let cache = Unix.out_channel_of_descr f in
+  Unix.lockf f F_LOCK 0;
+  Marshal.to_channel cache version [];
+  Marshal.to_channel cache c [];
+  Marshal.to_channel cache r [];
+  flush cache;
+  ignore (Unix.lseek f 0 SEEK_SET);
+  Unix.lockf f F_ULOCK 0;
+  close_out cache
+
+
+(** Drop-in replacement to [Clang_parser.cache], but uses a cache on disk. *)
+let parse cmd tgt file opts : parse_result =
+  match read_cache cmd tgt file opts with
   | Some c -> c
   | None ->
      (* parse *)
-     let r = Clang_parser.parse ~command:cmd ~target:tgt ~filename:file ~args:opts in
-     let files = List.sort compare r.parse_files in
-     let files = List.filter (fun x -> x <> "<built-in>") files in
-     let c = get_signature cmd tgt opts files in
-     (* store signature & parse result *)
-     debug "Clang_parser_cache: storing cache to %s" file_cache;
-
-     let f = Unix.openfile file_cache [Unix.O_WRONLY;Unix.O_CREAT;Unix.O_TRUNC] 0o666 in
-     let cache = Unix.out_channel_of_descr f in
-     Unix.lockf f F_LOCK 0;
-     Marshal.to_channel cache version [];
-     Marshal.to_channel cache c [];
-     Marshal.to_channel cache r [];
-     flush cache;
-     ignore (Unix.lseek f 0 SEEK_SET);
-     Unix.lockf f F_ULOCK 0;
-     close_out cache;
+     let r = Clang_pch.parse cmd tgt file opts in
+     write_cache cmd tgt file opts r;
      r
 
 let parse cmd tgt enable_cache file opts =
   if enable_cache then parse cmd tgt file opts
-  else Clang_parser.parse ~command:cmd ~target:tgt ~filename:file ~args:opts
+  else Clang_pch.parse cmd tgt file opts
+
+
+(** Parse a list of source files with [Clang_parser.parse_batch], except
+    for the files found in the cache. Files are parsed one by one when
+    precompiled headers are enabled, as they are selected per file. *)
+let parse_batch cmd tgt enable_cache threads (files:(string * string array) list) : parse_result list =
+  if !Clang_pch.enabled then
+    List.map (fun (file,opts) -> parse cmd tgt enable_cache file opts) files
+  else
+    let cached =
+      List.map (fun (file,opts) ->
+          if enable_cache then read_cache cmd tgt file opts else None
+        ) files
+    in
+    let missing =
+      List.combine files cached |>
+      List.filter_map (fun (f,c) -> if c = None then Some f else None)
+    in
+    let parsed =
+      if missing = [] then []
+      else Clang_parser.parse_batch ~command:cmd ~target:tgt ~files:(Array.of_list missing) ~threads |>
+           Array.to_list
+    in
+    if enable_cache then
+      List.iter2 (fun (file,opts) r -> write_cache cmd tgt file opts r) missing parsed;
+    let rec merge cached parsed =
+      match cached, parsed with
+      | [], _ -> []
+      | Some c :: tl, _ -> c :: merge tl parsed
+      | None :: tl, r :: parsed' -> r :: merge tl parsed'
+      | None :: _, [] -> assert false
+    in
+    merge cached parsed
    
@@ -0,0 +1,266 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+
+(**
+  Clang_pch - Precompiled headers shared by the files of a project.
+
+  Most translation units of a project start with the same system
+  includes, and all of them include mopsa.h. We compile once a prefix
+  header containing these includes, and parse every file starting with
+  them with [-include-pch].
+
+  Only the leading [#include <...>] directives of a file are covered, so
+  that the precompiled header does not change the meaning of the file.
+  Precompiled headers are stored in the private cache directory of the
+  user, and are reused across analyses as long as Clang accepts them.
+  When no private directory is available, files are parsed without
+  precompiled headers.
+ *)
+
+
+open Clang_AST
+open Clang_parser
+
+
+let debug fmt = Mopsa_utils.Debug.debug ~channel:"c.parser_pch" fmt
+
+(** Version number, changed when the prefix header format changes. *)
+let version = "Mopsa.C.PCH/1"
+
+
+(** {1 Options} *)
+
+
+let enabled = ref false
+(** Use precompiled headers. *)
+
+let prefix : string list ref = ref []
+(** Leading includes of the project covered by precompiled headers. *)
+
+
+
+(** {1 Header prefix} *)
+
+
+let include_regexp = Str.regexp "^#[ \t]*include[ \t]*<\\([^>]+\\)>[ \t]*$"
+
+(** Leading system includes of a source file, before any other directive
+    or declaration. Only blank lines and comments may separate them. *)
+let leading_includes (file:string) : string list =
+  try
+    let ch = open_in file in
+    let rec iter acc in_comment =
+      match input_line ch with
+      | exception End_of_file -> List.rev acc
+      | line ->
+        let line = String.trim line in
+        let ends_comment () =
+          let n = String.length line in
+          n >= 2 && String.sub line (n - 2) 2 = "*/"
+        in
+        if in_comment then iter acc (not (ends_comment ()))
+        else if line = "" || String.starts_with ~prefix:"//" line then iter acc false
+        else if String.starts_with ~prefix:"/*" line then iter acc (not (ends_comment ()))
+        else if Str.string_match include_regexp line 0 then iter (Str.matched_group 1 line :: acc) false
+        else List.rev acc
+    in
+    let r = iter [] false in
+    close_in ch;
+    r
+  with Sys_error _ -> []
+
+
+let rec is_prefix l1 l2 =
+  match l1, l2 with
+  | [], _ -> true
+  | x1 :: t1, x2 :: t2 -> x1 = x2 && is_prefix t1 t2
+  | _ -> false
+
+
+(** Most common prefix of a list of include lists: the prefix maximizing the
+    number of included headers saved over all files. *)
+let most_common_prefix (ll:string list list) : string list =
+  let count = Hashtbl.create 16 in
+  List.iter (fun l ->
+      let rec iter rev_prefix = function
+        | [] -> ()
+        | x :: tl ->
+          let p = x :: rev_prefix in
+          let n = try Hashtbl.find count p with Not_found -> 0 in
+          Hashtbl.replace count p (n + 1);
+          iter p tl
+      in
+      iter [] l
+    ) ll;
+  let best, _ =
+    Hashtbl.fold (fun p n ((_, best_score) as acc) ->
+        let score = n * List.length p in
+        if score > best_score then (p, score) else acc
+      ) count ([], 0)
+  in
+  List.rev best
+
+
+(** Initialize the prefix from the source files of the project. *)
+let init (files:string list) =
+  enabled := true;
+  prefix := most_common_prefix (List.map leading_includes files);
+  debug "prefix of project: %s" (String.concat " " !prefix)
+
+
+
+(** {1 Precompiled headers} *)
+
+
+(** Parts of the parsing result of the prefix header that are not
+    returned when parsing with its precompiled header. *)
+type pch = {
+  pch_file: string;
+  pch_files: string list;
+  pch_comments: comment list;
+  pch_macros: macro list;
+  pch_loc_files: (int * string) list;
+}
+
+
+(** Precompiled headers of the current analysis, per parsing signature.
+    [None] when the header can not be compiled. *)
+let table : (string, pch option) Hashtbl.t = Hashtbl.create 16
+
+
+let dir () = Mopsa_utils.CacheDir.get "pch"
+
+
+(** Create [file] with the contents written by [f], unless it already
+    exists. The contents are written in a temporary file of the same
+    directory, which is then linked to [file], so that concurrent
+    analyses never see a partial file, nor replace an existing one.
+    Returns false if the file can not be created. *)
+let create_file file f =
+  try
+    let tmp = Filename.temp_file ~temp_dir:(Filename.dirname file) (Filename.basename file) ".tmp" in
+    Fun.protect ~finally:(fun () -> try Sys.remove tmp with Sys_error _ -> ()) (fun () ->
+        let ch = open_out tmp in
+        Fun.protect ~finally:(fun () -> close_out ch) (fun () -> f ch);
+        try Unix.link tmp file; true with Unix.Unix_error (Unix.EEXIST, _, _) -> true
+      )
+  with Sys_error _ | Unix.Unix_error _ -> false
+
+(** Compile [header] into [file]. Clang writes the precompiled header to a
+    temporary file of the same directory, which then replaces [file]
+    atomically. *)
+let build_pch_file cmd tgt opts header file =
+  try
+    let tmp = Filename.temp_file ~temp_dir:(Filename.dirname file) (Filename.basename file) ".tmp" in
+    Fun.protect ~finally:(fun () -> try Sys.remove tmp with Sys_error _ -> ()) (fun () ->
+        Clang_parser.build_pch ~command:cmd ~target:tgt ~header ~output:tmp ~args:opts &&
+        (Sys.rename tmp file; true)
+      )
+  with Sys_error _ -> false
+
+
+(** Signature of the prefix header. Relative include paths in [opts]
+    depend on the current directory, which is part of the signature. *)
+let signature cmd tgt opts : string =
+  Marshal.to_string (version, Sys.getcwd (), cmd, tgt, opts, !prefix) [] |>
+  Digest.string |>
+  Digest.to_hex
+
+let build key cmd tgt opts : pch option =
+  match Hashtbl.find_opt table key with
+  | Some p -> p
+  | None ->
+    let p =
+      match dir () with
+      | None ->
+        debug "no private cache directory";
+        None
+      | Some d ->
+        let header = Filename.concat d (key ^ ".h") in
+        let file = header ^ ".pch" in
+        (* The header is written only once: rewriting it would invalidate the
+           precompiled header of previous analyses *)
+        if not (Sys.file_exists header) &&
+           not (create_file header (fun ch ->
+               Printf.fprintf ch "#ifndef _MOPSA_PCH_%s\n#define _MOPSA_PCH_%s\n" key key;
+               List.iter (Printf.fprintf ch "#include <%s>\n") !prefix;
+               Printf.fprintf ch "#endif\n"
+             ))
+        then None
+        else
+        let r = Clang_parser.parse ~command:cmd ~target:tgt ~filename:header ~args:opts in
+        let is_error =
+          List.exists (function { diag_level = Level_Error | Level_Fatal } -> true | _ -> false) r.parse_diag
+        in
+        let p =
+          if is_error then None
+          else if not (Sys.file_exists file) && not (build_pch_file cmd tgt opts header file) then None
+          else Some {
+              pch_file = file;
+              pch_files = List.filter (fun f -> f <> header) r.parse_files;
+              pch_comments = r.parse_comments;
+              pch_macros = r.parse_macros;
+              pch_loc_files = r.parse_loc_files;
+            }
+        in
+        debug "precompiled header %s: %s" file (if p = None then "failed" else "ready");
+        p
+    in
+    Hashtbl.replace table key p;
+    p
+
+
+(** Add the parts of the prefix header to the result of a parse with its
+    precompiled header. Macros of the file take precedence. *)
+let merge (p:pch) (r:parse_result) : parse_result =
+  let names = List.map (fun m -> m.macro_name) r.parse_macros in
+  { r with
+    parse_files = List.sort_uniq compare (p.pch_files @ r.parse_files);
+    parse_comments = List.sort_uniq compare (p.pch_comments @ r.parse_comments);
+    parse_macros = List.filter (fun m -> not (List.mem m.macro_name names)) p.pch_macros @ r.parse_macros;
+    parse_loc_files = List.sort_uniq compare (p.pch_loc_files @ r.parse_loc_files);
+  }
+
+
+(** Drop-in replacement to [Clang_parser.parse], using the precompiled
+    header of the project prefix when the file starts with it. An out of
+    date precompiled header is rebuilt once, then the file is parsed
+    without it. *)
+let parse cmd tgt file opts : parse_result =
+  let plain () = Clang_parser.parse ~command:cmd ~target:tgt ~filename:file ~args:opts in
+  if not !enabled || !prefix = [] || not (is_prefix !prefix (leading_includes file)) then plain ()
+  else
+    let key = signature cmd tgt opts in
+    let rec with_pch retry =
+      match build key cmd tgt opts with
+      | None -> plain ()
+      | Some p ->
+        let opts' = Array.append [| "-include-pch"; p.pch_file |] opts in
+        match Clang_parser.parse ~command:cmd ~target:tgt ~filename:file ~args:opts' with
+        | r -> merge p r
+        | exception Failure msg ->
+          debug "%s: %s" p.pch_file msg;
+          (try Sys.remove p.pch_file with Sys_error _ -> ());
+          if retry then (Hashtbl.remove table key; with_pch false)
+          else (Hashtbl.replace table key None; plain ())
+    in
+    with_pch true
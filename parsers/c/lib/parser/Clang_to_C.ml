@@ -101,6 +101,12 @@ type context = {
     ctx_vars: (string,variable) Hashtbl.t; (* globals (extern & static) *)
     ctx_funcs: (string,func) Hashtbl.t;
 
+    (* maps from original name and structural hash to the merged definition,
+       to translate only once identical declarations from shared headers *)
+    ctx_shared_enums: (string * int,enum_type) Hashtbl.t;
+    ctx_shared_records: (string * int,record_type) Hashtbl.t;
+    ctx_shared_typedefs: (string * int,typedef) Hashtbl.t;
+
     ctx_simplify: C_simplify.context;
 
     mutable ctx_files : SetExt.StringSet.t; (** set of parsed files *)
@@ -133,6 +139,9 @@ let create_context (project_name:string) (info:C.target_info) =
     ctx_typedefs = Hashtbl.create 16;
     ctx_vars = Hashtbl.create 16;
     ctx_funcs = Hashtbl.create 16;
+    ctx_shared_enums = Hashtbl.create 16;
+    ctx_shared_records = Hashtbl.create 16;
+    ctx_shared_typedefs = Hashtbl.create 16;
     ctx_names = Hashtbl.create 16;
     ctx_simplify = C_simplify.create_context info;
     ctx_files = SetExt.StringSet.empty;
@@ -343,6 +352,14 @@ let add_translation_unit (ctx:context) (tu_name:string) (decl:C.decl) (files: st
       (* already in translation unit *)
       Hashtbl.find ctx.ctx_tu_enums e.C.enum_uid
     else
+    let key = e.C.enum_name.C.name_print, e.C.enum_hash in
+    match Hashtbl.find_opt ctx.ctx_shared_enums key with
+    | Some enum ->
+      (* identical to a declaration of a previous translation unit *)
+      if !log_merge then Printf.printf "shared enum declaration for '%s' (%s)\n" (fst key) enum.enum_unique_name;
+      Hashtbl.add ctx.ctx_tu_enums e.C.enum_uid enum;
+      enum
+    | None ->
       (* name *)
       let org_name = e.C.enum_name.C.name_print in
       let nice_name =
@@ -417,9 +434,38 @@ let add_translation_unit (ctx:context) (tu_name:string) (decl:C.decl) (files: st
       let enum = merge (if org_name = "" then [] else Hashtbl.find_all ctx.ctx_enums org_name) in
       if nice_name <> "" then Hashtbl.add ctx.ctx_enums nice_name enum;
       Hashtbl.add ctx.ctx_tu_enums e.C.enum_uid enum;
+      if org_name <> "" && enum.enum_defined then Hashtbl.replace ctx.ctx_shared_enums key enum;
       enum
 
 
+  (* Anonymous records and enums in a declaration shared with a previous
+     translation unit are not shared by themselves, as they have no name:
+     map them to the corresponding types of the shared declaration, so that
+     expressions of this translation unit use the same records. *)
+  and share_anonymous ((t,q):C.type_qual) ((t',q'):type_qual) =
+    match t, t' with
+    | C.RecordType r, T_record r' ->
+      if r.C.record_name.C.name_print = "" && not (Hashtbl.mem ctx.ctx_tu_records r.C.record_uid) then (
+        Hashtbl.add ctx.ctx_tu_records r.C.record_uid r';
+        share_anonymous_fields r r'
+      )
+    | C.EnumType e, T_enum e' ->
+      if e.C.enum_name.C.name_print = "" && not (Hashtbl.mem ctx.ctx_tu_enums e.C.enum_uid) then
+        Hashtbl.add ctx.ctx_tu_enums e.C.enum_uid e'
+    | (C.ElaboratedType tq | C.ParenType tq | C.AttributedType tq | C.AtomicType tq), _ ->
+      share_anonymous tq (t',q')
+    | _, T_bitfield (t',_) -> share_anonymous (t,q) (t',q')
+    | C.PointerType tq, T_pointer tq' -> share_anonymous tq tq'
+    | C.ArrayType a, T_array (tq',_) -> share_anonymous a.C.array_element_type tq'
+    | _ -> ()
+
+  and share_anonymous_fields e record =
+    List.iteri (fun i f ->
+        if i < Array.length record.record_fields then
+          share_anonymous f.C.field_type record.record_fields.(i).field_type
+      ) e.C.record_fields
+
+
   (* struct, unions *)
 
   and record_decl e =
@@ -427,6 +473,15 @@ let add_translation_unit (ctx:context) (tu_name:string) (decl:C.decl) (files: st
       (* already in translation unit *)
       Hashtbl.find ctx.ctx_tu_records e.C.record_uid
     else
+    let key = e.C.record_name.C.name_print, e.C.record_hash in
+    match Hashtbl.find_opt ctx.ctx_shared_records key with
+    | Some record ->
+      (* identical to a declaration of a previous translation unit *)
+      if !log_merge then Printf.printf "shared record declaration for '%s' (%s)\n" (fst key) record.record_unique_name;
+      Hashtbl.add ctx.ctx_tu_records e.C.record_uid record;
+      share_anonymous_fields e record;
+      record
+    | None ->
       (* name *)
       let org_name = e.C.record_name.C.name_print in
       let nice_name =
@@ -512,6 +567,8 @@ let add_translation_unit (ctx:context) (tu_name:string) (decl:C.decl) (files: st
       in
       if nice_name <> "" then Hashtbl.add ctx.ctx_records nice_name record;
       Hashtbl.replace ctx.ctx_tu_records e.C.record_uid record;
+      if org_name <> "" && e.C.record_is_complete && record.record_defined then
+        Hashtbl.replace ctx.ctx_shared_records key record;
       record
 
 
@@ -522,6 +579,15 @@ let add_translation_unit (ctx:context) (tu_name:string) (decl:C.decl) (files: st
       (* already in translation unit *)
       Hashtbl.find ctx.ctx_tu_typedefs t.C.typedef_uid
     else
+    let key = t.C.typedef_name.C.name_print, t.C.typedef_hash in
+    match Hashtbl.find_opt ctx.ctx_shared_typedefs key with
+    | Some def ->
+      (* identical to a declaration of a previous translation unit *)
+      if !log_merge then Printf.printf "shared typedef declaration for '%s' (%s)\n" (fst key) def.typedef_unique_name;
+      Hashtbl.add ctx.ctx_tu_typedefs t.C.typedef_uid def;
+      share_anonymous t.C.typedef_underlying_type def.typedef_def;
+      def
+    | None ->
       let org_name = t.C.typedef_name.C.name_print in
       let range = t.C.typedef_range in
       let def = {
@@ -553,6 +619,7 @@ let add_translation_unit (ctx:context) (tu_name:string) (decl:C.decl) (files: st
       in
       let def = merge (Hashtbl.find_all ctx.ctx_typedefs org_name) in
       Hashtbl.replace ctx.ctx_tu_typedefs t.C.typedef_uid def;
+      Hashtbl.replace ctx.ctx_shared_typedefs key def;
       def
 
 
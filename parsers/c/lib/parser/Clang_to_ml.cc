@@ -31,6 +31,7 @@
 /* Clang includes */
 #include "llvm/Support/Host.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
+#include "llvm/Support/Timer.h"
 #include "clang/Lex/PreprocessorOptions.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Basic/DiagnosticOptions.h"
@@ -50,6 +51,7 @@
 #include "clang/Frontend/TextDiagnosticPrinter.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendAction.h"
+#include "clang/Frontend/FrontendActions.h"
 
 #if CLANG_VERSION_MAJOR >= 10
 #include "clang/Basic/Builtins.h"
@@ -69,6 +71,9 @@
 /* Other includes */
 #include <iostream>
 #include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace clang;
 
@@ -85,6 +90,10 @@ static const bool cache_statistics = false;
 /* log when emitting an unknown node */
 static const bool log_unknown = true;
 
+/* only translate stub comments, and the macros they use;
+   set from OCaml before parsing, read by the parsing threads */
+static bool stub_comments_only = false;
+
 #ifndef CLANGRESOURCE
 #error "CLANGRESOURCE must be defined, e.g., -DCLANGRESOURCE=/usr/lib/clang/5.0.0"
 #endif
@@ -279,6 +288,39 @@ public:
 
 
 
+/* Structural hashes */
+/* ***************** */
+
+/* Type declarations included from the same header in several translation
+   units are translated several times. We attach to them a hash of their
+   name, location and structure, so that they can be recognized when
+   linking translation units.
+
+   The hash must not depend on pointers or on the process, as parse
+   results are stored in the parser cache: we use FNV-1a.
+ */
+
+static const uint64_t hash_seed = 0xcbf29ce484222325ULL;
+
+static inline uint64_t hash_byte(uint64_t h, unsigned char c) {
+  return (h ^ c) * 0x100000001b3ULL;
+}
+
+static uint64_t hash_int(uint64_t h, uint64_t v) {
+  for (int i = 0; i < 8; i++) h = hash_byte(h, (v >> (8 * i)) & 0xff);
+  return h;
+}
+
+static uint64_t hash_string(uint64_t h, StringRef s) {
+  for (char c : s) h = hash_byte(h, c);
+  return hash_int(h, s.size());
+}
+
+/* as an OCaml int */
+#define Val_hash(h) Val_long((h) & Max_long)
+
+
+
 /* UTILITIES */
 /*************/
 
@@ -482,69 +524,113 @@ public:
 
 
 /* The AST has a large number of location information.
-   We try to cache them aggressively.
+   A location is translated into an OCaml int packing a file identifier
+   (22 bits), a line (24 bits) and a column (16 bits), or -1 for invalid
+   locations. Longer lines and columns are truncated.
+
+   File identifiers index a table of file names shared by all translation
+   units. They are derived from a hash of the file name, so that they are
+   mostly the same across processes: parse results stored in the parser
+   cache are only valid if their files get the same identifiers.
+   The table is only accessed from the OCaml thread.
  */
 
+#define LOC_FILE_BITS 22
+#define LOC_LINE_BITS 24
+#define LOC_COLUMN_BITS 16
+
+static std::unordered_map<long,std::string> loc_file_names;
+static std::unordered_map<std::string,long> loc_file_ids;
+
+/* identifier of a file name, allocated if needed */
+static long GetLocFileId(const std::string& name) {
+  auto it = loc_file_ids.find(name);
+  if (it != loc_file_ids.end()) return it->second;
+  const long mask = (1L << LOC_FILE_BITS) - 1;
+  long id = hash_string(hash_seed, name) & mask;
+  while (loc_file_names.count(id)) id = (id + 1) & mask;
+  loc_file_names[id] = name;
+  loc_file_ids[name] = id;
+  return id;
+}
+
+static long PackLoc(long file, long line, long column) {
+  const long max_line = (1L << LOC_LINE_BITS) - 1;
+  const long max_column = (1L << LOC_COLUMN_BITS) - 1;
+  return (file << (LOC_LINE_BITS + LOC_COLUMN_BITS))
+    | (std::min(line, max_line) << LOC_COLUMN_BITS)
+    | std::min(column, max_column);
+}
+
+/* int -> string */
+CAML_EXPORT value mlclang_loc_file_name(value id) {
+  CAMLparam1(id);
+  auto it = loc_file_names.find(Long_val(id));
+  CAMLreturn(caml_copy_string(it == loc_file_names.end() ? "<invalid>" : it->second.c_str()));
+}
+
+/* string -> int */
+CAML_EXPORT value mlclang_loc_file_id(value name) {
+  CAMLparam1(name);
+  CAMLreturn(Val_long(GetLocFileId(String_val(name))));
+}
+
+/* int -> string -> bool
+   registers the identifier of a file given by a cached parse result;
+   returns false if it is already used by another file */
+CAML_EXPORT value mlclang_register_loc_file(value id, value name) {
+  CAMLparam2(id, name);
+  std::string n = String_val(name);
+  auto it = loc_file_names.find(Long_val(id));
+  if (it != loc_file_names.end()) CAMLreturn(Val_bool(it->second == n));
+  if (loc_file_ids.count(n)) CAMLreturn(Val_false);
+  loc_file_names[Long_val(id)] = n;
+  loc_file_ids[n] = Long_val(id);
+  CAMLreturn(Val_true);
+}
+
+
 class MLLocationTranslator {
 
  private:
   SourceManager& src;
   const LangOptions &opts;
-  Cache cacheLoc;
-  Cache cacheFile;
-  value invalid_file;
+  std::unordered_map<unsigned,long> locs;     // raw location -> location
+  std::unordered_map<unsigned,long> ends;     // raw location -> end of its token
+  std::unordered_map<const char*,long> files; // presumed file name -> identifier
+  Cache cacheRange;
 
 public:
   CAMLprim value TranslateSourceLocation(SourceLocation a, int offset = 0);
   CAMLprim value TranslateSourceRange(SourceRange a);
+  CAMLprim value getLocFiles();
 
   MLLocationTranslator(SourceManager& src, const LangOptions &opts)
-    : src(src), opts(opts), cacheLoc("location"), cacheFile("filename") {
-    invalid_file = caml_copy_string("<invalid>");
-    caml_register_global_root(&invalid_file);
-  }
-
-  ~MLLocationTranslator() {
-    caml_remove_global_root(&invalid_file);
-  }
+    : src(src), opts(opts), cacheRange("range")
+  {}
 
-  CAMLprim value getFiles() { return cacheFile.get_values(); }
+private:
+  long PackSourceLocation(SourceLocation a, int offset);
 
 };
 
+long MLLocationTranslator::PackSourceLocation(SourceLocation a, int offset) {
+  PresumedLoc loc = src.getPresumedLoc(a);
+  if (!loc.isValid()) return -1;
+  const char* filename = loc.getFilename();
+  auto it = files.find(filename);
+  long file = it != files.end() ? it->second : (files[filename] = GetLocFileId(filename));
+  // Clang counts lines & columns starting from 1
+  // we count lines from 1 but columns from 0
+  return PackLoc(file, loc.getLine(), loc.getColumn() - 1 + offset);
+}
+
 CAMLprim value MLLocationTranslator::TranslateSourceLocation(SourceLocation a, int offset) {
-  CAMLparam0();
-  CAMLlocal2(ret,tmp);
+  if (offset) return Val_long(PackSourceLocation(a, offset));
   unsigned raw = a.getRawEncoding();
-  PresumedLoc loc;  
-  CACHED(cacheLoc, ret, raw, {
-      loc = src.getPresumedLoc(a);
-      ret = caml_alloc_tuple(3);
-
-      if (loc.isValid()) {
-        const char* filename = loc.getFilename();
-        if (cacheFile.contains(filename)) {
-          tmp = cacheFile.get(filename);
-        }
-        else {
-          tmp = caml_copy_string(filename);
-          cacheFile.store(filename, tmp);
-        }
-        // Clang counts lines & columns starting from 1
-        // we count lines from 1 but columns from 0
-        Store_field(ret, 0, Val_int(loc.getLine()));
-        Store_field(ret, 1, Val_int(loc.getColumn()-1+offset));
-        Store_field(ret, 2, tmp);
-      }
-      else {
-        Store_field(ret, 0, Val_int(-1));
-        Store_field(ret, 1, Val_int(-1));
-        Store_field(ret, 2, invalid_file);
-      }
-
-    });
-
-  CAMLreturn(ret);
+  auto it = locs.find(raw);
+  if (it != locs.end()) return Val_long(it->second);
+  return Val_long(locs[raw] = PackSourceLocation(a, 0));
 }
 
 
@@ -552,16 +638,37 @@ CAMLprim value MLLocationTranslator::TranslateSourceLocation(SourceLocation a, i
 CAMLprim value MLLocationTranslator::TranslateSourceRange(SourceRange a) {
   CAMLparam0();
   CAMLlocal1(ret);
-  ret = caml_alloc_tuple(2);
-  // from the begining of the first token...
-  Store_field(ret, 0, TranslateSourceLocation(a.getBegin()));
-  // ...to the last character of the last token (if possible)
-  SourceLocation end(clang::Lexer::getLocForEndOfToken(a.getEnd(),0,src,opts));
-  if (src.getPresumedLoc(end).isValid()) {
-    Store_field(ret, 1, TranslateSourceLocation(end));
-  }
-  else {
-    Store_field(ret, 1, TranslateSourceLocation(a.getEnd(), 1));
+  uintptr_t key = ((uintptr_t)a.getBegin().getRawEncoding() << 32) | a.getEnd().getRawEncoding();
+  CACHED(cacheRange, ret, key, {
+      ret = caml_alloc_tuple(2);
+      // from the begining of the first token...
+      Store_field(ret, 0, TranslateSourceLocation(a.getBegin()));
+      // ...to the last character of the last token (if possible)
+      unsigned raw = a.getEnd().getRawEncoding();
+      auto it = ends.find(raw);
+      if (it == ends.end()) {
+        SourceLocation end(clang::Lexer::getLocForEndOfToken(a.getEnd(),0,src,opts));
+        long l = src.getPresumedLoc(end).isValid() ? PackSourceLocation(end, 0) : PackSourceLocation(a.getEnd(), 1);
+        it = ends.insert({ raw, l }).first;
+      }
+      Store_field(ret, 1, Val_long(it->second));
+    });
+  CAMLreturn(ret);
+}
+
+/* (int * string) list of the files of the translated locations */
+CAMLprim value MLLocationTranslator::getLocFiles() {
+  CAMLparam0();
+  CAMLlocal3(ret,tmp1,tmp2);
+  ret = Val_emptylist;
+  for (auto& f : files) {
+    tmp1 = caml_alloc_tuple(2);
+    Store_field(tmp1, 0, Val_long(f.second));
+    Store_field(tmp1, 1, caml_copy_string(loc_file_names[f.second].c_str()));
+    tmp2 = caml_alloc_tuple(2);
+    Store_field(tmp2, 0, tmp1);
+    Store_field(tmp2, 1, ret);
+    ret = tmp2;
   }
   CAMLreturn(ret);
 }
@@ -579,7 +686,12 @@ class MLCommentTranslator {
   SourceManager& src;
   MLLocationTranslator& loc;
 
+  std::set<const RawComment*> stubs;
+  /* translated stub comments, when stub_comments_only is set */
+
 public:
+  bool IsTranslated(const RawComment *x);
+  const std::set<const RawComment*>& getStubComments() { return stubs; }
   CAMLprim value TranslateCommentKind(RawComment::CommentKind c);
   CAMLprim value TranslateRawComment(const RawComment *x);
   CAMLprim value TranslateRawCommentOpt(const RawComment *x);
@@ -636,13 +748,23 @@ CAMLprim value MLCommentTranslator::TranslateRawComment(const RawComment *x) {
   CAMLreturn(ret);
 }
 
+/* Whether the comment is translated: with stub_comments_only, only
+   comments starting with the stub marker are, as other comments are
+   ignored by the analyzer. */
+bool MLCommentTranslator::IsTranslated(const RawComment *x) {
+  if (!stub_comments_only) return true;
+  if (x->getRawText(src).str().compare(0, 3, "/*$") != 0) return false;
+  stubs.insert(x);
+  return true;
+}
+
 /* RawComment (possibly NULL) -> comment list (0- or 1-length) */
 CAMLprim value MLCommentTranslator::TranslateRawCommentOpt(const RawComment *x) {
   CAMLparam0();
   CAMLlocal1(ret);
 
   ret = Val_emptylist;
-  if (x) {
+  if (x && IsTranslated(x)) {
     ret = caml_alloc_tuple(2);
     Store_field(ret, 0, TranslateRawComment(x));
     Store_field(ret, 1, Val_emptylist);
@@ -654,19 +776,21 @@ CAMLprim value MLCommentTranslator::TranslateRawCommentOpt(const RawComment *x)
 CAMLprim value MLCommentTranslator::getRawCommentList(ASTContext& Context) {
   CAMLparam0();
   CAMLlocal1(ret);
+  std::vector<RawComment*> c;
 #if CLANG_VERSION_MAJOR < 10
-  GENERATE_LIST(ret, Context.getRawCommentList().getComments(), TranslateRawComment(child));
+  for (auto cc : Context.getRawCommentList().getComments()) {
+    if (IsTranslated(cc)) c.push_back(cc);
+  }
 #else
-  std::vector<RawComment*> c;
   FileID id = Context.getSourceManager().getMainFileID();
   auto coms = Context.Comments.getCommentsInFile(id);
   if (coms != nullptr) {
     for (auto cc : *coms) {
-      c.push_back(cc.second);
+      if (IsTranslated(cc.second)) c.push_back(cc.second);
     }
   }
-  GENERATE_LIST(ret, c, TranslateRawComment(child));
 #endif
+  GENERATE_LIST(ret, c, TranslateRawComment(child));
   CAMLreturn(ret);
 }
 
@@ -700,6 +824,20 @@ private:
   Cache cacheMisc3;
   int uid;
 
+  std::unordered_map<const Decl*,std::pair<uint64_t,size_t>> hashes;
+  /* structural hashes of type declarations, with the depth of the oldest
+     declaration still being hashed that they depend on (SIZE_MAX if none) */
+
+  std::unordered_map<const Decl*,size_t> hashing;
+  /* declarations being hashed, with their depth */
+
+  std::vector<const Decl*> hash_pending;
+  /* hashed declarations that depend on a declaration still being hashed */
+
+  uint64_t HashDecl(const NamedDecl * x);
+  uint64_t HashDecl(const NamedDecl * x, size_t & low);
+  uint64_t HashType(QualType x, size_t & low);
+
 public:
   CAMLprim value TranslateAPInt(const llvm::APInt & i);
   CAMLprim value TranslateAPSInt(const llvm::APSInt & i);
@@ -4331,7 +4469,7 @@ CAMLprim value MLTreeBuilderVisitor::TranslateEnumDecl(const EnumDecl * org) {
   check_null(org, "TranslateEnumDecl");
   const EnumDecl * x = org;
   //x = x->getCanonicalDecl();
-  WITH_CACHE_TUPLE(cacheMisc, ret, x, 11, {
+  WITH_CACHE_TUPLE(cacheMisc, ret, x, 12, {
       Store_uid(ret, 0);
       Store_field(ret, 1, TranslateNamedDecl(x));
       Store_field(ret, 2, Val_int(x->getNumPositiveBits()));
@@ -4343,6 +4481,7 @@ CAMLprim value MLTreeBuilderVisitor::TranslateEnumDecl(const EnumDecl * org) {
       Store_field_option(ret, 8, x->getTypedefNameForAnonDecl(), TranslateTypedefNameDecl(x->getTypedefNameForAnonDecl()));
       Store_field(ret, 9, loc.TranslateSourceRange(org->getSourceRange()));
       Store_field(ret, 10, com.TranslateRawCommentOpt(Context->getRawCommentForDeclNoCache(org)));
+      Store_field(ret, 11, Val_hash(HashDecl(x)));
     });
   CAMLreturn(ret);
 }
@@ -4397,7 +4536,7 @@ CAMLprim value MLTreeBuilderVisitor::TranslateRecordDecl(const RecordDecl * org)
   check_null(org, "TranslateRecordDecl");
   const RecordDecl *x = org;
   //x = dyn_cast<RecordDecl>(x->getCanonicalDecl());
-  WITH_CACHE_TUPLE(cacheMisc, ret, x, 19, {
+  WITH_CACHE_TUPLE(cacheMisc, ret, x, 20, {
       Store_uid(ret, 0);
       Store_field(ret, 1, TranslateNamedDecl(x));
       int kind;
@@ -4447,6 +4586,7 @@ CAMLprim value MLTreeBuilderVisitor::TranslateRecordDecl(const RecordDecl * org)
         Store_field_list(ret, 17, d->methods(), TranslateFunctionDecl(child));
         Store_field_list(ret, 18, d->friends(), TranslateFriendDecl(child));
       }
+      Store_field(ret, 19, Val_hash(HashDecl(x)));
     });
   CAMLreturn(ret);
 }
@@ -4481,17 +4621,145 @@ CAMLprim value MLTreeBuilderVisitor::TranslateTypedefNameDecl(const TypedefNameD
   const TypedefNameDecl * x = org;
   // NOTE: the canonical decl may sometimes miss its name!
   // x = dyn_cast<TypedefDecl>(x->getCanonicalDecl());
-  WITH_CACHE_TUPLE(cacheMisc, ret, x, 5, {
+  WITH_CACHE_TUPLE(cacheMisc, ret, x, 6, {
       Store_uid(ret, 0);
       Store_field(ret, 1, TranslateNamedDecl(x));
       Store_field(ret, 2, TranslateQualType(x->getUnderlyingType()));
       Store_field(ret, 3, loc.TranslateSourceRange(org->getSourceRange()));
       Store_field(ret, 4, com.TranslateRawCommentOpt(Context->getRawCommentForDeclNoCache(org)));
+      Store_field(ret, 5, Val_hash(HashDecl(x)));
     });
   CAMLreturn(ret);
 }
 
 
+/* Structural hash of a record, enum or typedef declaration.
+
+   A declaration being hashed only contributes its name to the hash of
+   the types it contains, which handles recursive types. The hash of a
+   declaration reached from a declaration still being hashed thus misses
+   the structure of the latter: it is completed with the hash of the
+   outermost declaration of the cycle once that hash is known, as in
+   Tarjan's algorithm for strongly connected components.
+ */
+uint64_t MLTreeBuilderVisitor::HashDecl(const NamedDecl * x) {
+  size_t low = SIZE_MAX;
+  return HashDecl(x, low);
+}
+
+/* [low] is lowered to the depth of the oldest declaration being hashed
+   that the hash of [x] depends on. */
+uint64_t MLTreeBuilderVisitor::HashDecl(const NamedDecl * x, size_t & low) {
+  auto it = hashes.find(x);
+  if (it != hashes.end()) {
+    if (it->second.second < low) low = it->second.second;
+    return it->second.first;
+  }
+
+  uint64_t h = hash_string(hash_int(hash_seed, x->getKind()), x->getName());
+  if (const TagDecl* t = dyn_cast<TagDecl>(x))
+    if (const TypedefNameDecl* d = t->getTypedefNameForAnonDecl())
+      h = hash_string(h, d->getName());
+
+  auto cur = hashing.find(x);
+  if (cur != hashing.end()) {
+    // recursive reference: name only
+    if (cur->second < low) low = cur->second;
+    return h;
+  }
+  size_t depth = hashing.size();
+  hashing[x] = depth;
+  size_t mylow = SIZE_MAX;
+
+  PresumedLoc p = src.getPresumedLoc(x->getLocation());
+  if (p.isValid()) h = hash_int(hash_string(h, p.getFilename()), p.getLine());
+
+  if (const RecordDecl* r = dyn_cast<RecordDecl>(x)) {
+    h = hash_int(h, r->getTagKind());
+    h = hash_int(h, r->isCompleteDefinition());
+    if (r->isCompleteDefinition() && !r->isInvalidDecl() && !r->isDependentType()) {
+      const ASTRecordLayout & l = Context->getASTRecordLayout(r);
+      h = hash_int(h, l.getSize().getQuantity());
+      h = hash_int(h, l.getAlignment().getQuantity());
+      for (const FieldDecl* f : r->fields()) {
+        h = hash_string(h, f->getName());
+        h = hash_int(h, l.getFieldOffset(f->getFieldIndex()));
+        h = hash_int(h, f->isBitField() ? f->getBitWidthValue(*Context) + 1 : 0);
+        h = hash_int(h, HashType(f->getType(), mylow));
+      }
+    }
+  }
+  else if (const EnumDecl* e = dyn_cast<EnumDecl>(x)) {
+    h = hash_int(h, e->isComplete());
+    h = hash_int(h, HashType(e->getIntegerType(), mylow));
+    for (const EnumConstantDecl* c : e->enumerators()) {
+      h = hash_string(h, c->getName());
+      h = hash_int(h, c->getInitVal().extOrTrunc(64).getZExtValue());
+    }
+  }
+  else if (const TypedefNameDecl* d = dyn_cast<TypedefNameDecl>(x)) {
+    h = hash_int(h, HashType(d->getUnderlyingType(), mylow));
+  }
+
+  hashing.erase(x);
+
+  if (mylow >= depth) {
+    // x is not part of a cycle through an enclosing declaration: its hash
+    // is complete, and so are the pending hashes depending on x
+    std::vector<const Decl*> rest;
+    for (const Decl* d : hash_pending) {
+      auto & e = hashes[d];
+      if (e.second >= depth) e = std::make_pair(hash_int(e.first, h), SIZE_MAX);
+      else rest.push_back(d);
+    }
+    hash_pending.swap(rest);
+    mylow = SIZE_MAX;
+  }
+  else {
+    // the pending hashes depending on x now depend on the cycle of x
+    for (const Decl* d : hash_pending) {
+      auto & e = hashes[d];
+      if (e.second >= depth) e.second = mylow;
+    }
+    hash_pending.push_back(x);
+  }
+
+  hashes[x] = std::make_pair(h, mylow);
+  if (mylow < low) low = mylow;
+  return h;
+}
+
+/* Structural hash of a type, following the sugar kept in type_qual. */
+uint64_t MLTreeBuilderVisitor::HashType(QualType x, size_t & low) {
+  if (x.isNull()) return 0;
+  const Type* t = x.getTypePtr();
+  uint64_t h = hash_int(hash_int(hash_seed, x.getLocalCVRQualifiers()), t->getTypeClass());
+
+  if (const TypedefType* d = dyn_cast<TypedefType>(t))
+    return hash_int(h, HashDecl(d->getDecl(), low));
+  if (const TagType* d = dyn_cast<TagType>(t))
+    return hash_int(h, HashDecl(d->getDecl(), low));
+  if (const BuiltinType* b = dyn_cast<BuiltinType>(t))
+    return hash_int(h, b->getKind());
+  if (const PointerType* p = dyn_cast<PointerType>(t))
+    return hash_int(h, HashType(p->getPointeeType(), low));
+  if (const ConstantArrayType* a = dyn_cast<ConstantArrayType>(t))
+    return hash_int(hash_int(h, a->getSize().getLimitedValue()), HashType(a->getElementType(), low));
+  if (const ArrayType* a = dyn_cast<ArrayType>(t))
+    return hash_int(h, HashType(a->getElementType(), low));
+  if (const FunctionProtoType* f = dyn_cast<FunctionProtoType>(t)) {
+    h = hash_int(hash_int(h, f->isVariadic()), HashType(f->getReturnType(), low));
+    for (QualType p : f->getParamTypes()) h = hash_int(h, HashType(p, low));
+    return h;
+  }
+  if (const FunctionType* f = dyn_cast<FunctionType>(t))
+    return hash_int(h, HashType(f->getReturnType(), low));
+  if (t->isSugared())
+    return hash_int(h, HashType(t->getLocallyUnqualifiedSingleStepDesugaredType(), low));
+  return hash_string(h, QualType(t, 0).getAsString());
+}
+
+
 
 
 
@@ -4507,17 +4775,16 @@ private:
   // Diagnostics are accumulated in this vector
 
   std::vector<diag> diags;
-  MLLocationTranslator& loc;
 
 public:
-  MLDiagnostics(MLLocationTranslator& loc) : loc(loc)
+  MLDiagnostics()
   {}
 
   void HandleDiagnostic(DiagnosticsEngine::Level DiagLevel,
                         const Diagnostic &Info) override;
 
-  CAMLprim value getDiagnostics();
-  CAMLprim value TranslateDiagnostics(diag d);
+  CAMLprim value getDiagnostics(MLLocationTranslator& loc);
+  CAMLprim value TranslateDiagnostics(diag d, MLLocationTranslator& loc);
 };
 
 void MLDiagnostics::HandleDiagnostic(DiagnosticsEngine::Level Level,
@@ -4532,10 +4799,12 @@ void MLDiagnostics::HandleDiagnostic(DiagnosticsEngine::Level Level,
 
 
 // Converts accumulated diagnostics to Ocaml list
-CAMLprim value MLDiagnostics::getDiagnostics() {
+// Diagnostics are only accumulated during parsing, and translated when
+// the OCaml runtime is available
+CAMLprim value MLDiagnostics::getDiagnostics(MLLocationTranslator& loc) {
   CAMLparam0();
   CAMLlocal1(ret);
-  GENERATE_LIST(ret, diags, TranslateDiagnostics(child));
+  GENERATE_LIST(ret, diags, TranslateDiagnostics(child, loc));
   CAMLreturn(ret);
 }
 
@@ -4549,7 +4818,7 @@ enum {
   MLTAG_Level_Fatal,
 };
 
-CAMLprim value MLDiagnostics::TranslateDiagnostics(MLDiagnostics::diag d) {
+CAMLprim value MLDiagnostics::TranslateDiagnostics(MLDiagnostics::diag d, MLLocationTranslator& loc) {
   CAMLparam0();
   CAMLlocal1(ret);
 
@@ -4782,39 +5051,92 @@ CAML_EXPORT value mlclang_get_target_info(value target) {
 /************* */
 
 
-CAMLprim value getMacroTable(SourceManager& src, Preprocessor &pp, MLLocationTranslator& loc)
+/* name, MacroInfo -> macro */
+CAMLprim value TranslateMacro(SourceManager& src, MLLocationTranslator& loc, StringRef name, const MacroInfo* m)
+{
+  CAMLparam0();
+  CAMLlocal3(ret,tmp1,tmp2);
+
+  GENERATE_LIST(tmp1, m->params(),
+                caml_copy_string(child->getName().str().c_str())
+                );
+
+  GENERATE_LIST(tmp2, m->tokens(),
+                caml_copy_string((std::string(src.getCharacterData(child.getLocation()), child.getLength())).c_str())
+                );
+
+  ret = caml_alloc_tuple(4);
+  Store_field(ret, 0, caml_copy_string(name.str().c_str()));
+  Store_field(ret, 1, tmp1);
+  Store_field(ret, 2, tmp2);
+  Store_field(ret, 3, loc.TranslateSourceLocation(m->getDefinitionLoc()));
+
+  CAMLreturn(ret);
+}
+
+/* identifiers appearing in a text */
+static void getIdentifiers(StringRef text, std::vector<std::string>& ids)
+{
+  auto is_ident = [&](size_t k) { return isalnum((unsigned char)text[k]) || text[k] == '_'; };
+  size_t i = 0, n = text.size();
+  while (i < n) {
+    size_t j = i + 1;
+    if (is_ident(i)) {
+      // numbers are skipped as a whole
+      while (j < n && is_ident(j)) j++;
+      if (!isdigit((unsigned char)text[i])) ids.push_back(text.substr(i, j - i).str());
+    }
+    i = j;
+  }
+}
+
+/* With stub_comments_only, only the macros used in the translated stub
+   comments are returned, transitively through the body of macros.
+   Otherwise, all the macros defined at the end of the translation unit
+   are returned.
+ */
+CAMLprim value getMacroTable(SourceManager& src, Preprocessor &pp, MLLocationTranslator& loc, MLCommentTranslator& com)
 {
   CAMLparam0();
-  CAMLlocal4(ret,tmp1,tmp2,tmp3);
+  CAMLlocal3(ret,tmp1,tmp2);
 
   ret = Val_false;
-  
-  const IdentifierTable & tbl = pp.getIdentifierTable();
-  for (auto& id : tbl) {
-    const IdentifierInfo* i = id.getValue();
-    if (i->hasMacroDefinition()) {
-      MacroInfo* m = pp.getMacroInfo(i);
-
-      GENERATE_LIST(tmp1, m->params(),
-                    caml_copy_string(child->getName().str().c_str())
-                    );
-
-      GENERATE_LIST(tmp2, m->tokens(),
-                    caml_copy_string((std::string(src.getCharacterData(child.getLocation()), child.getLength())).c_str())
-                    );
-
-      tmp3 = caml_alloc_tuple(4);
-      Store_field(tmp3, 0, caml_copy_string(id.getKey().str().c_str()));
-      Store_field(tmp3, 1, tmp1);
-      Store_field(tmp3, 2, tmp2);
-      Store_field(tmp3, 3, loc.TranslateSourceLocation(m->getDefinitionLoc()));
-
-      tmp1 = caml_alloc_tuple(2);
-      Store_field(tmp1, 0, tmp3);
-      Store_field(tmp1, 1, ret);
-      ret = tmp1;
+
+  // Macros of a precompiled header are not in the identifier table until
+  // they are looked up: identifiers are found through the preprocessor,
+  // which queries the external sources.
+  std::vector<std::pair<StringRef,const MacroInfo*>> macros;
+  if (!stub_comments_only) {
+    for (const auto& m : pp.macros(true)) {
+      const IdentifierInfo* i = m.first;
+      if (i->hasMacroDefinition()) macros.push_back({ i->getName(), pp.getMacroInfo(i) });
     }
   }
+  else {
+    std::vector<std::string> todo;
+    std::set<std::string> seen;
+    for (const RawComment* c : com.getStubComments()) getIdentifiers(c->getRawText(src), todo);
+    while (!todo.empty()) {
+      std::string name = todo.back();
+      todo.pop_back();
+      if (!seen.insert(name).second) continue;
+      const IdentifierInfo* id = pp.getIdentifierInfo(name);
+      if (!id || !id->hasMacroDefinition()) continue;
+      const MacroInfo* m = pp.getMacroInfo(id);
+      if (!m) continue;
+      for (const Token& t : m->tokens())
+        if (const IdentifierInfo* i = t.getIdentifierInfo()) todo.push_back(i->getName().str());
+      macros.push_back({ id->getName(), m });
+    }
+  }
+
+  for (auto& m : macros) {
+    tmp1 = TranslateMacro(src, loc, m.first, m.second);
+    tmp2 = caml_alloc_tuple(2);
+    Store_field(tmp2, 0, tmp1);
+    Store_field(tmp2, 1, ret);
+    ret = tmp2;
+  }
 
   CAMLreturn(ret);
 }
@@ -4846,68 +5168,98 @@ CAMLprim value getSources(SourceManager& src)
 /* ******* */
 
 
-class MLTreeBuilderConsumer : public ASTConsumer {
-private:
-
-  value* ret;
-  MLLocationTranslator& loc;
-  MLCommentTranslator& com;
-  SourceManager& src;
+/* A translation unit to parse.
+   Parsing only uses Clang and can run in any thread, while the
+   translation of the result into OCaml values must run in the thread
+   owning the OCaml runtime. The job keeps the CompilerInstance, and thus
+   the AST, alive between the two steps.
+ */
+/* Timing of a phase of the parsing of a translation unit */
+struct MLPhase {
+  const char* name;
+  int thread;               // 0 for the OCaml thread, k for the k-th parsing thread
+  llvm::TimeRecord start;
+  llvm::TimeRecord time;    // elapsed time and memory
+};
 
-public:
-  explicit MLTreeBuilderConsumer(MLLocationTranslator& loc, value* ret, SourceManager& src, MLCommentTranslator& com)
-    : ret(ret), loc(loc), com(com), src(src)
-  {}
+struct MLParseJob {
+  std::vector<std::string> args;  // command line, including the file name
+  std::string name;               // file name
+  CompilerInstance ci;
+  MLDiagnostics* diag = nullptr;  // owned by ci
+  std::string error;              // non-empty if parsing failed
+  int thread = 0;                 // thread parsing the job
+  std::vector<MLPhase> phases;
+
+  // ends a phase started at start
+  void phase(const char* name, const llvm::TimeRecord& start) {
+    llvm::TimeRecord t = llvm::TimeRecord::getCurrentTime(false);
+    t -= start;
+    phases.push_back({ name, thread, start, t });
+  }
 
-  virtual void HandleTranslationUnit(ASTContext &Context) {
-    Decl* decl = Context.getTranslationUnitDecl();
-    MLTreeBuilderVisitor Visitor(loc, &Context, src, com);
-    *ret = Visitor.TranslateDecl(decl);
+  MLParseJob(const char* command, const char* name, value args)
+    : name(name)
+  {
+    this->args.push_back(command);
+    this->args.push_back("-c");
+    this->args.push_back(name);
+    for (size_t i = 0; i < Wosize_val(args); i++) {
+      this->args.push_back(String_val(Field(args, i)));
+    }
   }
 };
 
+/* Caches shared by the translation units parsed in the same thread.
+   They are not synchronized by Clang, so they must not be shared between
+   threads. The lock is held while a translation unit using the caches is
+   parsed or translated.
+ */
+struct MLParseCache {
+  IntrusiveRefCntPtr<TargetInfo> target;
+  IntrusiveRefCntPtr<FileManager> files;
+  std::mutex lock;
+};
 
-CAML_EXPORT value mlclang_parse(value command, value target, value name, value args) {
-  CAMLparam3(target,name,args);
-  CAMLlocal2(ret,tmp);
 
-  CompilerInstance ci;
+/* Parses a translation unit, without touching the OCaml runtime */
+static void ParseTU(MLParseJob& job, MLParseCache& cache, const TargetOptions& to) {
+  llvm::TimeRecord start = llvm::TimeRecord::getCurrentTime(true);
+  CompilerInstance& ci = job.ci;
   ci.createDiagnostics();
 
   // compiler command-line arguments
   std::vector<const char*> a;
-  a.push_back(String_val(command));
-  a.push_back("-c");
-  a.push_back(String_val(name));
-  for (size_t i = 0; i < Wosize_val(args); i++) {
-    a.push_back(String_val(Field(args, i)));
-  }
+  for (auto& arg : job.args) a.push_back(arg.c_str());
   std::shared_ptr<CompilerInvocation> invoke =
 #if CLANG_VERSION_MAJOR >= 15
     std::move(createInvocation(a));
 #else
     std::move(createInvocationFromCommandLine(a));
 #endif
-  if (!invoke) caml_failwith("mlClangAST: failed to create clang::CompilerInvocation");
+  if (!invoke) { job.error = "mlClangAST: failed to create clang::CompilerInvocation"; return; }
   ci.setInvocation(invoke);
 
   // target
-  std::shared_ptr<TargetOptions> pto = std::make_shared<clang::TargetOptions>();
-  TargetOptionsFromML(target, *pto);
-  TargetInfo *pti = TargetInfo::CreateTargetInfo(ci.getDiagnostics(), pto);
-  ci.setTarget(pti);
+  if (!cache.target) {
+    std::shared_ptr<TargetOptions> pto = std::make_shared<clang::TargetOptions>(to);
+    cache.target = TargetInfo::CreateTargetInfo(ci.getDiagnostics(), pto);
+  }
+  ci.setTarget(cache.target.get());
 
   // source file
-  ci.createFileManager();
+  // the file manager caches the lookups of include directories and files
+  if (!cache.files) cache.files = new FileManager(ci.getFileSystemOpts());
+  ci.setFileManager(cache.files.get());
   ci.createSourceManager(ci.getFileManager());
 #if CLANG_VERSION_MAJOR < 10
-  const FileEntry *pFile = ci.getFileManager().getFile(String_val(name));
+  const FileEntry *pFile = ci.getFileManager().getFile(job.name);
 #else
-  auto x = ci.getFileManager().getFile(String_val(name));
-  if (!x) caml_failwith("mlClangAST: cannot get FileEntry");
+  auto x = ci.getFileManager().getFile(job.name);
+  if (!x) { job.error = "mlClangAST: cannot get FileEntry"; return; }
   const FileEntry *pFile = x.get();
 #endif
-  if (!pFile) caml_failwith("mlClangAST: cannot get FileEntry");
+  if (!pFile) { job.error = "mlClangAST: cannot get FileEntry"; return; }
   SourceManager& src = ci.getSourceManager();
   src.setMainFileID(src.createFileID(pFile,SourceLocation(),SrcMgr::C_User));
 
@@ -4925,35 +5277,303 @@ CAML_EXPORT value mlclang_parse(value command, value target, value name, value a
   pp.getBuiltinInfo().initializeBuiltins(pp.getIdentifierTable(),
                                          pp.getLangOpts());
 
-  // locations
-  MLLocationTranslator loc(src, pp.getLangOpts());
-
   // custom diagnostics
-  MLDiagnostics* diag = new MLDiagnostics(loc);
-  MLCommentTranslator com(src, loc);
-  ci.getDiagnostics().setClient(diag);
+  job.diag = new MLDiagnostics();
+  ci.getDiagnostics().setClient(job.diag);
 
   // parsing
+  // the AST is translated after parsing, so the consumer does nothing
 #if CLANG_VERSION_MAJOR < 10
-  ci.setASTConsumer(llvm::make_unique<MLTreeBuilderConsumer>(loc, &tmp, src, com));
+  ci.setASTConsumer(llvm::make_unique<ASTConsumer>());
 #else
-  ci.setASTConsumer(std::make_unique<MLTreeBuilderConsumer>(loc, &tmp, src, com));
+  ci.setASTConsumer(std::make_unique<ASTConsumer>());
 #endif
   ci.createASTContext();
+
+  // precompiled header, given by -include-pch
+  // the header is validated against the current files and options, and
+  // loading fails if it is out of date, so that the caller can fall back
+  // to a regular parsing
+  PreprocessorOptions& ppo = ci.getPreprocessorOpts();
+  if (!ppo.ImplicitPCHInclude.empty()) {
+    ci.createPCHExternalASTSource(ppo.ImplicitPCHInclude,
+#if CLANG_VERSION_MAJOR >= 12
+                                  ppo.DisablePCHOrModuleValidation,
+#else
+                                  ppo.DisablePCHValidation,
+#endif
+                                  ppo.AllowPCHWithCompilerErrors,
+                                  nullptr, false);
+    if (!ci.getASTContext().getExternalSource()) {
+      job.error = "mlClangAST: cannot load precompiled header";
+      return;
+    }
+  }
+
+  job.phase("clang-setup", start);
+
+  // preprocessing and semantic analysis are interleaved in ParseAST
+  start = llvm::TimeRecord::getCurrentTime(true);
   ci.getDiagnosticClient().BeginSourceFile(ci.getLangOpts(), &pp);
-  ASTContext& Context = ci.getASTContext();
-  ParseAST(pp, &ci.getASTConsumer(), Context);
+  ParseAST(pp, &ci.getASTConsumer(), ci.getASTContext());
 
   // get disgnostics
   ci.getDiagnosticClient().EndSourceFile();
-    
+  job.phase("clang-parse", start);
+}
+
+
+/* MLPhase -> parse_phase */
+CAMLprim value TranslatePhase(const MLPhase& p) {
+  CAMLparam0();
+  CAMLlocal1(ret);
+
+  ret = caml_alloc_tuple(6);
+  Store_field(ret, 0, caml_copy_string(p.name));
+  Store_field(ret, 1, Val_int(p.thread));
+  Store_field(ret, 2, caml_copy_double(p.start.getWallTime()));
+  Store_field(ret, 3, caml_copy_double(p.time.getWallTime()));
+  Store_field(ret, 4, caml_copy_double(p.time.getUserTime()));
+  Store_field(ret, 5, caml_copy_double(p.time.getMemUsed()));
+
+  CAMLreturn(ret);
+}
+
+
+/* Translates a parsed translation unit into a parse_result */
+CAMLprim value TranslateTU(MLParseJob& job) {
+  CAMLparam0();
+  CAMLlocal2(ret,tmp);
+
+  CompilerInstance& ci = job.ci;
+  SourceManager& src = ci.getSourceManager();
+  Preprocessor &pp = ci.getPreprocessor();
+  ASTContext& Context = ci.getASTContext();
+
+  // locations
+  MLLocationTranslator loc(src, pp.getLangOpts());
+  MLCommentTranslator com(src, loc);
+
+  // AST
+  // the translation runs in the OCaml thread, and its time includes the
+  // OCaml GC triggered by the allocation of the AST
+  job.thread = 0;
+  llvm::TimeRecord start = llvm::TimeRecord::getCurrentTime(true);
+  {
+    MLTreeBuilderVisitor Visitor(loc, &Context, src, com);
+    tmp = Visitor.TranslateDecl(Context.getTranslationUnitDecl());
+  }
+  job.phase("translate-ast", start);
+
   // return all info
-  ret = caml_alloc_tuple(5);
+  ret = caml_alloc_tuple(7);
   Store_field(ret, 0, tmp);
-  Store_field(ret, 1, diag->getDiagnostics());
+  Store_field(ret, 1, job.diag->getDiagnostics(loc));
+  start = llvm::TimeRecord::getCurrentTime(true);
   Store_field(ret, 2, com.getRawCommentList(Context));
-  Store_field(ret, 3, getMacroTable(src, pp, loc));
+  job.phase("translate-comments", start);
+  start = llvm::TimeRecord::getCurrentTime(true);
+  Store_field(ret, 3, getMacroTable(src, pp, loc, com));
+  job.phase("translate-macros", start);
   Store_field(ret, 4, getSources(src));
-    
+  Store_field_list(ret, 5, job.phases, TranslatePhase(child));
+  Store_field(ret, 6, loc.getLocFiles());
+
   CAMLreturn(ret);
 }
+
+
+/* bool -> unit */
+CAML_EXPORT value mlclang_set_stub_comments_only(value b) {
+  CAMLparam1(b);
+  stub_comments_only = Bool_val(b);
+  CAMLreturn(Val_unit);
+}
+
+/* unit -> bool */
+CAML_EXPORT value mlclang_get_stub_comments_only(value unit) {
+  CAMLparam1(unit);
+  CAMLreturn(Val_bool(stub_comments_only));
+}
+
+
+CAML_EXPORT value mlclang_parse(value command, value target, value name, value args) {
+  CAMLparam3(target,name,args);
+  CAMLlocal1(ret);
+
+  TargetOptions to;
+  TargetOptionsFromML(target, to);
+  MLParseCache cache;
+  MLParseJob* job = new MLParseJob(String_val(command), String_val(name), args);
+  ParseTU(*job, cache, to);
+  if (!job->error.empty()) caml_failwith(job->error.c_str());
+  ret = TranslateTU(*job);
+  delete job;
+
+  CAMLreturn(ret);
+}
+
+
+/* State of a batch shared with the parsing threads.
+   It is allocated on the heap so that it stays valid if the translation
+   raises an OCaml exception; in that case, the threads and the state are
+   leaked.
+ */
+struct MLParseBatch {
+  std::vector<std::unique_ptr<MLParseJob>> jobs;
+  std::vector<MLParseCache*> owner;  // caches used to parse each job
+  std::vector<std::unique_ptr<MLParseCache>> caches;  // one per thread
+  TargetOptions to;
+
+  // protected by m
+  std::mutex m;
+  std::condition_variable cv;
+  std::vector<bool> done;
+  size_t next = 0;        // next job to parse
+  size_t translated = 0;  // number of jobs translated
+  bool stop = false;      // set when the OCaml thread does not need more jobs
+
+  // parsing thread number k
+  void worker(size_t k, size_t window) {
+    size_t n = jobs.size();
+    MLParseCache& cache = *caches[k];
+    for (;;) {
+      size_t i;
+      {
+        std::unique_lock<std::mutex> l(m);
+        cv.wait(l, [&] { return stop || next >= n || next < translated + window; });
+        if (stop || next >= n) return;
+        i = next++;
+        owner[i] = &cache;
+        jobs[i]->thread = k + 1;
+      }
+      {
+        std::lock_guard<std::mutex> g(cache.lock);
+        ParseTU(*jobs[i], cache, to);
+      }
+      { std::lock_guard<std::mutex> l(m); done[i] = true; }
+      cv.notify_all();
+    }
+  }
+};
+
+
+/* string -> target_options -> (string * string array) array -> int -> parse_result array
+   Parses a list of translation units, given with their arguments, with
+   the given command and target. Translation units parsed in the same
+   thread share their file manager and target information.
+   With several threads, each thread has its own CompilerInstance and
+   caches, and parses the next translation units while the OCaml thread
+   translates the finished ones, in order. At most 2*threads translation
+   units are kept in memory at the same time.
+ */
+CAML_EXPORT value mlclang_parse_batch(value command, value target, value files, value threads) {
+  CAMLparam4(command,target,files,threads);
+  CAMLlocal2(ret,tmp);
+
+  size_t n = Wosize_val(files);
+  MLParseBatch* b = new MLParseBatch();
+  TargetOptionsFromML(target, b->to);
+
+  // command lines are copied before starting the threads, which must not
+  // access the OCaml heap
+  for (size_t i = 0; i < n; i++) {
+    value f = Field(files, i);
+    b->jobs.emplace_back(new MLParseJob(String_val(command), String_val(Field(f, 0)), Field(f, 1)));
+  }
+  b->owner.resize(n, nullptr);
+  b->done.resize(n, false);
+
+  size_t nthreads = Long_val(threads) < 1 ? 1 : Long_val(threads);
+  if (nthreads > n) nthreads = n;
+  for (size_t k = 0; k < nthreads || k == 0; k++) b->caches.emplace_back(new MLParseCache());
+
+  std::vector<std::thread> pool;
+  if (nthreads > 1) {
+    for (size_t k = 0; k < nthreads; k++) pool.emplace_back(&MLParseBatch::worker, b, k, 2 * nthreads);
+  }
+
+  ret = caml_alloc(n, 0);
+  std::string error;
+  for (size_t i = 0; i < n; i++) {
+    if (nthreads > 1) {
+      std::unique_lock<std::mutex> l(b->m);
+      b->cv.wait(l, [&] { return (bool)b->done[i]; });
+    }
+    else {
+      b->owner[i] = b->caches[0].get();
+      ParseTU(*b->jobs[i], *b->caches[0], b->to);
+    }
+    if (!b->jobs[i]->error.empty()) { error = b->jobs[i]->error; break; }
+    // the caches of the job may be in use by its thread
+    {
+      std::lock_guard<std::mutex> g(b->owner[i]->lock);
+      tmp = TranslateTU(*b->jobs[i]);
+      b->jobs[i].reset();
+    }
+    Store_field(ret, i, tmp);
+    { std::lock_guard<std::mutex> l(b->m); b->translated = i + 1; }
+    b->cv.notify_all();
+  }
+
+  { std::lock_guard<std::mutex> l(b->m); b->stop = true; }
+  b->cv.notify_all();
+  for (auto& t : pool) t.join();
+  delete b;
+  if (!error.empty()) caml_failwith(error.c_str());
+
+  CAMLreturn(ret);
+}
+
+
+
+/* Precompiled headers */
+/* ******************* */
+
+
+/* string -> target_options -> string -> string -> string array -> bool
+   Builds a precompiled header for the given header file into output.
+   Returns false if the header could not be compiled.
+ */
+CAML_EXPORT value mlclang_build_pch(value command, value target, value header, value output, value args) {
+  CAMLparam5(command,target,header,output,args);
+
+  CompilerInstance ci;
+  ci.createDiagnostics();
+  ci.getDiagnostics().setClient(new IgnoringDiagConsumer());
+
+  // compiler command-line arguments
+  // -x c-header makes the driver emit a precompiled header
+  std::vector<const char*> a;
+  a.push_back(String_val(command));
+  a.push_back("-x");
+  a.push_back(std::string(String_val(command)) == "clang++" ? "c++-header" : "c-header");
+  a.push_back(String_val(header));
+  a.push_back("-o");
+  a.push_back(String_val(output));
+  for (size_t i = 0; i < Wosize_val(args); i++) {
+    a.push_back(String_val(Field(args, i)));
+  }
+  std::shared_ptr<CompilerInvocation> invoke =
+#if CLANG_VERSION_MAJOR >= 15
+    std::move(createInvocation(a));
+#else
+    std::move(createInvocationFromCommandLine(a));
+#endif
+  if (!invoke) CAMLreturn(Val_false);
+  ci.setInvocation(invoke);
+  ci.getFrontendOpts().ProgramAction = frontend::GeneratePCH;
+  ci.getFrontendOpts().OutputFile = String_val(output);
+
+  // same target and headers as mlclang_parse, otherwise the precompiled
+  // header is rejected when loaded
+  TargetOptionsFromML(target, ci.getTargetOpts());
+  ci.getHeaderSearchOpts().AddPath(CLANGRESOURCE "/include",frontend::IncludeDirGroup::System, false, false);
+  ci.getHeaderSearchOpts().UseBuiltinIncludes = false;
+  ci.getHeaderSearchOpts().UseStandardSystemIncludes = true;
+
+  GeneratePCHAction action;
+  bool ok = ci.ExecuteAction(action) && !ci.getDiagnostics().hasErrorOccurred();
+
+  CAMLreturn(Val_bool(ok));
+}
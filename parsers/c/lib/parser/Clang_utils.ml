@@ -28,11 +28,48 @@ open Clang_AST
 
 (** {1 Locations} *)
 
-let empty_loc = { loc_line = -1; loc_column = -1; loc_file = "<invalid>"; }
+external loc_file_name: int -> string = "mlclang_loc_file_name"
+external loc_file_id: string -> int = "mlclang_loc_file_id"
+external register_loc_file: int -> string -> bool = "mlclang_register_loc_file"
+
+(* Layout of packed locations, as in Clang_to_ml.cc *)
+let loc_line_bits = 24
+let loc_column_bits = 16
+
+let empty_loc = -1
 let empty_range = { range_begin = empty_loc; range_end = empty_loc; }
 
-let loc_is_empty l =
-  l.loc_line < 0 || l.loc_column < 0 || l.loc_file = "<invalid>"
+let loc_is_empty l = l < 0
+
+(* File identifiers never change once allocated, so their names are
+   memoized to avoid copying them from the C++ table at each lookup *)
+let loc_files : (int, string) Hashtbl.t = Hashtbl.create 16
+
+let loc_file l =
+  if l < 0 then "<invalid>"
+  else
+    let id = l lsr (loc_line_bits + loc_column_bits) in
+    match Hashtbl.find_opt loc_files id with
+    | Some f -> f
+    | None ->
+      let f = loc_file_name id in
+      if f <> "<invalid>" then Hashtbl.add loc_files id f;
+      f
+
+let loc_line l =
+  if l < 0 then -1
+  else (l lsr loc_column_bits) land (1 lsl loc_line_bits - 1)
+
+let loc_column l =
+  if l < 0 then -1
+  else l land (1 lsl loc_column_bits - 1)
+
+let mk_loc file line column =
+  if line < 0 || column < 0 || file = "<invalid>" then empty_loc
+  else
+    (loc_file_id file lsl (loc_line_bits + loc_column_bits))
+    lor (min line (1 lsl loc_line_bits - 1) lsl loc_column_bits)
+    lor (min column (1 lsl loc_column_bits - 1))
 
 let range_is_empty r =
   loc_is_empty r.range_begin && loc_is_empty r.range_end
@@ -28,9 +28,31 @@ open Clang_AST
 
 (** {1 Locations} *)
 
+external loc_file_name: int -> string = "mlclang_loc_file_name"
+(** Name of a file identifier, or ["<invalid>"] if it is not allocated. *)
+
+external loc_file_id: string -> int = "mlclang_loc_file_id"
+(** Identifier of a file name, allocated if needed. *)
+
+external register_loc_file: int -> string -> bool = "mlclang_register_loc_file"
+(** Registers the file identifier of a cached parse result. Returns false
+    if the identifier or the file is already registered differently. *)
+
 val empty_loc : loc
 val empty_range : range
 val loc_is_empty : loc -> bool
+
+val loc_file : loc -> string
+(** File of a location, ["<invalid>"] for invalid locations. *)
+
+val loc_line : loc -> int
+(** Line of a location, -1 for invalid locations. *)
+
+val loc_column : loc -> int
+(** Column of a location, -1 for invalid locations. *)
+
+val mk_loc : string -> int -> int -> loc
+(** [mk_loc file line column] packs a location. *)
 val range_is_empty : range -> bool
 
 
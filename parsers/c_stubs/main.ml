@@ -56,6 +56,182 @@ let is_directive_comment (com,_) =
 exception StubNotFound
 
 
+(** {2 Parsed comments} *)
+(** ******************* *)
+
+(* Stub comments are lexed, preprocessed and parsed independently of each
+   other, and independently of the function they annotate. The resulting
+   CST, before scoping, only depends on the text and position of the
+   comment, and on the macros, predicates and enums it uses. *)
+
+(** Result of the parsing of a stub comment *)
+type parsed =
+  | Parsed of Cst.stub
+  | Alias of string
+  | Syntax_error of Location.range * string option
+
+
+(* Identifiers occurring in a string *)
+let identifiers (s:string) : string list =
+  let n = String.length s in
+  let is_start c = c = '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') in
+  let is_char c = is_start c || (c >= '0' && c <= '9') in
+  let rec skip i = if i < n && is_char s.[i] then skip (i + 1) else i in
+  let rec iter i acc =
+    if i >= n then List.rev acc
+    else if is_start s.[i] then
+      let j = skip i in
+      iter j (String.sub s i (j - i) :: acc)
+    else if is_char s.[i] then iter (skip i) acc
+    else iter (i + 1) acc
+  in
+  iter 0 []
+
+
+(** Identifiers of a comment, and of the macros it uses transitively *)
+let comment_identifiers (com:Clang_AST.comment) (macros:C_AST.macro StringMap.t) : string list =
+  let seen = Hashtbl.create 16 in
+  let rec visit acc id =
+    if Hashtbl.mem seen id then acc
+    else (
+      Hashtbl.add seen id ();
+      match StringMap.find_opt id macros with
+      | Some m -> List.fold_left (fun acc s -> List.fold_left visit acc (identifiers s)) (id :: acc) m.macro_contents
+      | None -> id :: acc
+    )
+  in
+  List.fold_left visit [] (identifiers com.com_text)
+
+
+(** Key of a comment in the cache of parsed comments: a digest of its
+    text, its position, and the definitions of the macros, predicates and
+    enums reachable from its identifiers. *)
+let comment_key
+    (com:Clang_AST.comment)
+    (macros:C_AST.macro StringMap.t)
+    (predicates:Passes.Preprocessor.predicate StringMap.t)
+    (enums:Z.t StringMap.t)
+  : Digest.t
+  =
+  let b = Buffer.create 256 in
+  let add s = Buffer.add_string b s; Buffer.add_char b '\000' in
+  add com.com_text;
+  add (Clang_dump.string_of_loc com.com_range.range_begin);
+  let seen = Hashtbl.create 16 in
+  let rec visit id =
+    if not (Hashtbl.mem seen id) then (
+      Hashtbl.add seen id ();
+      (match StringMap.find_opt id enums with
+       | Some n -> add id; add (Z.to_string n)
+       | None -> ());
+      (match StringMap.find_opt id predicates with
+       | Some pred ->
+         let open Passes.Preprocessor in
+         let body = List.map Lexer.token_to_string pred.pred_body in
+         add id; List.iter add pred.pred_params; List.iter add body;
+         List.iter (fun s -> List.iter visit (identifiers s)) body
+       | None -> ());
+      (match StringMap.find_opt id macros with
+       | Some m ->
+         add id; List.iter add m.macro_params; List.iter add m.macro_contents;
+         List.iter (fun s -> List.iter visit (identifiers s)) m.macro_contents
+       | None -> ())
+    )
+  in
+  List.iter visit (identifiers com.com_text);
+  Digest.string (Buffer.contents b)
+
+
+(** Parsed comments of the analysis, by key *)
+let parsed_cache : (Digest.t, parsed) Hashtbl.t = Hashtbl.create 16
+
+
+(* Lex, preprocess and parse a comment into a CST *)
+let parse_comment predicates macros enums (com:Clang_AST.comment) : parsed =
+  (* Create the lexing buffer *)
+  let comment = com.com_text in
+  let file = Clang_utils.loc_file com.com_range.range_begin in
+  let line = Clang_utils.loc_line com.com_range.range_begin in
+  let col = Clang_utils.loc_column com.com_range.range_begin in
+  let buf = Lexing.from_string comment in
+  buf.lex_curr_p <- {
+    pos_fname = file;
+    pos_lnum = line;
+    pos_bol = 0;
+    pos_cnum = col;
+  };
+  let stack = Passes.Preprocessor.create_stack () in
+  (* Parse the comment *)
+  try Parsed (Parser.parse_stub (Passes.Preprocessor.read stack predicates macros enums Lexer.read) buf)
+  with
+  | Passes.Preprocessor.AliasFound alias -> Alias alias
+
+  | Lexer.SyntaxError s ->
+    let range = Location.from_lexing_range (Lexing.lexeme_start_p buf) (Lexing.lexeme_end_p buf) in
+    Syntax_error (range, Some s)
+
+  | Parser.Error ->
+    let range = Location.from_lexing_range (Lexing.lexeme_start_p buf) (Lexing.lexeme_end_p buf) in
+    Syntax_error (range, None)
+
+
+(* Parse a comment, or find it in the cache *)
+let find_parsed_comment predicates macros enums com : parsed =
+  let key = comment_key com macros predicates enums in
+  match Hashtbl.find_opt parsed_cache key with
+  | Some p -> p
+  | None ->
+    let p = parse_comment predicates macros enums com in
+    Hashtbl.add parsed_cache key p;
+    p
+
+
+(** Parse a list of comments in [jobs] worker processes, and store the
+    results in the cache of parsed comments. Comments already in the
+    cache are not parsed again. Comments that a worker fails to parse are
+    left out of the cache, and are parsed again when needed. *)
+let prefetch_comments
+    ~(jobs:int)
+    (coms:(Clang_AST.comment * C_AST.macro StringMap.t) list)
+    (predicates:Passes.Preprocessor.predicate StringMap.t)
+    (enums:Z.t StringMap.t)
+  : unit
+  =
+  let todo = Hashtbl.create 16 in
+  List.iter (fun (com,macros) ->
+      let key = comment_key com macros predicates enums in
+      if not (Hashtbl.mem parsed_cache key) && not (Hashtbl.mem todo key) then
+        Hashtbl.add todo key (com,macros)
+    ) coms;
+  let todo = Hashtbl.fold (fun key c acc -> (key,c) :: acc) todo [] in
+  let n = List.length todo in
+  if jobs <= 1 || n <= 1 then
+    List.iter (fun (key,(com,macros)) ->
+        Hashtbl.add parsed_cache key (parse_comment predicates macros enums com)
+      ) todo
+  else
+    (* One task per worker, to fork only [jobs] times *)
+    let chunks = Array.make (min jobs n) [] in
+    List.iteri (fun i c ->
+        let k = i mod Array.length chunks in
+        chunks.(k) <- c :: chunks.(k)
+      ) todo;
+    let outcomes =
+      WorkerPool.run ~jobs
+        (List.map (fun (key,(com,macros)) -> key, parse_comment predicates macros enums com))
+        (Array.to_list chunks)
+    in
+    List.iter (function
+        | WorkerPool.Done l -> List.iter (fun (key,p) -> Hashtbl.replace parsed_cache key p) l
+        | WorkerPool.Failed msg -> debug "stub worker failed: %s" msg
+        | WorkerPool.Timeout | WorkerPool.Memory_exceeded -> ()
+      ) outcomes
+
+
+
+(** {2 Stubs} *)
+(** ********* *)
+
 (* Parse function's comment into a stub CST *)
 let rec parse_cst func ?(selector=is_stub_comment) prj enums predicates cache =
   match Hashtbl.find_opt cache func.func_org_name with
@@ -65,29 +241,17 @@ let rec parse_cst func ?(selector=is_stub_comment) prj enums predicates cache =
     match List.find_opt selector func.func_com with
     | None -> raise StubNotFound
     | Some (com,macros) ->
-      (* Create the lexing buffer *)
-      let comment = com.com_text in
-      let file = com.com_range.range_begin.loc_file in
-      let line = com.com_range.range_begin.loc_line in
-      let col = com.com_range.range_begin.loc_column in
-      let buf = Lexing.from_string comment in
-      buf.lex_curr_p <- {
-        pos_fname = file;
-        pos_lnum = line;
-        pos_bol = 0;
-        pos_cnum = col;
-      };
-      (* Parse the comment *)
-      try
-        let cst = Parser.parse_stub (Passes.Preprocessor.read predicates macros enums Lexer.read) buf in
-        (* Resolve scoping of variables *)
+      match find_parsed_comment predicates macros enums com with
+      | Parsed cst ->
+        (* Resolve scoping of variables. Scoping allocates fresh
+           variable uids, so it is done for each function. *)
         let cst' = Passes.Scoping.doit cst in
         (* Save the stub in the cache, so it can be used later when resolving
            aliases *)
         Hashtbl.add cache func.func_org_name cst';
         cst'
-      with
-      | Passes.Preprocessor.AliasFound alias ->
+
+      | Alias alias ->
         (* Find the alias function *)
         begin match StringMap.find_opt alias prj.proj_funcs with
           | None -> raise StubNotFound
@@ -95,13 +259,11 @@ let rec parse_cst func ?(selector=is_stub_comment) prj enums predicates cache =
             parse_cst f prj enums predicates cache
         end
 
-    | Lexer.SyntaxError s ->
-      let range = Location.from_lexing_range (Lexing.lexeme_start_p buf) (Lexing.lexeme_end_p buf) in
-      Exceptions.syntax_error range "%s" s
+      | Syntax_error (range, Some s) ->
+        Exceptions.syntax_error range "%s" s
 
-    | Parser.Error ->
-      let range = Location.from_lexing_range (Lexing.lexeme_start_p buf) (Lexing.lexeme_end_p buf) in
-      Exceptions.unnamed_syntax_error range
+      | Syntax_error (range, None) ->
+        Exceptions.unnamed_syntax_error range
 
 
 
@@ -156,9 +318,9 @@ let parse_predicates_comment (coms:(Clang_AST.comment * Clang_AST.macro StringMa
       if is_predicates_comment (com,macros) then
         (* Create the lexing buffer *)
         let comment = com.com_text in
-        let file = com.com_range.range_begin.loc_file in
-        let line = com.com_range.range_begin.loc_line in
-        let col = com.com_range.range_begin.loc_column in
+        let file = Clang_utils.loc_file com.com_range.range_begin in
+        let line = Clang_utils.loc_line com.com_range.range_begin in
+        let col = Clang_utils.loc_column com.com_range.range_begin in
         let buf = Lexing.from_string comment in
         buf.lex_curr_p <- {
           pos_fname = file;
@@ -256,16 +256,16 @@ let visit_var v range prj func =
       var_type = visit_qual_typ v.vtyp prj func;
       var_init = None;
       var_range = Clang_AST.{
-          range_begin = {
-            loc_file = get_range_start v.vrange |> get_pos_file;
-            loc_line = get_range_start v.vrange |> get_pos_line;
-            loc_column = get_range_start v.vrange |> get_pos_column;
-          };
-          range_end = {
-            loc_file = get_range_end v.vrange |> get_pos_file;
-            loc_line = get_range_end v.vrange |> get_pos_line;
-            loc_column = get_range_end v.vrange |> get_pos_column;
-          }
+          range_begin =
+            Clang_utils.mk_loc
+              (get_range_start v.vrange |> get_pos_file)
+              (get_range_start v.vrange |> get_pos_line)
+              (get_range_start v.vrange |> get_pos_column);
+          range_end =
+            Clang_utils.mk_loc
+              (get_range_end v.vrange |> get_pos_file)
+              (get_range_end v.vrange |> get_pos_line)
+              (get_range_end v.vrange |> get_pos_column);
         };
       var_com = [];
     }
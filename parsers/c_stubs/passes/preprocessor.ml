@@ -39,8 +39,12 @@ let pp_token_list fmt tokens =
     pp_token
     fmt tokens
 
-(* Stack containing called macros with their tokenized content *)
-let stack : (macro * token list) Stack.t = Stack.create ()
+(* Stack containing called macros with their tokenized content. A stack
+   is created for each comment, so that comments can be preprocessed
+   independently. *)
+type stack = (macro * token list) Stack.t
+
+let create_stack () : stack = Stack.create ()
 
 let pp_stack fmt stack =
   let elements = Stack.fold (fun acc e -> acc@[e]) [] stack in
@@ -60,7 +64,7 @@ let inside_macro macro stack =
   with Found -> true
 
 (* Get the next token *)
-let rec next_token ?(ret2caller=true) lexer lexbuf =
+let rec next_token ?(ret2caller=true) stack lexer lexbuf =
   if Stack.is_empty stack then
     lexer lexbuf
   else
@@ -68,7 +72,7 @@ let rec next_token ?(ret2caller=true) lexer lexbuf =
     match tokens with
     | []        ->
       assert ret2caller;
-      next_token lexer lexbuf
+      next_token stack lexer lexbuf
     | [token]   ->
       if not ret2caller then Stack.push (macro,[]) stack;
       token
@@ -86,19 +90,19 @@ let tokenize_string lexer (s:string) : token list =
   iter (Lexing.from_string s)
 
 (* Parse the arguments of a macro into a map of tokens *)
-let tokenize_arguments macro lexer lexbuf : token list StringMap.t =
+let tokenize_arguments stack macro lexer lexbuf : token list StringMap.t =
   match macro.macro_params with
   | [] -> StringMap.empty
   | hd::tl  ->
     (* Read '(' *)
-    if next_token ~ret2caller:false lexer lexbuf <> LPAR then
+    if next_token ~ret2caller:false stack lexer lexbuf <> LPAR then
       raise (Lexer.SyntaxError (Format.asprintf "macro %s is missing '('" macro.macro_name));
     (* Read arguments separated by ',' until reaching ')' *)
     let rec iter param params openpar past_tokens token =
       match token with
       | EOF -> raise (Lexer.SyntaxError (Format.asprintf "macro %s is missing ')'" macro.macro_name));
       | LPAR ->
-        iter param params (openpar + 1) (token::past_tokens) (next_token ~ret2caller:false lexer lexbuf)
+        iter param params (openpar + 1) (token::past_tokens) (next_token ~ret2caller:false stack lexer lexbuf)
       | RPAR ->
         if openpar = 0 then
           begin
@@ -110,19 +114,19 @@ let tokenize_arguments macro lexer lexbuf : token list StringMap.t =
             StringMap.singleton param (List.rev past_tokens)
           end
         else
-          iter param params (openpar - 1) (token::past_tokens) (next_token ~ret2caller:false lexer lexbuf)
+          iter param params (openpar - 1) (token::past_tokens) (next_token ~ret2caller:false stack lexer lexbuf)
       | COMMA when openpar = 0 ->
         begin match params with
           | [] ->
             raise (Lexer.SyntaxError "macro %s is given too many arguments");
           | hd::tl ->
-            iter hd tl 0 [] (next_token ~ret2caller:false lexer lexbuf) |>
+            iter hd tl 0 [] (next_token ~ret2caller:false stack lexer lexbuf) |>
             StringMap.add param (List.rev past_tokens)
         end
       | _ ->
-        iter param params openpar (token::past_tokens) (next_token ~ret2caller:false lexer lexbuf)
+        iter param params openpar (token::past_tokens) (next_token ~ret2caller:false stack lexer lexbuf)
     in
-    iter hd tl 0 [] (next_token ~ret2caller:false lexer lexbuf)
+    iter hd tl 0 [] (next_token ~ret2caller:false stack lexer lexbuf)
 
 (* Add parenthesis around a list of tokens *)
 let add_parenthesis tokens =
@@ -152,10 +156,10 @@ let tokeninze_macro macro args lexer : token list =
 exception AliasFound of string
 
 (* Parse a preprocessor directive *)
-let parse_directive lexer lexbuf =
-  match next_token lexer lexbuf with
+let parse_directive stack lexer lexbuf =
+  match next_token stack lexer lexbuf with
   | ALIAS ->
-    begin match next_token lexer lexbuf with
+    begin match next_token stack lexer lexbuf with
       | IDENT alias -> raise (AliasFound alias)
       | token ->
         raise (Lexer.SyntaxError
@@ -252,16 +256,12 @@ let predicate_to_macro pred =
   { macro_name = pred.pred_name;
     macro_params = pred.pred_params;
     macro_contents = List.map Lexer.token_to_string pred.pred_body;
-    macro_loc = {
-      loc_line = -1;
-      loc_column = -1;
-      loc_file = "";
-    } }
+    macro_loc = Mopsa_c_parser.Clang_utils.empty_loc }
 
 (* Entry point of the preprocessor *)
-let rec read predicates macros enums lexer lexbuf =
+let rec read stack predicates macros enums lexer lexbuf =
   let stack0 = Stack.copy stack in
-  let token = next_token lexer lexbuf in
+  let token = next_token stack lexer lexbuf in
   (* Identifiers *may be* enums or macros, so check that *)
   match token with
   | IDENT id ->
@@ -279,14 +279,14 @@ let rec read predicates macros enums lexer lexbuf =
           (* Since predicates are similar to macros, we use the same processing *)
           let macro = predicate_to_macro pred in
           (* Parse the arguments *)
-          let args = tokenize_arguments macro lexer lexbuf in
+          let args = tokenize_arguments stack macro lexer lexbuf in
           (* Parse the body of the predicate *)
           let tokens = tokeninze_macro macro args lexer in
           (* Update the tokens stack and repeat the same process *)
           Stack.push (macro,tokens) stack;
           (* Restore the start position of the macro *)
           lexbuf.lex_start_p <- predicate_start_pos;
-          read predicates macros enums lexer lexbuf
+          read stack predicates macros enums lexer lexbuf
 
         | None ->
           match StringMap.find_opt id macros with
@@ -300,14 +300,14 @@ let rec read predicates macros enums lexer lexbuf =
             (* Save the lexer location *)
             let macro_start_pos = lexbuf.lex_start_p in
             (* Parse the arguments *)
-            let args = tokenize_arguments macro lexer lexbuf in
+            let args = tokenize_arguments stack macro lexer lexbuf in
             (* Parse the body of the macro *)
             let tokens = tokeninze_macro macro args lexer in
             (* Update the tokens stack and repeat the same process *)
             Stack.push (macro,tokens) stack;
             (* Restore the start position of the macro *)
             lexbuf.lex_start_p <- macro_start_pos;
-            read predicates macros enums lexer lexbuf
+            read stack predicates macros enums lexer lexbuf
     end
-  | SHARP -> parse_directive lexer lexbuf
+  | SHARP -> parse_directive stack lexer lexbuf
   | _ -> token
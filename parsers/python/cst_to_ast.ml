@@ -758,8 +758,11 @@ and (-@) (l1) (l1', l2', l3') = (l1 @ l1'), l2', l3'
 and block_range sl =
   match sl with
   | [] ->
-     Location.mk_fresh_range ()
-     (* Exceptions.panic "block_range: empty block" *)
+    (* Empty modules get an empty range at the start of the file. Fresh
+       ranges would not be unique once the AST is cached or sent back by a
+       worker process. *)
+    let pos = Location.mk_pos !filename 1 0 in
+    Location.mk_orig_range pos pos
   | [s] -> s.srange
   | hd :: tl ->
     let last = List.rev tl |> List.hd in
@@ -25,22 +25,27 @@
 
 open Mopsa_utils
 
-let parse_file ?(counter=(List.length Builtins.all)) (filename:string) : Ast.program * int =
-  let f = open_in filename in
-  let buf = Lexing.from_channel f in
+let debug fmt = Debug.debug ~channel:"py_parser.main" fmt
+
+
+(** {2 Parsing} *)
+
+(** Parse a source file into an AST, before scoping *)
+let parse_ast (filename:string) : Ast.program =
+  (* The whole file is read at once, so the lexer never refills its buffer *)
+  let f = open_in_bin filename in
+  let src = really_input_string f (in_channel_length f) in
+  close_in f;
+  let buf = Lexing.from_string src in
   buf.lex_curr_p <- { buf.lex_curr_p with pos_fname = filename };
+  Lexer.reset ();
 
   try
     (* Parse the program source *)
     let cst = Parser.file_input Lexer.next_token buf in
-    close_in f;
-    Scoping.start_counter_at counter;
 
     (* Simplify the CST into an AST *)
-    Cst_to_ast.translate_program (Sys.getcwd () ^ "/" ^ filename) cst |>
-
-    (* Resolve scopes and generate unique IDs for variables *)
-    Scoping.translate_program
+    Cst_to_ast.translate_program (Sys.getcwd () ^ "/" ^ filename) cst
 
   with
   | Lexer.LexingError e ->
@@ -50,3 +55,128 @@ let parse_file ?(counter=(List.length Builtins.all)) (filename:string) : Ast.pro
   | Parser.Error ->
     let range = Location.from_lexing_range (Lexing.lexeme_start_p buf) (Lexing.lexeme_end_p buf) in
     Exceptions.syntax_error range "Parsing error"
+
+
+
+(** {2 Cache of parsed files} *)
+
+(* Files are cached before scoping: scoping allocates variable uids that
+   depend on the modules imported before by the analysis, while the AST
+   before scoping only depends on the source file. The cache is kept in
+   memory, and on disk in a private cache directory of the user, keyed by
+   a digest of the file contents and of the executable. *)
+
+(** Version number, changed when the AST changes to invalidate the cache. *)
+let version = "Mopsa.Py.AST/1"
+
+let enable_cache = ref true
+(** Use the cache on disk. *)
+
+let parsed : (string, Ast.program) Hashtbl.t = Hashtbl.create 16
+(** Files parsed by the analysis, by key. *)
+
+let cache_dir () = CacheDir.get "py-ast"
+
+(* The file name and the current directory are part of the key, since
+   they appear in the ranges of the AST. The fingerprint of the executable
+   invalidates the cache when the AST type changes. *)
+let cache_key filename =
+  Marshal.to_string (version, Lazy.force CacheDir.fingerprint, Sys.getcwd (), filename, Digest.file filename) [] |>
+  Digest.string |>
+  Digest.to_hex
+
+let read_cache key : Ast.program option =
+  match cache_dir () with
+  | None -> None
+  | Some dir ->
+    try
+      let ch = open_in_bin (Filename.concat dir key) in
+      let r =
+        try
+          let v : string = Marshal.from_channel ch in
+          if v = version then Some (Marshal.from_channel ch : Ast.program) else None
+        with End_of_file | Failure _ -> None
+      in
+      close_in ch;
+      r
+    with Sys_error _ -> None
+
+(* The cache file is written under a temporary name then renamed, so that
+   concurrent analyses never read a partial file *)
+let write_cache key (ast:Ast.program) =
+  match cache_dir () with
+  | None -> ()
+  | Some dir ->
+    try
+      let tmp, ch = Filename.open_temp_file ~mode:[Open_binary] ~temp_dir:dir key ".tmp" in
+      Marshal.to_channel ch version [];
+      Marshal.to_channel ch ast [];
+      close_out ch;
+      Sys.rename tmp (Filename.concat dir key)
+    with Sys_error msg -> debug "cannot write cache of %s: %s" key msg
+
+(** Parse a file, or find it in the cache *)
+let find_ast (filename:string) : Ast.program =
+  let key = cache_key filename in
+  match Hashtbl.find_opt parsed key with
+  | Some ast -> ast
+  | None ->
+    let ast =
+      match if !enable_cache then read_cache key else None with
+      | Some ast -> debug "%s found in cache" filename; ast
+      | None ->
+        let ast = parse_ast filename in
+        if !enable_cache then write_cache key ast;
+        ast
+    in
+    Hashtbl.add parsed key ast;
+    ast
+
+
+(** Parse a list of files in [jobs] worker processes, and store them in
+    the cache. Files that fail to parse are left out, and are parsed again
+    when imported, to report their errors. *)
+let prefetch ~(jobs:int) (files:string list) : unit =
+  let todo =
+    List.sort_uniq compare files |>
+    List.filter (fun f -> Sys.file_exists f && not (Hashtbl.mem parsed (cache_key f)))
+  in
+  let n = List.length todo in
+  if jobs > 1 && n > 1 then
+    (* One task per worker, to fork only [jobs] times *)
+    let chunks = Array.make (min jobs n) [] in
+    List.iteri (fun i f ->
+        let k = i mod Array.length chunks in
+        chunks.(k) <- f :: chunks.(k)
+      ) todo;
+    let outcomes =
+      WorkerPool.run ~jobs
+        (List.filter_map (fun f ->
+             try Some (cache_key f, find_ast f)
+             with Exceptions.SyntaxError _ -> None
+           ))
+        (Array.to_list chunks)
+    in
+    List.iter (function
+        | WorkerPool.Done l -> List.iter (fun (key,ast) -> Hashtbl.replace parsed key ast) l
+        | WorkerPool.Failed msg -> debug "parser worker failed: %s" msg
+        | WorkerPool.Timeout | WorkerPool.Memory_exceeded -> ()
+      ) outcomes
+  else
+    List.iter (fun f ->
+        try ignore (find_ast f)
+        with Exceptions.SyntaxError _ -> ()
+      ) todo
+
+
+
+(** {2 Entry point} *)
+
+(** Parse and scope a file. Variables get unique identifiers starting from
+    [counter]; the next free identifier is returned with the program. *)
+let parse_file ?(counter=(List.length Builtins.all)) (filename:string) : Ast.program * int =
+  let ast = find_ast filename in
+  Scoping.start_counter_at counter;
+
+  (* Resolve scopes and generate unique IDs for variables *)
+  Scoping.translate_program ast
@@ -41,8 +41,11 @@ let parse_from_string s =
     Exceptions.syntax_error range "%s" s
 
 let parse_file (filename:string) : prog =
-  let f = open_in filename in
-  let lex = from_channel f in
+  (* The whole file is read at once, so the lexer never refills its buffer *)
+  let f = open_in_bin filename in
+  let src = really_input_string f (in_channel_length f) in
+  close_in f;
+  let lex = from_string src in
   try
     lex.lex_curr_p <- { lex.lex_curr_p with pos_fname = filename; };
     U_parser.file U_lexer.token lex
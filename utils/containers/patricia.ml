@@ -0,0 +1,332 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(**
+  Patricia - Maps with non-negative integer keys.
+
+  Big-endian Patricia trees, as described in "Fast Mergeable Integer Maps"
+  by Chris Okasaki and Andrew Gill (ML Workshop 1998).
+
+  Contrary to balanced trees, the shape of a Patricia tree only depends on
+  its set of keys, and not on the order of insertions. Two maps sharing
+  most of their bindings thus share most of their subtrees, and binary
+  operations ([map2zo], [for_all2zo], etc.) skip physically equal subtrees
+  without any key comparison.
+
+  Keys must be non-negative. The functions that iterate on the bindings
+  visit them in increasing order of keys.
+ *)
+
+
+type key = int
+
+type 'a t =
+  | Empty
+  | Leaf of key * 'a
+  | Branch of int * int * 'a t * 'a t
+(** In [Branch (p,m,l,r)], [m] is a power of 2: the highest bit where the
+    keys of [l] and [r] differ. All the keys in [l] and [r] agree with [p]
+    on the bits above [m]. Keys in [l] have bit [m] unset, and keys in [r]
+    have bit [m] set. Neither [l] nor [r] is empty.
+ *)
+
+
+(** {2 Bit utilities} *)
+
+let zero_bit (k:key) (m:int) : bool =
+  k land m = 0
+
+let mask (k:key) (m:int) : int =
+  (k lor (m - 1)) land (lnot m)
+
+let match_prefix (k:key) (p:int) (m:int) : bool =
+  mask k m = p
+
+let highest_bit (x:int) : int =
+  (* propagate the highest bit to all the lower bits *)
+  let x = x lor (x lsr 1) in
+  let x = x lor (x lsr 2) in
+  let x = x lor (x lsr 4) in
+  let x = x lor (x lsr 8) in
+  let x = x lor (x lsr 16) in
+  let x = x lor (x lsr 32) in
+  x - (x lsr 1)
+
+let branching_bit (p0:int) (p1:int) : int =
+  highest_bit (p0 lxor p1)
+
+
+(** {2 Constructors} *)
+
+let empty : 'a t = Empty
+
+let is_empty (m:'a t) : bool =
+  m == Empty
+
+let singleton (k:key) (v:'a) : 'a t =
+  if k < 0 then invalid_arg "Patricia.singleton: negative key";
+  Leaf (k,v)
+
+let join (p0:int) (t0:'a t) (p1:int) (t1:'a t) : 'a t =
+  let m = branching_bit p0 p1 in
+  if zero_bit p0 m then Branch (mask p0 m, m, t0, t1)
+  else Branch (mask p0 m, m, t1, t0)
+(* join two trees with disagreeing prefixes *)
+
+let branch (p:int) (m:int) (l:'a t) (r:'a t) : 'a t =
+  match l, r with
+  | Empty, t | t, Empty -> t
+  | _ -> Branch (p, m, l, r)
+(* smart constructor, removes empty sub-trees *)
+
+let rebuild (t:'a t) (p:int) (m:int) (l:'a t) (r:'a t) : 'a t =
+  match t with
+  | Branch (_,_,l',r') when l == l' && r == r' -> t
+  | _ -> branch p m l r
+(* as branch, but returns [t] if the sub-trees did not change *)
+
+
+(** {2 Queries} *)
+
+let rec find_opt (k:key) (m:'a t) : 'a option =
+  match m with
+  | Empty -> None
+  | Leaf (k',v) -> if k = k' then Some v else None
+  | Branch (_,b,l,r) -> find_opt k (if zero_bit k b then l else r)
+
+let rec find (k:key) (m:'a t) : 'a =
+  match m with
+  | Empty -> raise Not_found
+  | Leaf (k',v) -> if k = k' then v else raise Not_found
+  | Branch (_,b,l,r) -> find k (if zero_bit k b then l else r)
+
+let rec mem (k:key) (m:'a t) : bool =
+  match m with
+  | Empty -> false
+  | Leaf (k',_) -> k = k'
+  | Branch (_,b,l,r) -> mem k (if zero_bit k b then l else r)
+
+let rec cardinal (m:'a t) : int =
+  match m with
+  | Empty -> 0
+  | Leaf _ -> 1
+  | Branch (_,_,l,r) -> cardinal l + cardinal r
+
+
+(** {2 Updates} *)
+
+let add (k:key) (v:'a) (m:'a t) : 'a t =
+  if k < 0 then invalid_arg "Patricia.add: negative key";
+  let rec aux t =
+    match t with
+    | Empty -> Leaf (k,v)
+    | Leaf (j,v') ->
+      if j = k then if v == v' then t else Leaf (k,v)
+      else join k (Leaf (k,v)) j t
+    | Branch (p,m,l,r) ->
+      if match_prefix k p m then
+        if zero_bit k m then rebuild t p m (aux l) r
+        else rebuild t p m l (aux r)
+      else join k (Leaf (k,v)) p t
+  in
+  aux m
+(** [add k v m] binds [k] to [v]. Returns [m] itself when [k] is already
+    bound to a value physically equal to [v]. *)
+
+let remove (k:key) (m:'a t) : 'a t =
+  let rec aux t =
+    match t with
+    | Empty -> Empty
+    | Leaf (j,_) -> if j = k then Empty else t
+    | Branch (p,m,l,r) ->
+      if match_prefix k p m then
+        if zero_bit k m then rebuild t p m (aux l) r
+        else rebuild t p m l (aux r)
+      else t
+  in
+  aux m
+
+
+(** {2 Iterators} *)
+
+let rec iter (f:key -> 'a -> unit) (m:'a t) : unit =
+  match m with
+  | Empty -> ()
+  | Leaf (k,v) -> f k v
+  | Branch (_,_,l,r) -> iter f l; iter f r
+
+let rec fold (f:key -> 'a -> 'b -> 'b) (m:'a t) (acc:'b) : 'b =
+  match m with
+  | Empty -> acc
+  | Leaf (k,v) -> f k v acc
+  | Branch (_,_,l,r) -> fold f r (fold f l acc)
+
+let rec for_all (f:key -> 'a -> bool) (m:'a t) : bool =
+  match m with
+  | Empty -> true
+  | Leaf (k,v) -> f k v
+  | Branch (_,_,l,r) -> for_all f l && for_all f r
+
+let rec exists (f:key -> 'a -> bool) (m:'a t) : bool =
+  match m with
+  | Empty -> false
+  | Leaf (k,v) -> f k v
+  | Branch (_,_,l,r) -> exists f l || exists f r
+
+let rec mapi (f:key -> 'a -> 'a) (m:'a t) : 'a t =
+  match m with
+  | Empty -> Empty
+  | Leaf (k,v) -> let v' = f k v in if v == v' then m else Leaf (k,v')
+  | Branch (p,b,l,r) -> rebuild m p b (mapi f l) (mapi f r)
+(** Sub-trees where [f] returns physically equal values are shared. *)
+
+let map (f:'a -> 'a) (m:'a t) : 'a t =
+  mapi (fun _ v -> f v) m
+
+let rec filter (f:key -> 'a -> bool) (m:'a t) : 'a t =
+  match m with
+  | Empty -> Empty
+  | Leaf (k,v) -> if f k v then m else Empty
+  | Branch (p,b,l,r) -> rebuild m p b (filter f l) (filter f r)
+
+let partition (f:key -> 'a -> bool) (m:'a t) : 'a t * 'a t =
+  filter f m, filter (fun k v -> not (f k v)) m
+
+let bindings (m:'a t) : (key * 'a) list =
+  fold (fun k v acc -> (k,v) :: acc) m [] |> List.rev
+
+let rec min_binding (m:'a t) : key * 'a =
+  match m with
+  | Empty -> raise Not_found
+  | Leaf (k,v) -> (k,v)
+  | Branch (_,_,l,_) -> min_binding l
+
+let rec max_binding (m:'a t) : key * 'a =
+  match m with
+  | Empty -> raise Not_found
+  | Leaf (k,v) -> (k,v)
+  | Branch (_,_,_,r) -> max_binding r
+
+
+(** {2 Binary operations} *)
+
+let rec map2zo
+    (f1:key -> 'a -> 'a) (f2:key -> 'a -> 'a) (f:key -> 'a -> 'a -> 'a)
+    (m1:'a t) (m2:'a t) : 'a t =
+  if m1 == m2 then m1 else
+  match m1, m2 with
+  | Empty, _ -> mapi f2 m2
+  | _, Empty -> mapi f1 m1
+  | Leaf (k,v), _ ->
+    if mem k m2 then mapi (fun k' v' -> if k = k' then f k v v' else f2 k' v') m2
+    else add k (f1 k v) (mapi f2 m2)
+  | _, Leaf (k,v) ->
+    if mem k m1 then mapi (fun k' v' -> if k = k' then f k v' v else f1 k' v') m1
+    else add k (f2 k v) (mapi f1 m1)
+  | Branch (p,m,l1,r1), Branch (q,n,l2,r2) ->
+    if m = n && p = q then
+      rebuild m1 p m (map2zo f1 f2 f l1 l2) (map2zo f1 f2 f r1 r2)
+    else if m > n && match_prefix q p m then
+      (* m2 is included in one of the sub-trees of m1 *)
+      if zero_bit q m then rebuild m1 p m (map2zo f1 f2 f l1 m2) (mapi f1 r1)
+      else rebuild m1 p m (mapi f1 l1) (map2zo f1 f2 f r1 m2)
+    else if m < n && match_prefix p q n then
+      (* m1 is included in one of the sub-trees of m2 *)
+      if zero_bit p n then branch q n (map2zo f1 f2 f m1 l2) (mapi f2 r2)
+      else branch q n (mapi f2 l2) (map2zo f1 f2 f m1 r2)
+    else
+      join p (mapi f1 m1) q (mapi f2 m2)
+(** [map2zo f1 f2 f m1 m2] is similar to {!MapExtSig.S.map2zo}: [f1] is
+    applied to keys only in [m1], [f2] to keys only in [m2], and [f] to
+    keys in both maps. [f] is not called on physically equal sub-trees,
+    and sub-trees left unchanged by [f1] and [f2] are shared with the
+    arguments.
+ *)
+
+let rec for_all2zo
+    (f1:key -> 'a -> bool) (f2:key -> 'a -> bool) (f:key -> 'a -> 'a -> bool)
+    (m1:'a t) (m2:'a t) : bool =
+  if m1 == m2 then true else
+  match m1, m2 with
+  | Empty, _ -> for_all f2 m2
+  | _, Empty -> for_all f1 m1
+  | Leaf (k,v), _ ->
+    for_all (fun k' v' -> if k = k' then f k v v' else f2 k' v') m2 &&
+    (mem k m2 || f1 k v)
+  | _, Leaf (k,v) ->
+    for_all (fun k' v' -> if k = k' then f k v' v else f1 k' v') m1 &&
+    (mem k m1 || f2 k v)
+  | Branch (p,m,l1,r1), Branch (q,n,l2,r2) ->
+    if m = n && p = q then
+      for_all2zo f1 f2 f l1 l2 && for_all2zo f1 f2 f r1 r2
+    else if m > n && match_prefix q p m then
+      if zero_bit q m then for_all2zo f1 f2 f l1 m2 && for_all f1 r1
+      else for_all f1 l1 && for_all2zo f1 f2 f r1 m2
+    else if m < n && match_prefix p q n then
+      if zero_bit p n then for_all2zo f1 f2 f m1 l2 && for_all f2 r2
+      else for_all f2 l2 && for_all2zo f1 f2 f m1 r2
+    else
+      for_all f1 m1 && for_all f2 m2
+(** [for_all2zo f1 f2 f m1 m2] checks that [f1] holds for keys only in
+    [m1], [f2] for keys only in [m2], and [f] for keys in both maps.
+    [f] is not called on physically equal sub-trees.
+    The order of the calls is unspecified.
+ *)
+
+let rec fold2zo
+    (f1:key -> 'a -> 'b -> 'b) (f2:key -> 'a -> 'b -> 'b) (f:key -> 'a -> 'a -> 'b -> 'b)
+    (m1:'a t) (m2:'a t) (acc:'b) : 'b =
+  if m1 == m2 then acc else
+  match m1, m2 with
+  | Empty, _ -> fold f2 m2 acc
+  | _, Empty -> fold f1 m1 acc
+  | Leaf (k,v), _ ->
+    let acc = fold (fun k' v' acc -> if k = k' then f k v v' acc else f2 k' v' acc) m2 acc in
+    if mem k m2 then acc else f1 k v acc
+  | _, Leaf (k,v) ->
+    let acc = fold (fun k' v' acc -> if k = k' then f k v' v acc else f1 k' v' acc) m1 acc in
+    if mem k m1 then acc else f2 k v acc
+  | Branch (p,m,l1,r1), Branch (q,n,l2,r2) ->
+    if m = n && p = q then
+      fold2zo f1 f2 f r1 r2 (fold2zo f1 f2 f l1 l2 acc)
+    else if m > n && match_prefix q p m then
+      if zero_bit q m then fold f1 r1 (fold2zo f1 f2 f l1 m2 acc)
+      else fold2zo f1 f2 f r1 m2 (fold f1 l1 acc)
+    else if m < n && match_prefix p q n then
+      if zero_bit p n then fold f2 r2 (fold2zo f1 f2 f m1 l2 acc)
+      else fold2zo f1 f2 f m1 r2 (fold f2 l2 acc)
+    else
+      fold f2 m2 (fold f1 m1 acc)
+(** [fold2zo f1 f2 f m1 m2 acc] folds [f1] over keys only in [m1], [f2]
+    over keys only in [m2], and [f] over keys in both maps.
+    [f] is not called on physically equal sub-trees.
+    The order of the calls is unspecified.
+ *)
+
+let rec equal (eq:'a -> 'a -> bool) (m1:'a t) (m2:'a t) : bool =
+  m1 == m2 ||
+  match m1, m2 with
+  | Empty, Empty -> true
+  | Leaf (k1,v1), Leaf (k2,v2) -> k1 = k2 && eq v1 v2
+  | Branch (p1,b1,l1,r1), Branch (p2,b2,l2,r2) ->
+    p1 = p2 && b1 = b2 && equal eq l1 l2 && equal eq r1 r2
+  | _ -> false
+(** Equality, thanks to the canonical shape of Patricia trees. *)
@@ -0,0 +1,79 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Private cache directories of the current user.
+
+    Caches are stored in [$XDG_CACHE_HOME/mopsa], or in [~/.cache/mopsa]
+    when XDG_CACHE_HOME is not set. Cached values are read with [Marshal],
+    which is not type-safe: a directory is used only when it belongs to the
+    current user and is not writable by others, and cache keys should
+    include [fingerprint] so that files written by another build of Mopsa
+    are never read.
+*)
+
+
+(** Root of the caches of Mopsa *)
+let root () : string option =
+  match Sys.getenv_opt "XDG_CACHE_HOME" with
+  | Some d when d <> "" && not (Filename.is_relative d) -> Some (Filename.concat d "mopsa")
+  | _ ->
+    match Sys.getenv_opt "HOME" with
+    | Some h when h <> "" -> Some (Filename.concat (Filename.concat h ".cache") "mopsa")
+    | _ -> None
+
+
+let mkdir d =
+  try Unix.mkdir d 0o700 with Unix.Unix_error (Unix.EEXIST, _, _) -> ()
+
+(* Check that [d] is a directory of the current user, not writable by
+   others *)
+let is_private d =
+  let st = Unix.lstat d in
+  st.Unix.st_kind = Unix.S_DIR &&
+  st.Unix.st_uid = Unix.getuid () &&
+  st.Unix.st_perm land 0o022 = 0
+
+
+(** [get name] returns the cache directory [name] of the current user,
+    creating it if needed. [None] is returned when no private directory is
+    available, in which case the cache should not be used. *)
+let get (name:string) : string option =
+  match root () with
+  | None -> None
+  | Some r ->
+    try
+      mkdir (Filename.dirname r);
+      mkdir r;
+      let d = Filename.concat r name in
+      mkdir d;
+      if is_private r && is_private d then Some d else None
+    with Unix.Unix_error _ -> None
+
+
+(** Fingerprint of the running executable. Marshalled values depend on the
+    types of the build that wrote them. When the executable can not be
+    read, the fingerprint is unique to the process, so that nothing is
+    reused from the cache. *)
+let fingerprint : string Lazy.t =
+  lazy (
+    try Digest.to_hex (Digest.file Sys.executable_name)
+    with Sys_error _ -> Printf.sprintf "%d-%f" (Unix.getpid ()) (Unix.gettimeofday ())
+  )
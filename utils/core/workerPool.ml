@@ -0,0 +1,197 @@
+(****************************************************************************)
+(*                                                                          *)
+(* This file is part of MOPSA, a Modular Open Platform for Static Analysis. *)
+(*                                                                          *)
+(* Copyright (C) 2017-2019 The MOPSA Project.                               *)
+(*                                                                          *)
+(* This program is free software: you can redistribute it and/or modify     *)
+(* it under the terms of the GNU Lesser General Public License as published *)
+(* by the Free Software Foundation, either version 3 of the License, or     *)
+(* (at your option) any later version.                                      *)
+(*                                                                          *)
+(* This program is distributed in the hope that it will be useful,          *)
+(* but WITHOUT ANY WARRANTY; without even the implied warranty of           *)
+(* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            *)
+(* GNU Lesser General Public License for more details.                      *)
+(*                                                                          *)
+(* You should have received a copy of the GNU Lesser General Public License *)
+(* along with this program.  If not, see <http://www.gnu.org/licenses/>.    *)
+(*                                                                          *)
+(****************************************************************************)
+
+(** Pool of forked worker processes.
+
+    [run ~jobs f tasks] applies [f] to every task in a child process forked
+    from the current one, with at most [jobs] children running at the same
+    time. Children inherit the whole state of the parent, so [f] can use any
+    value computed before the call.
+
+    Results are sent back to the parent with [Marshal]. They must not
+    contain closures, and should not contain values of extensible variant
+    types: unmarshalled extension constructors are not recognized by
+    pattern matching.
+*)
+
+
+(** Outcome of a task *)
+type 'b outcome =
+  | Done of 'b          (** Result of the task *)
+  | Failed of string    (** Uncaught exception, or abnormal termination *)
+  | Timeout             (** The task exceeded its time budget *)
+  | Memory_exceeded     (** The task exceeded its heap budget *)
+
+
+(** Running child process *)
+type worker = {
+  pid: int;
+  fd: Unix.file_descr;
+  index: int;
+  deadline: float option;
+}
+
+
+exception Heap_exceeded
+
+(** Set by the heap alarm of the child when its heap budget is exceeded *)
+let heap_exceeded = ref false
+
+(** [check_heap ()] can be called by long tasks at safe points to abandon
+    their computation as soon as their heap budget is exceeded.
+    @raise Heap_exceeded when the budget is exceeded *)
+let check_heap () =
+  if !heap_exceeded then raise Heap_exceeded
+
+
+(** Code executed in the child process. The outcome is written on [fd].
+    The child terminates with [Unix._exit], so that the [at_exit] handlers
+    of the parent are not executed twice. *)
+let child f x fd max_heap =
+  (* Check the heap size at the end of each major cycle. Alarms are
+     executed as finalisers, so they only record the overflow. *)
+  let () =
+    match max_heap with
+    | None -> ()
+    | Some limit ->
+      let _ = Gc.create_alarm (fun () ->
+          let words = (Gc.quick_stat ()).Gc.heap_words in
+          if words * (Sys.word_size / 8) > limit then heap_exceeded := true
+        )
+      in
+      ()
+  in
+  let r =
+    try Done (f x)
+    with
+    | Stack_overflow -> Failed "stack overflow"
+    | Out_of_memory | Heap_exceeded -> Memory_exceeded
+    | e -> Failed (Printexc.to_string e)
+  in
+  let r = if !heap_exceeded then Memory_exceeded else r in
+  (* Outputs of the task are flushed here, since [_exit] does not *)
+  Format.pp_print_flush Format.std_formatter ();
+  Format.pp_print_flush Format.err_formatter ();
+  flush_all ();
+  let oc = Unix.out_channel_of_descr fd in
+  Marshal.to_channel oc r [];
+  flush oc;
+  Unix._exit 0
+
+
+(** Wait for the termination of a child and read its outcome *)
+let collect w =
+  let ic = Unix.in_channel_of_descr w.fd in
+  let r =
+    try (Marshal.from_channel ic : 'b outcome)
+    with End_of_file | Failure _ -> Failed "worker terminated unexpectedly"
+  in
+  close_in ic;
+  let _, status = Unix.waitpid [] w.pid in
+  match r, status with
+  | Failed _, Unix.WSIGNALED s -> Failed (Printf.sprintf "worker killed by signal %d" s)
+  | Failed _, Unix.WEXITED n when n <> 0 -> Failed (Printf.sprintf "worker exited with code %d" n)
+  | _ -> r
+
+
+(** Kill a child that exceeded its deadline *)
+let kill w =
+  (try Unix.kill w.pid Sys.sigkill with Unix.Unix_error _ -> ());
+  let _ = Unix.waitpid [] w.pid in
+  Unix.close w.fd
+
+
+(** [run ~jobs ~timeout ~max_heap ~on_outcome f tasks] computes [f] on every
+    element of [tasks] in parallel. The outcomes are returned in the order of
+    [tasks], independently of the completion order. [on_outcome i o] is
+    called as soon as the outcome [o] of task number [i] is available.
+    [timeout] is the wall-clock budget of every task, in seconds, and
+    [max_heap] is the maximal size of the major heap of every child, in
+    bytes: a child exceeding it is abandoned at its next call to
+    [check_heap], or when [f] returns. *)
+let run ?(jobs=1) ?timeout ?max_heap ?(on_outcome=fun _ _ -> ()) (f:'a -> 'b) (tasks:'a list) : 'b outcome list =
+  let tasks = Array.of_list tasks in
+  let n = Array.length tasks in
+  let outcomes = Array.make n (Failed "not executed") in
+  let finish i o =
+    outcomes.(i) <- o;
+    on_outcome i o
+  in
+  let spawn i =
+    (* Flush buffers to avoid printing their content twice *)
+    Format.pp_print_flush Format.std_formatter ();
+    Format.pp_print_flush Format.err_formatter ();
+    flush_all ();
+    let rd, wr = Unix.pipe () in
+    match Unix.fork () with
+    | 0 ->
+      Unix.close rd;
+      child f tasks.(i) wr max_heap
+    | pid ->
+      Unix.close wr;
+      let deadline = match timeout with
+        | None -> None
+        | Some t -> Some (Unix.gettimeofday () +. t)
+      in
+      { pid; fd = rd; index = i; deadline }
+  in
+  let rec loop next running =
+    (* Fill the pool *)
+    if next < n && List.length running < max 1 jobs then
+      loop (next + 1) (spawn next :: running)
+    else if running = [] then ()
+    else
+      (* Wait for a result or for the nearest deadline *)
+      let now = Unix.gettimeofday () in
+      let wait =
+        List.fold_left (fun acc w ->
+            match w.deadline with
+            | None -> acc
+            | Some d -> Some (match acc with None -> d -. now | Some a -> min a (d -. now))
+          ) None running
+      in
+      let ready =
+        match wait with
+        | Some t when t <= 0. -> []
+        | _ ->
+          let fds = List.map (fun w -> w.fd) running in
+          let rec select () =
+            try
+              let r, _, _ = Unix.select fds [] [] (match wait with None -> -1. | Some t -> t) in
+              r
+            with Unix.Unix_error (Unix.EINTR, _, _) -> select ()
+          in
+          select ()
+      in
+      let now = Unix.gettimeofday () in
+      let running =
+        List.filter (fun w ->
+            if List.mem w.fd ready then (finish w.index (collect w); false)
+            else
+              match w.deadline with
+              | Some d when d <= now -> kill w; finish w.index Timeout; false
+              | _ -> true
+          ) running
+      in
+      loop next running
+  in
+  loop 0 [];
+  Array.to_list outcomes
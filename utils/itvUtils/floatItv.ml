@@ -423,6 +423,13 @@ external divpos_sgl_itv_zero:  t -> t -> t -> unit = "ml_divpos_sgl_itv_zero"
 external divpos_sgl_itv_outer: t -> t -> t -> unit = "ml_divpos_sgl_itv_outer"
 external divpos_sgl_itv_inner: t -> t -> t -> unit = "ml_divpos_sgl_itv_inner"
 
+(* outer double-precision operations using error-free transformations,
+   without changing the rounding mode *)
+external add_dbl_itv_eft:    t -> t -> t -> unit = "ml_add_dbl_itv_eft"
+external sub_dbl_itv_eft:    t -> t -> t -> unit = "ml_sub_dbl_itv_eft"
+external mul_dbl_itv_eft:    t -> t -> t -> unit = "ml_mul_dbl_itv_eft"
+external divpos_dbl_itv_eft: t -> t -> t -> unit = "ml_divpos_dbl_itv_eft"
+
                                                     
 (* internal utilities *)
 
@@ -522,6 +529,20 @@ module Double = struct
   let div_inner : t -> t -> t_with_bot = wrap_div_bot divpos_inner
   (** Division. Returns a single interval. *)
 
+  let add_eft    : t -> t -> t = wrap_op2 add_dbl_itv_eft
+  let sub_eft    : t -> t -> t = wrap_op2 sub_dbl_itv_eft
+  let mul_eft    : t -> t -> t = wrap_op2 mul_dbl_itv_eft
+  let divpos_eft : t -> t -> t = wrap_op2 divpos_dbl_itv_eft
+  let div_unmerged_eft : t -> t -> t list = wrap_div_unmerged divpos_eft
+  let div_eft    : t -> t -> t_with_bot = wrap_div divpos_eft
+  (** Outer operations using error-free transformations (TwoSum and FMA).
+      They do not change the rounding mode, which is kept to nearest.
+      Results contain the results of the [_outer] operations, and are
+      equal to them except when the sign of the rounding error of a product
+      or quotient can not be computed (magnitudes below 2{^-969}): the
+      bound is then rounded away by one ulp.
+   *)
+
   let square_near  (a:t) : t = let aa = abs a in mul_near  aa aa
   let square_up    (a:t) : t = let aa = abs a in mul_up    aa aa
   let square_down  (a:t) : t = let aa = abs a in mul_down  aa aa
@@ -1115,6 +1136,14 @@ type round =
 (** Rounding direction.
     This is ignored for real arithmetic.
  *)
+
+let use_eft = ref false
+(** Whether the double-precision outer operations (used for the [`ANY]
+    rounding direction and for real arithmetic) use error-free
+    transformations instead of switching the rounding mode of the FPU.
+    Results contain those of the FPU-based operations and may be one ulp
+    wider for products and quotients of tiny magnitude.
+ *)
   
 let add (prec:prec) (round:round) (x:t) (y:t) : t =
   match prec,round with
@@ -1127,6 +1156,7 @@ let add (prec:prec) (round:round) (x:t) (y:t) : t =
   | `DOUBLE, `UP    -> Double.add_up   x y
   | `DOUBLE, `DOWN  -> Double.add_down x y
   | `DOUBLE, `ZERO  -> Double.add_zero x y
+  | `DOUBLE, `ANY | `REAL, _ when !use_eft -> Double.add_eft x y
   | `DOUBLE, `ANY   -> Double.add_outer x y
   | `REAL, _        -> Double.add_outer x y
 (** Addition. *)
@@ -1142,6 +1172,7 @@ let sub (prec:prec) (round:round) (x:t) (y:t) : t =
   | `DOUBLE, `UP    -> Double.sub_up   x y
   | `DOUBLE, `DOWN  -> Double.sub_down x y
   | `DOUBLE, `ZERO  -> Double.sub_zero x y
+  | `DOUBLE, `ANY | `REAL, _ when !use_eft -> Double.sub_eft x y
   | `DOUBLE, `ANY   -> Double.sub_outer x y
   | `REAL, _        -> Double.sub_outer x y
 (** Subtraction. *)
@@ -1157,6 +1188,7 @@ let mul (prec:prec) (round:round) (x:t) (y:t) :t =
   | `DOUBLE, `UP    -> Double.mul_up   x y
   | `DOUBLE, `DOWN  -> Double.mul_down x y
   | `DOUBLE, `ZERO  -> Double.mul_zero x y
+  | `DOUBLE, `ANY | `REAL, _ when !use_eft -> Double.mul_eft x y
   | `DOUBLE, `ANY   -> Double.mul_outer x y
   | `REAL, _        -> Double.mul_outer x y
 (** Multiplication. *)
@@ -1172,6 +1204,7 @@ let div (prec:prec) (round:round) (x:t) (y:t) : t_with_bot =
   | `DOUBLE, `UP    -> Double.div_up   x y
   | `DOUBLE, `DOWN  -> Double.div_down x y
   | `DOUBLE, `ZERO  -> Double.div_zero x y
+  | `DOUBLE, `ANY | `REAL, _ when !use_eft -> Double.div_eft x y
   | `DOUBLE, `ANY   -> Double.div_outer x y
   | `REAL, _        -> Double.div_outer x y
 (** Division. *)
@@ -1187,6 +1220,7 @@ let div_unmerged (prec:prec) (round:round) (x:t) (y:t) : t list =
   | `DOUBLE, `UP    -> Double.div_unmerged_up   x y
   | `DOUBLE, `DOWN  -> Double.div_unmerged_down x y
   | `DOUBLE, `ZERO  -> Double.div_unmerged_zero x y
+  | `DOUBLE, `ANY | `REAL, _ when !use_eft -> Double.div_unmerged_eft x y
   | `DOUBLE, `ANY   -> Double.div_unmerged_outer x y
   | `REAL, _        -> Double.div_unmerged_outer x y
 (** Division. Returns a list of intervals to remain precise. *)
@@ -1510,3 +1544,109 @@ let bwd_to_z (prec:prec) (lo:Z.t) (up:Z.t) (r:t) : t_with_bot =
   | `SINGLE -> Single.bwd_to_z lo up r
 (** Backward conversion to integer. *)
              
+
+
+
+(** {2 Batch operations} *)
+
+
+(* binding to (internal) C functions, with outer rounding *)
+
+external add_dbl_itv_outer_array:    float array -> float array -> float array -> unit = "ml_add_dbl_itv_outer_array" [@@noalloc]
+external add_sgl_itv_outer_array:    float array -> float array -> float array -> unit = "ml_add_sgl_itv_outer_array" [@@noalloc]
+external sub_dbl_itv_outer_array:    float array -> float array -> float array -> unit = "ml_sub_dbl_itv_outer_array" [@@noalloc]
+external sub_sgl_itv_outer_array:    float array -> float array -> float array -> unit = "ml_sub_sgl_itv_outer_array" [@@noalloc]
+external mul_dbl_itv_outer_array:    float array -> float array -> float array -> unit = "ml_mul_dbl_itv_outer_array" [@@noalloc]
+external mul_sgl_itv_outer_array:    float array -> float array -> float array -> unit = "ml_mul_sgl_itv_outer_array" [@@noalloc]
+external divpos_dbl_itv_outer_array: float array -> float array -> float array -> unit = "ml_divpos_dbl_itv_outer_array" [@@noalloc]
+external divpos_sgl_itv_outer_array: float array -> float array -> float array -> unit = "ml_divpos_sgl_itv_outer_array" [@@noalloc]
+
+
+module Batch = struct
+
+  type itv = t
+
+  type t = float array
+  (** A batch of n non-empty intervals, stored in a flat float array
+      of size 2n: the i-th interval has lower bound at index 2i and
+      upper bound at index 2i+1.
+   *)
+
+  let create (n:int) : t = Array.make (2*n) 0.
+
+  let length (b:t) : int = Array.length b / 2
+
+  let get (b:t) (i:int) : itv = mk b.(2*i) b.(2*i+1)
+
+  let set (b:t) (i:int) (x:itv) : unit =
+    b.(2*i) <- x.lo;
+    b.(2*i+1) <- x.up
+
+  let init (n:int) (f:int -> itv) : t =
+    let b = create n in
+    for i = 0 to n-1 do set b i (f i) done;
+    b
+
+  let of_list (l:itv list) : t =
+    let a = Array.of_list l in
+    init (Array.length a) (Array.get a)
+
+  let to_list (b:t) : itv list =
+    List.init (length b) (get b)
+
+
+  let map2 (f:itv -> itv -> itv) (a:t) (b:t) : t =
+    init (length a) (fun i -> f (get a i) (get b i))
+  (** Point-wise application of a scalar operation. *)
+
+  let check_length name (a:t) (b:t) =
+    if Array.length a <> Array.length b then
+      invalid_arg (Printf.sprintf "FloatItv.Batch.%s: batches of different lengths" name)
+
+  let wrap name dbl sgl scalar (prec:prec) (round:round) (a:t) (b:t) : t =
+    check_length name a b;
+    match prec,round with
+    | `DOUBLE, `ANY | `REAL, _ -> let r = create (length a) in dbl a b r; r
+    | `SINGLE, `ANY -> let r = create (length a) in sgl a b r; r
+    | _ -> map2 (scalar prec round) a b
+  (* the rounding mode is set once per batch for outer rounding;
+     other rounding directions fall back to scalar operations *)
+
+  let add : prec -> round -> t -> t -> t =
+    wrap "add" add_dbl_itv_outer_array add_sgl_itv_outer_array add
+  (** Point-wise addition. *)
+
+  let sub : prec -> round -> t -> t -> t =
+    wrap "sub" sub_dbl_itv_outer_array sub_sgl_itv_outer_array sub
+  (** Point-wise subtraction. *)
+
+  let mul : prec -> round -> t -> t -> t =
+    wrap "mul" mul_dbl_itv_outer_array mul_sgl_itv_outer_array mul
+  (** Point-wise multiplication. *)
+
+  let divpos : prec -> round -> t -> t -> t =
+    let scalar prec round x y =
+      match prec,round with
+      | `SINGLE, `NEAR  -> Single.divpos_near x y
+      | `SINGLE, `UP    -> Single.divpos_up   x y
+      | `SINGLE, `DOWN  -> Single.divpos_down x y
+      | `SINGLE, `ZERO  -> Single.divpos_zero x y
+      | `SINGLE, `ANY   -> Single.divpos_outer x y
+      | `DOUBLE, `NEAR  -> Double.divpos_near x y
+      | `DOUBLE, `UP    -> Double.divpos_up   x y
+      | `DOUBLE, `DOWN  -> Double.divpos_down x y
+      | `DOUBLE, `ZERO  -> Double.divpos_zero x y
+      | `DOUBLE, `ANY   -> Double.divpos_outer x y
+      | `REAL, _        -> Double.divpos_outer x y
+    in
+    wrap "divpos" divpos_dbl_itv_outer_array divpos_sgl_itv_outer_array scalar
+  (** Point-wise division by divisors of constant sign
+      (each divisor interval must not contain both negative and positive
+      numbers).
+   *)
+
+end
+(** Arrays of intervals, with operations applied to all the intervals
+    at once. This amortizes the cost of calling C code and of setting
+    the rounding mode, and uses SIMD instructions when available.
+ *)
@@ -868,6 +868,310 @@ CAMLprim value ml_divpos_sgl_itv_inner(value a, value b, value r) {
 
 
 
+/* error-free transformations */
+/* -------------------------- */
+
+/*
+  Directed rounding without changing the rounding mode.
+
+  When the FPU rounds to nearest, the exact error of a sum (TwoSum) or
+  of a product (FMA) is a representable double, so that its sign tells
+  us on which side of the rounded result the exact result lies.
+  We then only need to move the rounded result by one ulp to get the
+  upward or downward rounded result.
+
+  This is only valid in round-to-nearest mode. We check the mode
+  (reading the control word is cheap, only writing it is costly), and
+  switch to nearest if needed. In practice, when all the interval
+  operations use these kernels, the mode stays to nearest and is never
+  written.
+  We only provide double-precision versions: single-precision results
+  use the rounding-mode based functions.
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+#define ENSURE_NEAR                                     \
+  do {                                                  \
+    unsigned mxcsr;                                     \
+    asm ("stmxcsr %0" : "=m" (mxcsr));                  \
+    if (mxcsr & 0x6000) ROUND_NEAR;                     \
+  } while (0)
+
+#else
+
+#define ENSURE_NEAR                                     \
+  do { if (fegetround() != FE_TONEAREST) ROUND_NEAR; } while (0)
+
+#endif
+
+/* below this magnitude, the FMA error term may underflow and lose its sign */
+static const double eft_tiny = 0x1p-969;
+
+/* the error sign is unknown: round away in both directions */
+#define EFT_UNKNOWN 2
+
+#define EFT_SIGN(e) (isnan((e)) ? EFT_UNKNOWN : ((e) > 0) - ((e) < 0))
+
+static inline double next_up(double a)   { return nextafter(a, dbl_inf); }
+static inline double next_down(double a) { return nextafter(a, dbl_minf); }
+
+/* sign of the rounding error of s = a + b, with s rounded to nearest */
+static inline int eft_sum_err(double a, double b, double s) {
+  double bb = s - a;
+  double e = (a - (s - bb)) + (b - bb);
+  return EFT_SIGN(e);
+}
+
+/* sign of the rounding error of p = a * b, with p rounded to nearest */
+static inline int eft_mul_err(double a, double b, double p) {
+  if (fabs(p) < eft_tiny) return EFT_UNKNOWN;
+  double e = fma(a, b, -p);
+  return EFT_SIGN(e);
+}
+
+/* sign of the rounding error of q = a / b, with q rounded to nearest */
+static inline int eft_div_err(double a, double b, double q) {
+  if (fabs(q) < eft_tiny || fabs(a) < eft_tiny) return EFT_UNKNOWN;
+  double r = fma(-q, b, a);
+  int e = EFT_SIGN(r);
+  return (e == EFT_UNKNOWN || b > 0) ? e : -e;
+}
+
+/* fix the rounded result r given the sign e of the error;
+   an infinite result computed from finite arguments is an overflow */
+static inline double eft_up(double r, int e, int finite_args) {
+  if (isnan(r)) return r;
+  if (isinf(r)) return (r < 0 && finite_args) ? -DBL_MAX : r;
+  return (e > 0) ? next_up(r) : r;
+}
+
+static inline double eft_down(double r, int e, int finite_args) {
+  if (isnan(r)) return r;
+  if (isinf(r)) return (r > 0 && finite_args) ? DBL_MAX : r;
+  return (e < 0 || e == EFT_UNKNOWN) ? next_down(r) : r;
+}
+
+#define FINITE2(a,b) (isfinite((a)) && isfinite((b)))
+
+static inline double add_dbl_eft_up(double a, double b) {
+  double s = a + b;
+  return eft_up(s, isfinite(s) ? eft_sum_err(a,b,s) : 0, FINITE2(a,b));
+}
+
+static inline double add_dbl_eft_down(double a, double b) {
+  double s = a + b;
+  return eft_down(s, isfinite(s) ? eft_sum_err(a,b,s) : 0, FINITE2(a,b));
+}
+
+static inline double mul_dbl_eft_up(double a, double b) {
+  if (a == 0 || b == 0) return 0;
+  double p = a * b;
+  return eft_up(p, isfinite(p) ? eft_mul_err(a,b,p) : 0, FINITE2(a,b));
+}
+
+static inline double mul_dbl_eft_down(double a, double b) {
+  if (a == 0 || b == 0) return 0;
+  double p = a * b;
+  return eft_down(p, isfinite(p) ? eft_mul_err(a,b,p) : 0, FINITE2(a,b));
+}
+
+static inline double div_dbl_eft_up(double a, double b) {
+  if (a == 0 || isinf(b)) return 0;
+  double q = a / b;
+  return eft_up(q, isfinite(q) && isfinite(b) ? eft_div_err(a,b,q) : 0, FINITE2(a,b) && b != 0);
+}
+
+static inline double div_dbl_eft_down(double a, double b) {
+  if (a == 0 || isinf(b)) return 0;
+  double q = a / b;
+  return eft_down(q, isfinite(q) && isfinite(b) ? eft_div_err(a,b,q) : 0, FINITE2(a,b) && b != 0);
+}
+
+
+/* interval versions, with outer rounding */
+
+CAMLprim value ml_add_dbl_itv_eft(value a, value b, value r) {
+  ENSURE_NEAR;
+  set_l(r, add_dbl_eft_down(get_l(a), get_l(b)));
+  set_u(r, add_dbl_eft_up(get_u(a), get_u(b)));
+  return Val_unit;
+}
+
+CAMLprim value ml_sub_dbl_itv_eft(value a, value b, value r) {
+  ENSURE_NEAR;
+  set_l(r, add_dbl_eft_down(get_l(a), -get_u(b)));
+  set_u(r, add_dbl_eft_up(get_u(a), -get_l(b)));
+  return Val_unit;
+}
+
+CAMLprim value ml_mul_dbl_itv_eft(value a, value b, value r) {
+  ENSURE_NEAR;
+  double l1 = get_l(a), l2 = get_l(b), h1 = get_u(a), h2 = get_u(b);
+  set_l(r, fmin(fmin(mul_dbl_eft_down(l1,l2), mul_dbl_eft_down(h1,h2)),
+                fmin(mul_dbl_eft_down(l1,h2), mul_dbl_eft_down(h1,l2))));
+  set_u(r, fmax(fmax(mul_dbl_eft_up(l1,l2), mul_dbl_eft_up(h1,h2)),
+                fmax(mul_dbl_eft_up(l1,h2), mul_dbl_eft_up(h1,l2))));
+  return Val_unit;
+}
+
+CAMLprim value ml_divpos_dbl_itv_eft(value a, value b, value r) {
+  ENSURE_NEAR;
+  double l1 = get_l(a), l2 = get_l(b), h1 = get_u(a), h2 = get_u(b);
+  set_l(r, fmin(fmin(div_dbl_eft_down(l1,l2), div_dbl_eft_down(h1,h2)),
+                fmin(div_dbl_eft_down(l1,h2), div_dbl_eft_down(h1,l2))));
+  set_u(r, fmax(fmax(div_dbl_eft_up(l1,l2), div_dbl_eft_up(h1,h2)),
+                fmax(div_dbl_eft_up(l1,h2), div_dbl_eft_up(h1,l2))));
+  return Val_unit;
+}
+
+
+
+/* batch interval arithmetics */
+/* -------------------------- */
+
+/*
+  Batches of intervals are stored in flat float arrays, the i-th
+  interval being at indices 2i (lower bound) and 2i+1 (upper bound).
+  The rounding mode is set once for the whole batch, and no allocation
+  is performed: the result array is passed as argument and must have
+  the same length as the arguments.
+
+  We only provide outer rounding (lower bound downwards and upper bound
+  upwards), which is the one used to model soundly real arithmetic
+  and float arithmetic with unknown rounding mode.
+ */
+
+#define get_bl(x,i)    Double_flat_field((x),2*(i))
+#define get_bu(x,i)    Double_flat_field((x),2*(i)+1)
+#define set_bl(x,i,v)  do { double vv = v; if (isnan(vv)) vv = dbl_minf; Store_double_flat_field((x),2*(i),vv); } while (0)
+#define set_bu(x,i,v)  do { double vv = v; if (isnan(vv)) vv = dbl_inf;  Store_double_flat_field((x),2*(i)+1,vv); } while (0)
+
+#define get_bsl(x,i)   ((float)get_bl(x,i))
+#define get_bsu(x,i)   ((float)get_bu(x,i))
+
+#define BATCH_LENGTH(a) (Wosize_val((a)) / Double_wosize / 2)
+
+
+#if defined(__SSE2__) && defined(__GNUC__) && defined(FLAT_FLOAT_ARRAY)
+
+/*
+  SIMD path for additions and subtractions in double precision.
+  We store the negated lower bound and the upper bound in a vector of
+  two doubles, so that both bounds are rounded upwards with a single
+  vector operation.
+ */
+
+typedef double v2d __attribute__ ((vector_size (16)));
+
+static inline v2d load_neg_lo(const double* p) {
+  v2d v;
+  __builtin_memcpy(&v, p, sizeof(v));
+  v[0] = -v[0];
+  return v;
+}
+
+static inline void store_neg_lo(double* p, v2d v) {
+  double l = -v[0], u = v[1];
+  p[0] = isnan(l) ? dbl_minf : l;
+  p[1] = isnan(u) ? dbl_inf : u;
+}
+
+CAMLprim value ml_add_dbl_itv_outer_array(value a, value b, value r) {
+  mlsize_t i, n = BATCH_LENGTH(r);
+  double *pa = (double*)a, *pb = (double*)b, *pr = (double*)r;
+  ROUND_UP;
+  for (i = 0; i < n; i++) {
+    store_neg_lo(pr + 2*i, load_neg_lo(pa + 2*i) + load_neg_lo(pb + 2*i));
+  }
+  return Val_unit;
+}
+
+CAMLprim value ml_sub_dbl_itv_outer_array(value a, value b, value r) {
+  mlsize_t i, n = BATCH_LENGTH(r);
+  double *pa = (double*)a, *pb = (double*)b, *pr = (double*)r;
+  ROUND_UP;
+  for (i = 0; i < n; i++) {
+    /* [-l1, u1] + [u2, -l2] = [-(l1 - u2), u1 - l2] */
+    v2d vb = { pb[2*i+1], -pb[2*i] };
+    store_neg_lo(pr + 2*i, load_neg_lo(pa + 2*i) + vb);
+  }
+  return Val_unit;
+}
+
+#else
+
+CAMLprim value ml_add_dbl_itv_outer_array(value a, value b, value r) {
+  mlsize_t i, n = BATCH_LENGTH(r);
+  ROUND_UP;
+  for (i = 0; i < n; i++) {
+    set_bl(r, i, -(- get_bl(a,i) - get_bl(b,i)));
+    set_bu(r, i, get_bu(a,i) + get_bu(b,i));
+  }
+  return Val_unit;
+}
+
+CAMLprim value ml_sub_dbl_itv_outer_array(value a, value b, value r) {
+  mlsize_t i, n = BATCH_LENGTH(r);
+  ROUND_UP;
+  for (i = 0; i < n; i++) {
+    set_bl(r, i, -(- get_bl(a,i) + get_bu(b,i)));
+    set_bu(r, i, get_bu(a,i) - get_bl(b,i));
+  }
+  return Val_unit;
+}
+
+#endif
+
+CAMLprim value ml_add_sgl_itv_outer_array(value a, value b, value r) {
+  mlsize_t i, n = BATCH_LENGTH(r);
+  ROUND_UP;
+  for (i = 0; i < n; i++) {
+    set_bl(r, i, -(- get_bsl(a,i) - get_bsl(b,i)));
+    set_bu(r, i, get_bsu(a,i) + get_bsu(b,i));
+  }
+  return Val_unit;
+}
+
+CAMLprim value ml_sub_sgl_itv_outer_array(value a, value b, value r) {
+  mlsize_t i, n = BATCH_LENGTH(r);
+  ROUND_UP;
+  for (i = 0; i < n; i++) {
+    set_bl(r, i, -(- get_bsl(a,i) + get_bsu(b,i)));
+    set_bu(r, i, get_bsu(a,i) - get_bsl(b,i));
+  }
+  return Val_unit;
+}
+
+/* multiplication and division by a constant-sign divisor:
+   same as the scalar outer versions, with OP = MUL or DIV */
+
+#define BATCH_OUTER_MUL_DIV(NAME,TYPE,GETL,GETU,OP)                     \
+  CAMLprim value ml_##NAME(value a, value b, value r) {                 \
+    mlsize_t i, n = BATCH_LENGTH(r);                                    \
+    ROUND_UP;                                                           \
+    for (i = 0; i < n; i++) {                                           \
+      TYPE l1 = -GETL(a,i), l2 = GETL(b,i), h1 = -GETU(a,i), h2 = GETU(b,i); \
+      {                                                                 \
+        TYPE ll = OP(l1,l2), lh = OP(l1,h2), hl = OP(h1,l2), hh = OP(h1,h2); \
+        set_bl(r, i, -fmax(fmax(ll,hh), fmax(lh,hl)));                  \
+      }                                                                 \
+      l1 = -l1; h1 = -h1;                                               \
+      {                                                                 \
+        TYPE ll = OP(l1,l2), lh = OP(l1,h2), hl = OP(h1,l2), hh = OP(h1,h2); \
+        set_bu(r, i, fmax(fmax(ll,hh), fmax(lh,hl)));                   \
+      }                                                                 \
+    }                                                                   \
+    return Val_unit;                                                    \
+  }
+
+BATCH_OUTER_MUL_DIV(mul_dbl_itv_outer_array,    double, get_bl,  get_bu,  MUL)
+BATCH_OUTER_MUL_DIV(mul_sgl_itv_outer_array,    float,  get_bsl, get_bsu, MUL)
+BATCH_OUTER_MUL_DIV(divpos_dbl_itv_outer_array, double, get_bl,  get_bu,  DIV)
+BATCH_OUTER_MUL_DIV(divpos_sgl_itv_outer_array, float,  get_bsl, get_bsu, DIV)
+
+
+
 /* conversion with string */
 /* ---------------------- */
 
@@ -20,10 +20,13 @@ module InvRelation = InvRelation
 module InvRelationSig = InvRelationSig
 module Equiv = Equiv
 module MapP = MapP
+module Patricia = Patricia
 module Relation = Relation
 module RelationSig = RelationSig
 module ValueSig = ValueSig
 module Timing = Timing
+module WorkerPool = WorkerPool
+module CacheDir = CacheDir
 module Top = Top
 module Bot_top = Bot_top
 module ItvUtils = ItvUtils
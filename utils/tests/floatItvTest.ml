@@ -455,6 +455,68 @@ let test_bwd_bin_double name test iop rop = test_bwd_bin intervals_double sample
 (* *********** *)
                                       
   
+(* test batch operators against scalar ones *)
+(* **************************************** *)
+
+
+let test_batch_gen intervals divisor name bop iop =
+  Printf.printf "checking %s\n%!" name;
+  let l = intervals nb_random_bounds in
+  let l' = List.filter divisor l in
+  let l1 = List.concat (List.map (fun i1 -> List.map (fun _ -> i1) l') l)
+  and l2 = List.concat (List.map (fun _ -> l') l) in
+  let r = I.Batch.to_list (bop (I.Batch.of_list l1) (I.Batch.of_list l2)) in
+  List.iter2
+    (fun (i1,i2) r ->
+      let rr = iop i1 i2 in
+      if not (I.equal r rr) then
+        Printf.printf
+          "ERROR %s: %a, %a -> %a (expected %a)\n%!"
+          name (I.print I.dfl_fmt) i1 (I.print I.dfl_fmt) i2
+          (I.print I.dfl_fmt) r (I.print I.dfl_fmt) rr
+    )
+    (List.combine l1 l2) r
+
+(* divisors of constant sign, as required by divpos *)
+let const_sign (i:I.t) = i.I.lo >= 0. || i.I.up <= 0.
+
+let test_batch = test_batch_gen intervals_double (fun _ -> true)
+let test_batch_single = test_batch_gen intervals_single (fun _ -> true)
+let test_batch_divpos = test_batch_gen intervals_double const_sign
+let test_batch_divpos_single = test_batch_gen intervals_single const_sign
+
+
+
+(* test error-free operators against outer ones *)
+(* ******************************************** *)
+
+(* The EFT result must contain the outer result. It is one ulp wider on a
+   side when the sign of the rounding error is unknown, i.e. for products
+   and quotients of tiny magnitude. *)
+let test_eft_gen divisor name outer eft =
+  Printf.printf "checking %s\n%!" name;
+  let l = intervals_double nb_random_bounds in
+  List.iter
+    (fun i1 ->
+      List.iter
+        (fun i2 ->
+          let o, e = outer i1 i2, eft i1 i2 in
+          let o' = I.mk (F.Double.pred o.I.lo) (F.Double.succ o.I.up) in
+          if not (I.included o e && I.included e o') then
+            Printf.printf
+              "ERROR %s: %a, %a -> %a (outer %a)\n%!"
+              name (I.print I.dfl_fmt) i1 (I.print I.dfl_fmt) i2
+              (I.print I.dfl_fmt) e (I.print I.dfl_fmt) o
+        )
+        (List.filter divisor l)
+    )
+    l
+
+let test_eft = test_eft_gen (fun _ -> true)
+let test_eft_divpos = test_eft_gen const_sign
+   
+
+
 let test () =
 
   (* unary *)
@@ -472,24 +534,38 @@ let test () =
   test_bin_double "add double down" test_bin_val I.Double.add_down F.Double.add_down;
   test_bin_double "add double zero" test_bin_val I.Double.add_zero F.Double.add_zero;
   inout_bin_double "add double inner/outer" I.Double.add_up I.Double.add_down I.Double.add_inner I.Double.add_outer;
+  test_eft "add double outer/eft" I.Double.add_outer I.Double.add_eft;
 
   test_bin_double "sub double near" test_bin_val I.Double.sub_near F.Double.sub_near;
   test_bin_double "sub double up"   test_bin_val I.Double.sub_up F.Double.sub_up;
   test_bin_double "sub double down" test_bin_val I.Double.sub_down F.Double.sub_down;
   test_bin_double "sub double zero" test_bin_val I.Double.sub_zero F.Double.sub_zero;
   inout_bin_double "sub double inner/outer" I.Double.sub_up I.Double.sub_down I.Double.sub_inner I.Double.sub_outer;
+  test_eft "sub double outer/eft" I.Double.sub_outer I.Double.sub_eft;
 
   test_bin_double "mul double near" test_bin_val I.Double.mul_near F.Double.mul_near;
   test_bin_double "mul double up"   test_bin_val I.Double.mul_up F.Double.mul_up;
   test_bin_double "mul double down" test_bin_val I.Double.mul_down F.Double.mul_down;
   test_bin_double "mul double zero" test_bin_val I.Double.mul_zero F.Double.mul_zero;
   inout_bin_double "mul double inner/outer" I.Double.mul_up I.Double.mul_down I.Double.mul_inner I.Double.mul_outer;
+  test_eft "mul double outer/eft" I.Double.mul_outer I.Double.mul_eft;
 
   test_bin_double "div double near" test_bin_bot_val I.Double.div_near F.Double.div_near;
   test_bin_double "div double up"   test_bin_bot_val I.Double.div_up F.Double.div_up;
   test_bin_double "div double down" test_bin_bot_val I.Double.div_down F.Double.div_down;
   test_bin_double "div double zero" test_bin_bot_val I.Double.div_zero F.Double.div_zero;
   inout_bin_bot_double "div double inner/outer" I.Double.div_up I.Double.div_down I.Double.div_inner I.Double.div_outer;
+  test_eft_divpos "divpos double outer/eft" I.Double.divpos_outer I.Double.divpos_eft;
+
+  test_batch "batch add double outer" (I.Batch.add `DOUBLE `ANY) I.Double.add_outer;
+  test_batch "batch sub double outer" (I.Batch.sub `DOUBLE `ANY) I.Double.sub_outer;
+  test_batch "batch mul double outer" (I.Batch.mul `DOUBLE `ANY) I.Double.mul_outer;
+  test_batch "batch add double near"  (I.Batch.add `DOUBLE `NEAR) I.Double.add_near;
+  test_batch_divpos "batch divpos double outer" (I.Batch.divpos `DOUBLE `ANY) I.Double.divpos_outer;
+  test_batch_single "batch add single outer" (I.Batch.add `SINGLE `ANY) I.Single.add_outer;
+  test_batch_single "batch sub single outer" (I.Batch.sub `SINGLE `ANY) I.Single.sub_outer;
+  test_batch_single "batch mul single outer" (I.Batch.mul `SINGLE `ANY) I.Single.mul_outer;
+  test_batch_divpos_single "batch divpos single outer" (I.Batch.divpos `SINGLE `ANY) I.Single.divpos_outer;
 
   test_bin_double "div unmerged double near" test_bin_unmerged_val I.Double.div_unmerged_near F.Double.div_near;
   test_bin_double "div unmerged double up"   test_bin_unmerged_val I.Double.div_unmerged_up F.Double.div_up;